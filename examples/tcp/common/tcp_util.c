@@ -93,7 +93,11 @@ void tcp_sleep_ms(unsigned ms)
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
-#include <time.h> // clock_gettime, nanosleep
+#include <sys/uio.h> // struct iovec for sendmsg
+#if defined(__linux__)
+#include <sys/sendfile.h> // sendfile
+#endif
+#include <time.h>    // clock_gettime, nanosleep
 #include <unistd.h>
 static void ensure_wsa(void)
 {
@@ -260,6 +264,91 @@ int tcp_send_all(int fd, const void *buf, size_t len)
     return 0;
 }
 
+int tcp_sendv_all(int fd, const tcp_iovec_t *iov, size_t count)
+{
+#if defined(_WIN32)
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (iov[i].len && tcp_send_all(fd, iov[i].base, iov[i].len) != 0)
+            return -1;
+    }
+    return 0;
+#else
+    struct iovec v[16];
+    if (count > sizeof(v) / sizeof(v[0]))
+        return -1;
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!iov[i].len)
+            continue;
+        v[n].iov_base = (void *)iov[i].base;
+        v[n].iov_len = iov[i].len;
+        n++;
+    }
+    size_t first = 0;
+    while (first < n)
+    {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = v + first;
+        msg.msg_iovlen = n - first;
+        ssize_t w = sendmsg(fd, &msg, 0);
+        if (w <= 0)
+            return -1;
+        // Advance past fully written segments; trim a partially written one
+        size_t done = (size_t)w;
+        while (first < n && done >= v[first].iov_len)
+        {
+            done -= v[first].iov_len;
+            first++;
+        }
+        if (first < n && done)
+        {
+            v[first].iov_base = (char *)v[first].iov_base + done;
+            v[first].iov_len -= done;
+        }
+    }
+    return 0;
+#endif
+}
+
+int tcp_sendfile_all(int fd, const void *head, size_t head_len, int file_fd, uint64_t offset, size_t len,
+                     const void *tail, size_t tail_len)
+{
+#if defined(__linux__)
+    // MSG_MORE keeps the header in the socket buffer so it leaves in the same segment as the payload
+    const char *p = (const char *)head;
+    while (head_len)
+    {
+        ssize_t n = send(fd, p, head_len, MSG_MORE);
+        if (n <= 0)
+            return -1;
+        p += n;
+        head_len -= (size_t)n;
+    }
+    off_t pos = (off_t)offset;
+    while (len)
+    {
+        ssize_t n = sendfile(fd, file_fd, &pos, len);
+        if (n <= 0)
+            return -1;
+        len -= (size_t)n;
+    }
+    return tail_len ? tcp_send_all(fd, tail, tail_len) : 0;
+#else
+    (void)fd;
+    (void)head;
+    (void)head_len;
+    (void)file_fd;
+    (void)offset;
+    (void)len;
+    (void)tail;
+    (void)tail_len;
+    return -1;
+#endif
+}
+
 int tcp_recv_all(int fd, void *buf, size_t len, unsigned timeout_ms)
 {
     char *p = (char *)buf;
@@ -331,6 +420,31 @@ int tcp_recv_up_to(int fd, void *buf, size_t len, size_t *out_got, unsigned time
     return 0;
 }
 
+int tcp_recv_some(int fd, void *buf, size_t len, size_t *out_got, unsigned timeout_ms)
+{
+    if (out_got)
+        *out_got = 0;
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    int r = select(fd + 1, &rfds, NULL, NULL, &tv);
+    if (r <= 0)
+        return 0; // timeout or interrupted wait; a dead socket surfaces on the next recv()
+#if defined(_WIN32)
+    int n = recv((SOCKET)fd, (char *)buf, (int)len, 0);
+#else
+    ssize_t n = recv(fd, buf, len, 0);
+#endif
+    if (n <= 0)
+        return -1;
+    if (out_got)
+        *out_got = (size_t)n;
+    return 0;
+}
+
 int tcp_recv_exact(int fd, void *buf, size_t len, unsigned timeout_ms)
 {
     if (len == 0)
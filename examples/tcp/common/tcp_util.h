@@ -18,6 +18,19 @@ extern "C"
 
     // Send exactly len bytes; returns 0 on success, -1 on error
     int tcp_send_all(int fd, const void *buf, size_t len);
+    // Send the concatenation of count segments (one gathered syscall where the platform allows);
+    // returns 0 on success, -1 on error
+    typedef struct
+    {
+        const void *base;
+        size_t len;
+    } tcp_iovec_t;
+    int tcp_sendv_all(int fd, const tcp_iovec_t *iov, size_t count);
+    // Send head, then len bytes of file_fd starting at offset (moved file->socket by the kernel, Linux
+    // sendfile), then tail. The file position is not used or changed. Returns 0 on success, -1 on error or
+    // where the platform has no such path.
+    int tcp_sendfile_all(int fd, const void *head, size_t head_len, int file_fd, uint64_t offset, size_t len,
+                         const void *tail, size_t tail_len);
     // Recv exactly len bytes, unless timeout_ms elapses; returns 0 on success, -1 on error
     int tcp_recv_all(int fd, void *buf, size_t len, unsigned timeout_ms);
 
@@ -26,6 +39,10 @@ extern "C"
     // to the number of bytes actually read (0..len).
     int tcp_recv_up_to(int fd, void *buf, size_t len, size_t *out_got, unsigned timeout_ms);
 
+    // Recv whatever is available (1..len bytes) with a single recv() once the socket is readable.
+    // Returns 0 on success (*out_got = 0 on timeout), -1 on error or orderly shutdown by the peer.
+    int tcp_recv_some(int fd, void *buf, size_t len, size_t *out_got, unsigned timeout_ms);
+
     // Recv exactly len bytes within timeout_ms without consuming partial data on timeout.
     // Uses a readiness check (FIONREAD/select) and only performs the actual read when enough
     // bytes are available to satisfy 'len'. Returns 0 on success, -1 on timeout or error, in which
@@ -117,6 +117,12 @@ static int tp_recv(void *ctx, void *buffer, size_t buffer_size, size_t *received
 	return 0;
 }
 
+static int tp_recv_some(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms)
+{
+	int fd = *(int *)ctx;
+	return tcp_recv_some(fd, buffer, buffer_size, received, timeout_ms) == 0 ? 0 : -1;
+}
+
 static int tp_is_connected(void *ctx)
 {
 	int fd = *(int *)ctx;
@@ -754,6 +760,7 @@ int main(int argc, char **argv)
 	memset(&cfg, 0, sizeof(cfg));
 	cfg.transport.send = tp_send;
 	cfg.transport.recv = tp_recv;
+	cfg.transport.recv_some = tp_recv_some;
 	// Provide is_connected to reduce spurious polling when connection breaks
 	cfg.transport.is_connected = tp_is_connected;
 	cfg.transport.flush = tp_flush;
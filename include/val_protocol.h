@@ -7,7 +7,7 @@
  * constrained embedded systems.
  * 
  * Features:
- * - Adaptive transmission with bounded window flow control (packet-count based)
+ * - Adaptive transmission with bounded window flow control (packet and byte caps)
  * - Simplified resume with tail-only CRC verification (NEVER/SKIP_EXISTING/TAIL)
  * - Embedded-friendly: zero dynamic allocations in steady state
  * - Transport agnostic: works over TCP, UART, USB, or any reliable byte stream
@@ -47,6 +47,10 @@ extern "C"
 #define VAL_MAX_PACKET_SIZE (2u * 1024u * 1024u) // 2MB
 #define VAL_MAX_FILENAME 127u
 #define VAL_MAX_PATH 127u
+// filesystem.map: offsets are multiples of VAL_MAP_ALIGN (64 KiB, a multiple of common page sizes and of the
+// Windows allocation granularity) and one mapping spans at most VAL_MAP_SPAN bytes
+#define VAL_MAP_ALIGN (64u * 1024u)
+#define VAL_MAP_SPAN (8u * 1024u * 1024u)
 // Emergency cancel (ASCII CAN)
 #define VAL_PKT_CANCEL 0x18u
 
@@ -187,10 +191,24 @@ extern "C"
 
 // Public feature bits
 // Negotiation covers only optional features; core functionality is implicit and not represented by bits.
-// Currently no optional features are defined; all core features (windowing, streaming, resume) are implicit.
+// A feature is active for a session when both peers advertise it and at least one side requests or
+// requires it (config.features); otherwise the session silently uses the baseline behavior.
 //
 #define VAL_FEAT_NONE 0u
-#define VAL_BUILTIN_FEATURES VAL_FEAT_NONE
+// CRC32C (Castagnoli) for frame trailers and resume/verify CRCs instead of IEEE CRC32.
+// HELLO frames always use IEEE CRC32. A configured crc32_provider is bypassed while CRC32C is active.
+#define VAL_FEAT_CRC32C (1u << 0)
+// Extended 12-byte frame header with a 32-bit content length, for packet sizes above 64 KiB.
+// Implicitly wanted when the negotiated packet size needs it; without it the packet size is capped
+// so content fits the 16-bit length field.
+#define VAL_FEAT_EXT_LEN (1u << 1)
+// Selective repeat: the receiver keeps out-of-order DATA (buffers.rx_reorder_buffer) and reports it as SACK
+// blocks in DATA_ACK; the sender retransmits only the holes instead of rewinding the whole window.
+#define VAL_FEAT_SACK (1u << 2)
+// Pipelined batches: the sender announces the next file (SEND_META + RESUME_REQ), or sends EOT after the last
+// one, right behind each DONE instead of after its DONE_ACK, saving a round trip per file.
+#define VAL_FEAT_PIPELINE (1u << 3)
+#define VAL_BUILTIN_FEATURES (VAL_FEAT_CRC32C | VAL_FEAT_EXT_LEN | VAL_FEAT_SACK | VAL_FEAT_PIPELINE)
 
     // Simplified resume config (tail-only)
     typedef struct
@@ -208,24 +226,75 @@ extern "C"
 
     // (Legacy ladder and streaming APIs fully removed in 0.7)
 
+    // Sender congestion controller (tx_flow.congestion_control). Local to the sender; not negotiated.
+    typedef enum
+    {
+        VAL_CC_AIMD = 0,  // +1 packet after recovery_success_threshold ACKs, halve after degrade_error_threshold errors
+        VAL_CC_CUBIC = 1, // slow start, then cubic growth in time since the last loss (RFC 9438); x0.7 per loss event
+        VAL_CC_BBR = 2,   // model-based: paces at the measured bottleneck rate, window = 2 x rate x min RTT; ignores random loss
+    } val_congestion_control_t;
+
+    // Sender pacing (tx_flow.pacing_mode): spreads DATA frames instead of sending a window back to back
+    typedef enum
+    {
+        VAL_PACING_OFF = 0,       // send each window fill at once (VAL_CC_BBR still paces at its own rate)
+        VAL_PACING_WINDOW = 1,    // 1.25 x cwnd per SRTT, once an RTT sample exists
+        VAL_PACING_LINK_RATE = 2, // fixed tx_flow.pacing_rate_bps (e.g., UART baud or a known bottleneck)
+    } val_pacing_mode_t;
+
+    // Receiver DATA_ACK policy (tx_flow.ack_policy) when a write-behind buffer is in use
+    typedef enum
+    {
+        VAL_ACK_ON_RECEIPT = 0, // acknowledge data once received and queued for writing
+        VAL_ACK_ON_WRITE = 1,   // acknowledge data once its write has completed (fwrite returned / write_wait done)
+    } val_ack_policy_t;
+
     // Bounded-window, single-knob flow configuration (MCU-first)
     typedef struct
     {
         // Max in-flight packets this endpoint desires and can track. Negotiated as min(local, peer_rx_cap).
-        // Set to 0 to use a conservative default (implementation-chosen).
-        uint16_t window_cap_packets;      // e.g., 1..65535 (recommend small caps on MCU)
+        // Set to 0 to use a conservative default (implementation-chosen), or the byte cap below when set.
+        uint32_t window_cap_packets;      // e.g., 1..4194303 (recommend small caps on MCU)
+        // Max in-flight bytes (whole frames at the negotiated packet size). Negotiated as min(local, peer)
+        // ignoring zeros; the window in packets is then also bounded by this / packet size, so the bytes in
+        // flight do not depend on the MTU. 0 = no byte cap.
+        uint32_t window_cap_bytes;
         // Optional initial cwnd. 0 means auto (implementation-chosen, typically 1..4).
         uint16_t initial_cwnd_packets;    // clamped to negotiated cap; 0 = auto
         // Optional +1 MTU retransmit cache for faster Go-Back-N recovery
         bool retransmit_cache_enabled;
-        uint8_t reserved0;
+        // Receive side: most in-order DATA packets covered by one DATA_ACK. Advertised in HELLO; the
+        // receiver adapts between 1 and min(local, peer) preference. 0 uses the default (8), 1 ACKs every packet.
+        uint8_t ack_stride_packets;
         // AIMD stepping thresholds
         uint16_t degrade_error_threshold;    // Errors before halving cwnd (0 uses default, e.g., 3)
         uint16_t recovery_success_threshold; // Successes before cwnd+=1 (0 uses default, e.g., 10)
+        // Receive side: longest a pending DATA_ACK is delayed waiting for the stride to fill.
+        // 0 = auto (SRTT/4, bounded by timeouts.min_timeout_ms/2).
+        uint16_t ack_delay_ms;
+        // Receive side: val_ack_policy_t. With VAL_ACK_ON_WRITE the cumulative DATA_ACK never passes data
+        // still queued in the write-behind buffer (received data beyond it is reported in SACK blocks).
+        uint8_t ack_policy;
+        // Sender window controller (val_congestion_control_t). AIMD thresholds above apply to VAL_CC_AIMD only.
+        // VAL_CC_BBR also paces DATA frames at its model rate (see pacing_mode).
+        uint8_t congestion_control;
+        // Sender pacing (val_pacing_mode_t). Frames are released through a token bucket on system.get_ticks_us
+        // when provided (sub-millisecond spacing), else on the millisecond clock with two-frame bursts.
+        uint8_t pacing_mode;
+        // Link rate in bits per second: the rate for VAL_PACING_LINK_RATE (required there) and, when non-zero,
+        // a ceiling on the other modes' rates. 0 = no ceiling.
+        uint32_t pacing_rate_bps;
         // Optional allocator for session/tracking structures
         val_memory_allocator_t allocator;
     } val_tx_flow_config_t;
 
+    // One segment of a gathered transport write (see transport.sendv)
+    typedef struct
+    {
+        const void *base;
+        size_t len;
+    } val_iovec_t;
+
     typedef struct
     {
         // Thread-safety: Unless otherwise stated, a single val_session_t must not be used concurrently from multiple threads.
@@ -245,6 +314,22 @@ extern "C"
             // Optional: flush any buffered data in the transport to the wire (best-effort). When absent (NULL),
             // this is treated as a no-op.
             void (*flush)(void *ctx);
+            // Optional: gathered send of 'iovcnt' segments forming one frame, in order (e.g. writev/sendmsg).
+            // Return total bytes sent or <0 on error. When present, DATA frames are sent as header(+offset),
+            // payload straight from the file read buffer, and trailer, without copying the payload.
+            // Other frames always use send().
+            int (*sendv)(void *ctx, const val_iovec_t *iov, size_t iovcnt);
+            // Optional: receive up to 'buffer_size' bytes, returning as soon as any are available (or at timeout with
+            // *received = 0). Return 0 on success, <0 on error. When present, the core reads ahead through it into a
+            // session buffer (packet_size bytes) and parses several frames per call; recv() is then not called.
+            int (*recv_some)(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms);
+            // Optional, used with filesystem.map: send one DATA frame as 'head' (head_len bytes), then 'len' bytes
+            // of the open source 'file' (as returned by filesystem.fopen) starting at 'offset', then 'tail', so the
+            // kernel moves the file bytes to the socket (sendfile/splice/TransmitFile) without a user-space copy.
+            // The trailer CRC is computed over the mapped pages. Must not move the file position. Return total
+            // bytes sent or <0 on error. Used for every DATA frame whose range is mapped; others use sendv/send().
+            int (*send_file)(void *ctx, const void *head, size_t head_len, void *file, uint64_t offset, size_t len,
+                             const void *tail, size_t tail_len);
             void *io_context;
         } transport;
 
@@ -258,6 +343,45 @@ extern "C"
             int (*fseek)(void *ctx, void *file, int64_t offset, int whence);
             int64_t (*ftell)(void *ctx, void *file);
             int (*fclose)(void *ctx, void *file);
+            // Optional positional I/O. pread/pwrite transfer up to 'len' bytes at 'offset' without using or moving
+            // the file position and return the count (short only at end of file or on error); fsize returns the size of the
+            // file at 'path' (<0 if it cannot be opened). With pread and fsize set, fseek/ftell are never called:
+            // sizing a file no longer opens it, and retransmissions and CRC regions read at their offset.
+            size_t (*pread)(void *ctx, void *file, void *buffer, size_t len, uint64_t offset);
+            size_t (*pwrite)(void *ctx, void *file, const void *buffer, size_t len, uint64_t offset);
+            int64_t (*fsize)(void *ctx, const char *path);
+            // Optional memory mapping; set both or neither. map returns a pointer to bytes [offset, offset + len) of
+            // 'file' (offset a multiple of VAL_MAP_ALIGN, len at most VAL_MAP_SPAN), or NULL if the range cannot be
+            // mapped; the read/write hooks are then used for that file. The sender frames DATA and the CRC code
+            // hashes straight from read-only mappings. The receiver maps the output file 'writable' and lands
+            // payloads in it: map must then first size the file to at least offset + len (reserving the space, so
+            // a full disk fails here rather than on a later page fault). unmap releases a mapping; 'valid' bytes
+            // from its start hold file data, and when valid < len (writable mappings only) the file is trimmed to
+            // offset + valid. Returns 0, or <0 if the data could not be written back (treated as a full disk).
+            void *(*map)(void *ctx, void *file, uint64_t offset, size_t len, bool writable);
+            int (*unmap)(void *ctx, void *file, void *addr, uint64_t offset, size_t len, size_t valid);
+            // Optional: reserve storage for the whole 'size'-byte output file right after the receiver opens it,
+            // without changing the file's size (resume and appends still go by size; e.g. fallocate with
+            // FALLOC_FL_KEEP_SIZE). Return 0 (also when the filesystem cannot reserve), or <0 when the space
+            // is not available: the receiver then sends ERROR before any data is written and fails with
+            // VAL_ERROR_DETAIL_DISK_FULL.
+            int (*preallocate)(void *ctx, void *file, uint64_t size);
+            // Optional asynchronous reads for the sender read-ahead (buffers.tx_readahead_buffer); set both or
+            // neither. read_submit starts reading 'len' bytes at 'offset' into 'buffer' and returns 0 without
+            // waiting (<0 = error; the chunk is then read with fread). Several reads may be outstanding and must
+            // not move the position fread/fseek use (pread-style, e.g. a worker thread, io_uring, DMA).
+            // read_wait blocks until the read into 'buffer' is done and stores the bytes read in *got; returns
+            // 0 or <0 on error. Every submitted read is waited for before the file is closed.
+            int (*read_submit)(void *ctx, void *file, uint64_t offset, void *buffer, size_t len);
+            int (*read_wait)(void *ctx, void *file, void *buffer, size_t *got);
+            // Optional asynchronous writes for the receiver write-behind (buffers.rx_writebehind_buffer); set both
+            // or neither. write_submit starts writing 'len' bytes from 'buffer' at 'offset' and returns 0 without
+            // waiting (<0 = error). Writes are submitted in file order, several may be outstanding, and fwrite is
+            // not used on the file meanwhile. write_wait reports the oldest outstanding write (the one from
+            // 'buffer'): 0 with the bytes written in *written once done, 1 while it is still running and 'block'
+            // is false, <0 on error. A short count is treated as a full disk.
+            int (*write_submit)(void *ctx, void *file, uint64_t offset, const void *buffer, size_t len);
+            int (*write_wait)(void *ctx, void *file, const void *buffer, size_t *written, bool block);
             void *fs_context;
         } filesystem;
 
@@ -274,6 +398,12 @@ extern "C"
             // internal fallback; supplying NULL will cause session creation to fail with
             // VAL_ERR_INVALID_ARG.
             void (*delay_ms)(uint32_t ms);
+            // Optional monotonic microsecond clock (wraps every ~71 minutes). Used only by sender pacing;
+            // NULL paces on get_ticks_ms.
+            uint32_t (*get_ticks_us)(void);
+            // Optional microsecond delay for sub-millisecond pacing gaps. NULL waits with delay_ms for whole
+            // milliseconds and polls get_ticks_us for the remainder.
+            void (*delay_us)(uint32_t us);
         } system;
 
         // Adaptive timeout bounds (ms). Required.
@@ -311,6 +441,28 @@ extern "C"
             void *send_buffer;  // At least packet_size bytes; used as staging for header+payload+crc
             void *recv_buffer;  // At least packet_size bytes; used to read header and payload
             size_t packet_size; // MTU (max frame size), not a strict per-packet size
+            // Optional receiver DATA staging (at least packet_size bytes; page-aligned suits O_DIRECT-style
+            // writers). DATA payloads are read straight into it and handed to fwrite from there. NULL = recv_buffer.
+            void *rx_data_buffer;
+            // Optional sender batch staging: when it holds at least two frames, the window fill frames up to
+            // current_window_packets DATA packets back to back here and sends them with one transport.send call.
+            void *tx_batch_buffer;
+            size_t tx_batch_size;
+            // Optional sender read-ahead: file data is read in up to 8 chunks (at least one payload each) ahead of
+            // the window fill and kept until acknowledged, so retransmissions do not go back to the file. With
+            // filesystem.read_submit/read_wait the reads overlap with sending; otherwise they are issued with
+            // fread in chunk-sized pieces. Size it above the window in bytes to keep a full window covered.
+            void *tx_readahead_buffer;
+            size_t tx_readahead_size;
+            // Optional receiver reorder store for VAL_FEAT_SACK: holds rx_reorder_size / packet_size out-of-order
+            // DATA payloads until the gap before them is filled. Without it SACK degrades to Go-Back-N behavior.
+            void *rx_reorder_buffer;
+            size_t rx_reorder_size;
+            // Optional receiver write-behind: in-order DATA is gathered into up to 8 chunks (at least one payload
+            // each) and each full chunk is written with one fwrite, or handed to filesystem.write_submit so the
+            // disk write overlaps with receiving. What a DATA_ACK covers is set by tx_flow.ack_policy.
+            void *rx_writebehind_buffer;
+            size_t rx_writebehind_size;
         } buffers;
 
         // Simple resume configuration
@@ -327,6 +479,10 @@ extern "C"
             void (*on_file_complete)(const char *filename, const char *sender_path, val_status_t result);
             // Enhanced progress callback (replaces the previous 2-argument form)
             void (*on_progress)(const val_progress_info_t *info);
+            // Sender: val_send_files sizes every file up front (fsize, or an open and a seek per file) so that
+            // on_progress can report total_bytes and eta_seconds. Set to skip that scan on large batches of small
+            // files; both then report 0 (unknown). There is no scan without on_progress.
+            bool progress_skip_prescan;
         } callbacks;
 
         // Simple metadata validation configuration (optional)
@@ -375,6 +531,31 @@ extern "C"
     void val_clean_filename(const char *input, char *output, size_t output_size);
     void val_clean_path(const char *input, char *output, size_t output_size);
     uint32_t val_crc32(const void *data, size_t length);
+    // CRC32C (Castagnoli, reflected 0x82F63B78); used on the wire when VAL_FEAT_CRC32C is negotiated.
+    uint32_t val_crc32c(const void *data, size_t length);
+    // CRC of the concatenation A||B from crc(A), crc(B) and the length of B, without the data.
+    // val_crc32_combine pairs with val_crc32(), val_crc32c_combine with val_crc32c().
+    uint32_t val_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+    uint32_t val_crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+
+    // CRC32 engine selection (process-wide). AUTO picks the fastest engine available on this host:
+    // the hardware engine when the CPU supports it, else the widest slicing engine compiled in
+    // (see VAL_CRC32_SLICE_TABLES / VAL_CRC32_ENABLE_HW). The selection also applies to CRC32C.
+    // All engines produce identical results.
+    typedef enum
+    {
+        VAL_CRC32_IMPL_AUTO = 0,
+        VAL_CRC32_IMPL_BYTEWISE = 1, // one byte per step, 1 KiB table
+        VAL_CRC32_IMPL_SLICE8 = 2,   // slicing-by-8, 8 KiB of tables
+        VAL_CRC32_IMPL_SLICE16 = 3,  // slicing-by-16, 16 KiB of tables
+        VAL_CRC32_IMPL_HW = 4,       // x86 PCLMULQDQ folding / AArch64 CRC32 instructions (if the CPU supports it)
+    } val_crc32_impl_t;
+    // Select the CRC32 engine. Returns VAL_ERR_INVALID_ARG if the engine is not compiled in or the
+    // CPU lacks the required instructions (HW).
+    // Not synchronized: select before starting transfers.
+    val_status_t val_crc32_set_impl(val_crc32_impl_t impl);
+    // Engine currently in use (never returns AUTO).
+    val_crc32_impl_t val_crc32_get_impl(void);
 
     // Adaptive TX helpers (bounded window)
     // Get the current congestion window (packets) used by the sender.
@@ -390,6 +571,9 @@ extern "C"
 
     // Query compiled-in features (what this build supports)
     uint32_t val_get_builtin_features(void);
+    // Optional features active for this session (valid after the handshake; 0 before).
+    // Returns VAL_OK and writes to out_features on success; VAL_ERR_INVALID_ARG on bad inputs.
+    val_status_t val_get_negotiated_features(val_session_t *session, uint32_t *out_features);
 
     // Retrieve last error info recorded by the session (code and optional detail mask)
     val_status_t val_get_last_error(val_session_t *session, val_status_t *code, uint32_t *detail_mask);
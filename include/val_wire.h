@@ -19,6 +19,11 @@ extern "C" {
 #define VAL_WIRE_VERIFY_RESP_SIZE 8u
 #define VAL_WIRE_ERROR_PAYLOAD_SIZE 8u
 #define VAL_WIRE_TRAILER_SIZE 4u
+// Extended frame header (VAL_FEAT_EXT_LEN): standard header + 32-bit content length
+#define VAL_WIRE_EXT_HEADER_SIZE 12u
+// Largest content a standard header can describe, and the largest packet built from it
+#define VAL_WIRE_STD_MAX_CONTENT 0xFFFFu
+#define VAL_WIRE_STD_MAX_PACKET (VAL_WIRE_HEADER_SIZE + VAL_WIRE_STD_MAX_CONTENT + VAL_WIRE_TRAILER_SIZE)
 
 // Verify request/response payload sizes (exclude header/trailer)
 #define VAL_WIRE_VERIFY_REQ_PAYLOAD_SIZE 16u  // offset(8) + crc(4) + length(4)
@@ -35,15 +40,23 @@ extern "C" {
 //  byte 1: flags (uint8_t)
 //  byte 2-3: content_len (uint16_t LE)
 //  byte 4-7: type_data (uint32_t LE)
+// Extended form (flags & VAL_FRAME_EXT_LEN, only once VAL_FEAT_EXT_LEN is negotiated):
+//  byte 2-3: 0xFFFF
+//  byte 8-11: content_len (uint32_t LE)
 // Trailer: 4-byte CRC32 over [header + content]
 
 // Convenience aliases for readability
 #define VAL_FRAME_HEADER_SIZE VAL_WIRE_HEADER_SIZE
 #define VAL_FRAME_TRAILER_SIZE VAL_WIRE_TRAILER_SIZE
 
+// Frame flag valid for every packet type: extended 12-byte header
+#define VAL_FRAME_EXT_LEN (1u << 7)
+
 // DATA packet flags
 #define VAL_DATA_OFFSET_PRESENT (1u << 0)
 #define VAL_DATA_FINAL_CHUNK    (1u << 1)
+#define VAL_DATA_ACK_NOW        (1u << 2) // sender waits for an ACK after this frame: do not delay it
+#define VAL_DATA_OFFSET_HINT    (1u << 3) // implied offset: type_data carries its low 32 bits
 
 // ACK packet flags
 #define VAL_ACK_FEEDBACK_PRESENT (1u << 0)
@@ -64,6 +77,9 @@ typedef struct
     // tx_max_window_packets: maximum in-flight packets this sender can support
     // rx_max_window_packets: maximum in-flight packets this receiver can accept
     // ack_stride_packets: receiver's preferred ACK cadence (0 = once per window)
+    // window_shift: both window fields are in units of (1 << window_shift) packets, for caps above 65535.
+    //   Older peers send 0 and ignore it, reading a smaller (still safe) window.
+    // rx_max_window_bytes: maximum in-flight bytes this endpoint accepts (0 = no byte cap)
     uint16_t tx_max_window_packets;
     uint16_t rx_max_window_packets;
     uint8_t ack_stride_packets;
@@ -71,10 +87,13 @@ typedef struct
     uint16_t supported_features16;
     uint16_t required_features16;
     uint16_t requested_features16;
-    uint32_t reserved2;
+    uint8_t window_shift;
+    uint8_t reserved3;
+    uint32_t rx_max_window_bytes;
 } val_handshake_t;
 
-// Flow control uses bounded-window parameters (tx_max_window_packets, rx_max_window_packets, ack_stride_packets)
+// Flow control uses bounded-window parameters (tx/rx_max_window_packets << window_shift, rx_max_window_bytes,
+// ack_stride_packets)
 
 typedef struct
 {
@@ -85,6 +104,10 @@ typedef struct
 // Universal frame header helpers
 void val_serialize_frame_header(uint8_t type, uint8_t flags, uint16_t content_len, uint32_t type_data, uint8_t *wiredata);
 void val_deserialize_frame_header(const uint8_t *wiredata, uint8_t *type, uint8_t *flags, uint16_t *content_len, uint32_t *type_data);
+// Extended header: writes VAL_WIRE_EXT_HEADER_SIZE bytes and sets VAL_FRAME_EXT_LEN in flags.
+void val_serialize_frame_header_ext(uint8_t type, uint8_t flags, uint32_t content_len, uint32_t type_data, uint8_t *wiredata);
+// 32-bit content length of an extended header (reads bytes 8-11).
+uint32_t val_deserialize_frame_ext_len(const uint8_t *wiredata);
 
 void val_serialize_handshake(const val_handshake_t *hs, uint8_t *wire_data);
 void val_deserialize_handshake(const uint8_t *wire_data, val_handshake_t *hs);
@@ -0,0 +1,494 @@
+#include "val_internal.h"
+#include <string.h>
+
+// Sender congestion control modules. Each module owns the sender window behind val_cc_ops_t; the rest of
+// the sender only reports ACK progress (val_internal_cc_on_ack), loss events
+// (val_internal_record_transmission_error) and RTT samples, and reads the window via val_internal_cc_cwnd.
+//
+// All arithmetic is integer: windows are fixed point (VAL_CC_FP_ONE per packet) and time comes from the
+// session's millisecond clock, so the modules stay usable on FPU-less MCUs.
+
+static uint32_t cc_now_ms(const val_session_t *s)
+{
+    return (s->config && s->config->system.get_ticks_ms) ? s->config->system.get_ticks_ms() : 0u;
+}
+
+static uint32_t cc_cap_fp(const val_session_t *s)
+{
+    uint32_t cap = s->negotiated_window_packets ? s->negotiated_window_packets : 1u;
+    return cap << VAL_CC_FP_SHIFT;
+}
+
+// ---------------------------------------------------------------------------------------------------
+// AIMD (VAL_CC_AIMD): the original controller. +1 packet after recovery_success_threshold successes in a
+// row, halve after degrade_error_threshold errors in a row. The window lives in current_window_packets.
+// ---------------------------------------------------------------------------------------------------
+
+static void aimd_init(val_session_t *s)
+{
+    s->consecutive_errors = 0;
+    s->consecutive_successes = 0;
+}
+
+static void aimd_on_loss(val_session_t *s)
+{
+    s->consecutive_errors++;
+    s->consecutive_successes = 0; // reset success counter
+
+    // AIMD halve on sustained errors
+    uint16_t threshold = s->cfg.tx_flow.degrade_error_threshold ? s->cfg.tx_flow.degrade_error_threshold : 0;
+    if (threshold == 0)
+        threshold = 3; // default threshold
+
+    if (s->consecutive_errors >= threshold)
+    {
+        uint32_t cur = s->current_window_packets ? s->current_window_packets : 1u;
+        uint32_t new_w = cur / 2u;
+        if (new_w < 1u) new_w = 1u;
+        if (new_w != cur)
+        {
+            VAL_LOG_INFOF(s, "adaptive(win): decrease %u -> %u after %u errors", (unsigned)cur, (unsigned)new_w,
+                          (unsigned)s->consecutive_errors);
+            s->current_window_packets = new_w;
+            s->consecutive_errors = 0; // reset after adjustment
+            s->packets_since_mode_change = 0;
+        }
+    }
+}
+
+static void aimd_on_ack(val_session_t *s, uint32_t acked_packets)
+{
+    (void)acked_packets; // AIMD counts ACK events, not packets
+    s->consecutive_successes++;
+    s->consecutive_errors = 0; // reset error counter
+
+    // AIMD additive increase on sustained successes
+    uint16_t threshold = s->cfg.tx_flow.recovery_success_threshold ? s->cfg.tx_flow.recovery_success_threshold : 0;
+    if (threshold == 0)
+        threshold = 10; // default threshold
+
+    if (s->consecutive_successes >= threshold)
+    {
+        uint32_t cur = s->current_window_packets ? s->current_window_packets : 1u;
+        uint32_t cap = s->negotiated_window_packets ? s->negotiated_window_packets : cur;
+        if (cur < cap)
+        {
+            uint32_t new_w = cur + 1u;
+            if (new_w > cap) new_w = cap;
+            if (new_w != cur)
+            {
+                VAL_LOG_INFOF(s, "adaptive(win): increase %u -> %u after %u successes", (unsigned)cur, (unsigned)new_w,
+                              (unsigned)s->consecutive_successes);
+                s->current_window_packets = new_w;
+                s->consecutive_successes = 1; // keep momentum
+                s->packets_since_mode_change = 0;
+            }
+        }
+    }
+}
+
+static uint32_t aimd_cwnd(const val_session_t *s)
+{
+    return s->current_window_packets;
+}
+
+static const val_cc_ops_t val_cc_aimd = {"aimd", aimd_init, aimd_on_ack, aimd_on_loss, NULL, aimd_cwnd, NULL};
+
+// ---------------------------------------------------------------------------------------------------
+// CUBIC (VAL_CC_CUBIC, RFC 9438): slow start up to ssthresh, then W(t) = C*(t-K)^3 + W_max with t the
+// time since the last reduction, so the window returns to the pre-loss level within K and probes beyond
+// it quickly on long fat links. Loss events scale the window by beta = 0.7, at most once per SRTT.
+// ---------------------------------------------------------------------------------------------------
+
+#define CUBIC_BETA_NUM 7u
+#define CUBIC_BETA_DEN 10u
+// C = 0.4 packets/s^3; with t in ms, C*t^3 in fixed point is t^3 * (4 * VAL_CC_FP_ONE) / 1e10
+#define CUBIC_C_NUM (4ull * VAL_CC_FP_ONE)
+#define CUBIC_C_DEN 10000000000ull
+// |t - K| beyond this is clamped so (t-K)^3 * CUBIC_C_NUM stays inside 64 bits; the cap binds long before
+#define CUBIC_MAX_DT_MS 100000u
+
+static uint32_t cubic_cbrt_u64(uint64_t v)
+{
+    uint64_t r = 0;
+    for (int bit = 21; bit >= 0; --bit)
+    {
+        uint64_t c = r | (1ull << bit);
+        if (c * c * c <= v)
+            r = c;
+    }
+    return (uint32_t)r;
+}
+
+static void cubic_init(val_session_t *s)
+{
+    uint32_t cw0 = s->current_window_packets ? s->current_window_packets : 1u;
+    memset(&s->cc, 0, sizeof(s->cc));
+    val_cc_cubic_state_t *c = &s->cc.u.cubic;
+    s->cc.cwnd_fp = cw0 << VAL_CC_FP_SHIFT;
+    // No loss seen yet: slow start all the way to the negotiated cap
+    c->ssthresh = s->negotiated_window_packets ? s->negotiated_window_packets : 1u;
+    c->w_est_fp = s->cc.cwnd_fp;
+}
+
+static void cubic_on_ack(val_session_t *s, uint32_t acked_packets)
+{
+    val_cc_cubic_state_t *c = &s->cc.u.cubic;
+    uint32_t cap_fp = cc_cap_fp(s);
+    uint32_t cwnd_fp = s->cc.cwnd_fp ? s->cc.cwnd_fp : VAL_CC_FP_ONE;
+    uint32_t n = acked_packets ? acked_packets : 1u;
+    if (n > (cap_fp >> VAL_CC_FP_SHIFT))
+        n = cap_fp >> VAL_CC_FP_SHIFT;
+    if (cwnd_fp >= cap_fp)
+    {
+        s->cc.cwnd_fp = cap_fp;
+        return;
+    }
+
+    if ((cwnd_fp >> VAL_CC_FP_SHIFT) < c->ssthresh)
+    {
+        // Slow start: one packet per packet acknowledged
+        uint64_t w = (uint64_t)cwnd_fp + ((uint64_t)n << VAL_CC_FP_SHIFT);
+        s->cc.cwnd_fp = (w > cap_fp) ? cap_fp : (uint32_t)w;
+        return;
+    }
+
+    uint32_t now = cc_now_ms(s);
+    if (!c->epoch_valid)
+    {
+        c->epoch_valid = 1;
+        c->epoch_start_ms = now;
+        c->w_est_fp = cwnd_fp;
+        if (cwnd_fp < c->w_max_fp)
+        {
+            uint64_t deficit = (uint64_t)(c->w_max_fp - cwnd_fp);
+            c->k_ms = cubic_cbrt_u64(deficit * CUBIC_C_DEN / CUBIC_C_NUM);
+            c->origin_fp = c->w_max_fp;
+        }
+        else
+        {
+            c->k_ms = 0;
+            c->origin_fp = cwnd_fp;
+        }
+    }
+
+    // Target one RTT ahead: W(t + SRTT)
+    int64_t dt = (int64_t)(uint32_t)(now - c->epoch_start_ms) + (int64_t)s->timing.srtt_ms - (int64_t)c->k_ms;
+    uint64_t mag = (uint64_t)(dt < 0 ? -dt : dt);
+    if (mag > CUBIC_MAX_DT_MS)
+        mag = CUBIC_MAX_DT_MS;
+    uint64_t offs = mag * mag * mag * CUBIC_C_NUM / CUBIC_C_DEN;
+    uint64_t target = (dt < 0) ? (offs >= c->origin_fp ? 0u : c->origin_fp - offs) : (uint64_t)c->origin_fp + offs;
+    // Never more than 1.5x the current window per RTT
+    if (target > (uint64_t)cwnd_fp + (cwnd_fp >> 1))
+        target = (uint64_t)cwnd_fp + (cwnd_fp >> 1);
+
+    uint64_t inc;
+    if (target > cwnd_fp)
+        inc = (target - cwnd_fp) * n * VAL_CC_FP_ONE / cwnd_fp;
+    else
+        inc = (uint64_t)n * VAL_CC_FP_ONE * VAL_CC_FP_ONE / (100u * (uint64_t)cwnd_fp); // ~1% of a packet per RTT
+    uint64_t w = (uint64_t)cwnd_fp + inc;
+
+    // Reno-friendly region: grow at least as fast as AIMD with alpha = 3(1-beta)/(1+beta) = 9/17
+    uint64_t est = (uint64_t)c->w_est_fp + (uint64_t)n * 9u * VAL_CC_FP_ONE * VAL_CC_FP_ONE / (17u * (uint64_t)cwnd_fp);
+    c->w_est_fp = (est > cap_fp) ? cap_fp : (uint32_t)est;
+    if (est > w)
+        w = est;
+    s->cc.cwnd_fp = (w > cap_fp) ? cap_fp : (uint32_t)w;
+}
+
+static void cubic_on_loss(val_session_t *s)
+{
+    val_cc_cubic_state_t *c = &s->cc.u.cubic;
+    uint32_t now = cc_now_ms(s);
+    // Losses within one SRTT of the last reduction belong to the same congestion event
+    uint32_t rtt = s->timing.srtt_ms ? s->timing.srtt_ms : 1u;
+    if (c->reduced && (uint32_t)(now - c->last_reduction_ms) < rtt)
+        return;
+
+    uint32_t cwnd_fp = s->cc.cwnd_fp ? s->cc.cwnd_fp : VAL_CC_FP_ONE;
+    // Fast convergence: a flow losing before regaining its previous plateau yields some of it
+    if (cwnd_fp < c->w_max_fp)
+        c->w_max_fp = (uint32_t)((uint64_t)cwnd_fp * (CUBIC_BETA_DEN + CUBIC_BETA_NUM) / (2u * CUBIC_BETA_DEN));
+    else
+        c->w_max_fp = cwnd_fp;
+    uint32_t new_fp = (uint32_t)((uint64_t)cwnd_fp * CUBIC_BETA_NUM / CUBIC_BETA_DEN);
+    if (new_fp < VAL_CC_FP_ONE)
+        new_fp = VAL_CC_FP_ONE;
+    s->cc.cwnd_fp = new_fp;
+    c->ssthresh = new_fp >> VAL_CC_FP_SHIFT;
+    if (c->ssthresh < 2u)
+        c->ssthresh = 2u;
+    c->epoch_valid = 0;
+    c->reduced = 1;
+    c->last_reduction_ms = now;
+    VAL_LOG_INFOF(s, "cc(cubic): loss, window %u -> %u (w_max %u)", (unsigned)(cwnd_fp >> VAL_CC_FP_SHIFT),
+                  (unsigned)(new_fp >> VAL_CC_FP_SHIFT), (unsigned)(c->w_max_fp >> VAL_CC_FP_SHIFT));
+}
+
+static uint32_t cubic_cwnd(const val_session_t *s)
+{
+    return s->cc.cwnd_fp >> VAL_CC_FP_SHIFT;
+}
+
+static const val_cc_ops_t val_cc_cubic = {"cubic", cubic_init, cubic_on_ack, cubic_on_loss, NULL, cubic_cwnd, NULL};
+
+// ---------------------------------------------------------------------------------------------------
+// BBR (VAL_CC_BBR, after BBRv1): model-based rather than loss-based. Each round trip (one window of
+// deliveries) yields a delivery-rate sample; the max over the last VAL_BBR_BW_ROUNDS rounds estimates the
+// bottleneck bandwidth and the smallest RTT sample the propagation delay. The window is a gain times
+// their product and DATA is paced at a gain times the bandwidth, so random (non-congestive) loss does not
+// shrink the window. STARTUP doubles per round until bandwidth stops growing, DRAIN empties the queue
+// STARTUP built, PROBE_BW cycles the pacing gain to find more bandwidth, and PROBE_RTT briefly shrinks
+// the window when the min RTT estimate has not been refreshed for ten seconds.
+// ---------------------------------------------------------------------------------------------------
+
+#define VAL_BBR_STARTUP 0u
+#define VAL_BBR_DRAIN 1u
+#define VAL_BBR_PROBE_BW 2u
+#define VAL_BBR_PROBE_RTT 3u
+
+// Gains in percent: 2/ln2 for STARTUP, its inverse for DRAIN, and the PROBE_BW cycle
+#define BBR_HIGH_GAIN 289u
+#define BBR_DRAIN_GAIN 35u
+#define BBR_CWND_GAIN 200u
+#define BBR_MIN_CWND 4u
+#define BBR_MIN_RTT_WINDOW_MS 10000u
+#define BBR_PROBE_RTT_MS 200u
+static const uint8_t bbr_cycle_gain[8] = {125u, 75u, 100u, 100u, 100u, 100u, 100u, 100u};
+
+static uint32_t bbr_max_bw(const val_cc_bbr_state_t *b)
+{
+    uint32_t bw = 0;
+    for (uint32_t i = 0; i < VAL_BBR_BW_ROUNDS; ++i)
+        if (b->bw_fp[i] > bw)
+            bw = b->bw_fp[i];
+    return bw;
+}
+
+static uint32_t bbr_pacing_gain(const val_cc_bbr_state_t *b)
+{
+    switch (b->mode)
+    {
+    case VAL_BBR_STARTUP:
+        return BBR_HIGH_GAIN;
+    case VAL_BBR_DRAIN:
+        return BBR_DRAIN_GAIN;
+    case VAL_BBR_PROBE_BW:
+        return bbr_cycle_gain[b->cycle_index & 7u];
+    default:
+        return 100u;
+    }
+}
+
+static void bbr_init(val_session_t *s)
+{
+    uint32_t cw0 = s->current_window_packets ? s->current_window_packets : 1u;
+    memset(&s->cc, 0, sizeof(s->cc));
+    val_cc_bbr_state_t *b = &s->cc.u.bbr;
+    s->cc.cwnd_fp = cw0 << VAL_CC_FP_SHIFT;
+    b->mode = VAL_BBR_STARTUP;
+    b->round_start_ms = cc_now_ms(s);
+    b->round_end_delivered = cw0;
+}
+
+// Round trip boundary: take a delivery-rate sample and advance the state machine
+static void bbr_on_round(val_session_t *s, val_cc_bbr_state_t *b, uint32_t now)
+{
+    uint32_t interval = now - b->round_start_ms;
+    if (interval == 0)
+        interval = 1; // sub-millisecond round on a fast link: the ms clock bounds the estimate
+    uint64_t sample = (uint64_t)(b->delivered - b->round_start_delivered) * 1000u * VAL_CC_FP_ONE / interval;
+    b->bw_fp[b->rounds % VAL_BBR_BW_ROUNDS] = (sample > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)sample;
+    b->rounds++;
+    b->round_start_ms = now;
+    b->round_start_delivered = b->delivered;
+    uint32_t cwnd = s->cc.cwnd_fp >> VAL_CC_FP_SHIFT;
+    b->round_end_delivered = b->delivered + (cwnd ? cwnd : 1u);
+
+    uint32_t bw = bbr_max_bw(b);
+    if (!b->filled_pipe)
+    {
+        // Pipe is full once three rounds in a row fail to grow bandwidth by 25%
+        if ((uint64_t)bw * 4u >= (uint64_t)b->full_bw_fp * 5u && bw > b->full_bw_fp)
+        {
+            b->full_bw_fp = bw;
+            b->full_bw_rounds = 0;
+        }
+        else if (++b->full_bw_rounds >= 3u)
+        {
+            b->filled_pipe = 1;
+        }
+    }
+    if (b->mode == VAL_BBR_STARTUP && b->filled_pipe)
+    {
+        b->mode = VAL_BBR_DRAIN;
+        VAL_LOG_INFOF(s, "cc(bbr): startup done, bw %u pkt/s, min_rtt %u ms", (unsigned)(bw >> VAL_CC_FP_SHIFT),
+                      (unsigned)b->min_rtt_ms);
+    }
+    else if (b->mode == VAL_BBR_DRAIN)
+    {
+        b->mode = VAL_BBR_PROBE_BW;
+        b->cycle_index = 2u; // start cruising; the probe phase comes round within the cycle
+    }
+    else if (b->mode == VAL_BBR_PROBE_BW)
+    {
+        b->cycle_index = (uint8_t)((b->cycle_index + 1u) & 7u);
+    }
+}
+
+static void bbr_on_ack(val_session_t *s, uint32_t acked_packets)
+{
+    val_cc_bbr_state_t *b = &s->cc.u.bbr;
+    uint32_t now = cc_now_ms(s);
+    uint32_t n = acked_packets ? acked_packets : 1u;
+    b->delivered += n;
+    if ((int32_t)(b->delivered - b->round_end_delivered) >= 0)
+        bbr_on_round(s, b, now);
+
+    // Refresh the propagation delay estimate when it has gone stale: drain to a tiny window for a moment
+    if (b->mode != VAL_BBR_PROBE_RTT && b->min_rtt_ms && (uint32_t)(now - b->min_rtt_stamp_ms) > BBR_MIN_RTT_WINDOW_MS)
+    {
+        b->mode = VAL_BBR_PROBE_RTT;
+        b->probe_rtt_done_ms = now + BBR_PROBE_RTT_MS;
+        b->min_rtt_ms = 0; // the next sample sets it afresh
+    }
+    if (b->mode == VAL_BBR_PROBE_RTT && (int32_t)(now - b->probe_rtt_done_ms) >= 0)
+    {
+        b->min_rtt_stamp_ms = now;
+        b->mode = b->filled_pipe ? VAL_BBR_PROBE_BW : VAL_BBR_STARTUP;
+        b->cycle_index = 2u;
+    }
+
+    uint32_t cap_fp = cc_cap_fp(s);
+    uint32_t min_fp = BBR_MIN_CWND << VAL_CC_FP_SHIFT;
+    if (min_fp > cap_fp)
+        min_fp = cap_fp;
+    uint64_t w = s->cc.cwnd_fp;
+    if (b->mode == VAL_BBR_PROBE_RTT)
+    {
+        w = min_fp;
+    }
+    else
+    {
+        uint32_t bw = bbr_max_bw(b);
+        uint32_t gain = (b->mode == VAL_BBR_STARTUP) ? BBR_HIGH_GAIN : BBR_CWND_GAIN;
+        // Target window = gain x BDP (packets), plus two packets for ACK coalescing
+        uint64_t target = (b->min_rtt_ms && bw)
+                              ? (uint64_t)bw * b->min_rtt_ms / 1000u * gain / 100u + (2u << VAL_CC_FP_SHIFT)
+                              : 0u;
+        if (target == 0u || !b->filled_pipe)
+        {
+            // No model yet, or still in STARTUP: grow like slow start while below the target
+            if (target == 0u || w < target)
+                w += (uint64_t)n << VAL_CC_FP_SHIFT;
+        }
+        else
+        {
+            w += (uint64_t)n << VAL_CC_FP_SHIFT;
+            if (w > target)
+                w = target;
+        }
+    }
+    if (w < min_fp)
+        w = min_fp;
+    s->cc.cwnd_fp = (w > cap_fp) ? cap_fp : (uint32_t)w;
+}
+
+static void bbr_on_loss(val_session_t *s)
+{
+    // Loss is not a congestion signal here: a saturated bottleneck shows up as a flat delivery rate and a
+    // rising RTT, both already in the model. Timeouts still rewind or retransmit in the sender.
+    (void)s;
+}
+
+static void bbr_on_rtt_sample(val_session_t *s, uint32_t rtt_ms)
+{
+    val_cc_bbr_state_t *b = &s->cc.u.bbr;
+    if (b->min_rtt_ms == 0 || rtt_ms <= b->min_rtt_ms)
+    {
+        b->min_rtt_ms = rtt_ms ? rtt_ms : 1u;
+        b->min_rtt_stamp_ms = cc_now_ms(s);
+    }
+}
+
+static uint32_t bbr_cwnd(const val_session_t *s)
+{
+    return s->cc.cwnd_fp >> VAL_CC_FP_SHIFT;
+}
+
+static uint32_t bbr_pacing_rate(const val_session_t *s)
+{
+    const val_cc_bbr_state_t *b = &s->cc.u.bbr;
+    uint32_t bw = bbr_max_bw(b);
+    if (bw == 0)
+        return 0; // no estimate yet: the window alone limits STARTUP's first round
+    uint64_t pkt_bytes = s->effective_packet_size ? s->effective_packet_size : 1u;
+    uint64_t rate = (uint64_t)bw * bbr_pacing_gain(b) / 100u * pkt_bytes >> VAL_CC_FP_SHIFT;
+    if (rate == 0)
+        rate = 1;
+    return (rate > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)rate;
+}
+
+static const val_cc_ops_t val_cc_bbr = {"bbr", bbr_init, bbr_on_ack, bbr_on_loss, bbr_on_rtt_sample, bbr_cwnd,
+                                        bbr_pacing_rate};
+
+// ---------------------------------------------------------------------------------------------------
+
+const val_cc_ops_t *val_cc_lookup(uint8_t algorithm)
+{
+    switch (algorithm)
+    {
+    case VAL_CC_AIMD:
+        return &val_cc_aimd;
+    case VAL_CC_CUBIC:
+        return &val_cc_cubic;
+    case VAL_CC_BBR:
+        return &val_cc_bbr;
+    default:
+        return NULL;
+    }
+}
+
+void val_internal_cc_init(val_session_t *s)
+{
+    if (!s || !s->cc_ops)
+        return;
+    s->cc_ops->init(s);
+    VAL_LOG_DEBUGF(s, "cc(%s): initial window %u, cap %u", s->cc_ops->name, (unsigned)val_internal_cc_cwnd(s),
+                   (unsigned)s->negotiated_window_packets);
+}
+
+void val_internal_cc_on_ack(val_session_t *s, uint32_t acked_packets)
+{
+    if (!s || !s->cc_ops)
+        return;
+    s->cc_ops->on_ack(s, acked_packets);
+}
+
+uint32_t val_internal_cc_cwnd(const val_session_t *s)
+{
+    uint32_t w = (s->cc_ops) ? s->cc_ops->cwnd(s) : s->current_window_packets;
+    uint32_t cap = s->negotiated_window_packets ? s->negotiated_window_packets : 1u;
+    if (w > cap)
+        w = cap;
+    return w ? w : 1u;
+}
+
+uint32_t val_internal_cc_pacing_rate(const val_session_t *s)
+{
+    return (s->cc_ops && s->cc_ops->pacing_rate) ? s->cc_ops->pacing_rate(s) : 0u;
+}
+
+void val_internal_record_transmission_error(val_session_t *s)
+{
+    if (!s || !s->cc_ops)
+        return;
+    s->cc_ops->on_loss(s);
+}
+
+void val_internal_record_transmission_success(val_session_t *s)
+{
+    val_internal_cc_on_ack(s, 1u);
+}
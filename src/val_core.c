@@ -7,21 +7,65 @@
 
 // A monotonic millisecond clock is required via config.system.get_ticks_ms; no built-in defaults.
 
+// Read-ahead refill: pull whatever transport.recv_some has (up to the free space) into the session
+// buffer, compacting first when fewer than 'need' contiguous bytes remain behind the read position.
+static int val__ra_fill(val_session_t *s, size_t need, uint32_t slice)
+{
+    if (s->rx_ra_head == s->rx_ra_tail)
+        s->rx_ra_head = s->rx_ra_tail = 0;
+    else if (s->rx_ra_cap - s->rx_ra_head < need)
+    {
+        memmove(s->rx_ra_buf, s->rx_ra_buf + s->rx_ra_head, s->rx_ra_tail - s->rx_ra_head);
+        s->rx_ra_tail -= s->rx_ra_head;
+        s->rx_ra_head = 0;
+    }
+    size_t rgot = 0;
+    int r = s->config->transport.recv_some(s->config->transport.io_context, s->rx_ra_buf + s->rx_ra_tail,
+                                           s->rx_ra_cap - s->rx_ra_tail, &rgot, slice);
+    if (r < 0)
+        return VAL_ERR_IO;
+    if (rgot > s->rx_ra_cap - s->rx_ra_tail)
+        rgot = s->rx_ra_cap - s->rx_ra_tail;
+    s->rx_ra_tail += rgot;
+    return VAL_OK;
+}
+
 // Helper: read exactly N bytes within timeout, tolerating partial reads.
 // This is C-compatible (no nested functions) and is reused by recv paths.
-static int val_recv_full(void *io_context,
-                         int (*recv_fn)(void *, void *, size_t, size_t *, uint32_t),
-                         uint32_t (*ticks_fn)(void),
-                         void *dst,
-                         size_t need,
-                         uint32_t to_ms)
+// With read-ahead (transport.recv_some) small reads are served from the session buffer and only
+// consumed once complete, so a timeout leaves a partial frame buffered; a read that is mostly still
+// on the wire (large DATA payloads) takes the buffered bytes and then receives the rest in place.
+static int val_recv_full(val_session_t *s, void *dst, size_t need, uint32_t to_ms)
 {
+    void *io_context = s->config->transport.io_context;
+    int (*recv_fn)(void *, void *, size_t, size_t *, uint32_t) = s->config->transport.recv;
+    uint32_t (*ticks_fn)(void) = s->config->system.get_ticks_ms;
+    int buffered = 0;
+    size_t have = 0;
+    if (s->rx_ra_buf)
+    {
+        recv_fn = s->config->transport.recv_some;
+        size_t avail = s->rx_ra_tail - s->rx_ra_head;
+        if (avail < need && (need > s->rx_ra_cap || need - avail > s->rx_ra_cap / 2u))
+        {
+            memcpy(dst, s->rx_ra_buf + s->rx_ra_head, avail);
+            s->rx_ra_head = s->rx_ra_tail = 0;
+            have = avail;
+        }
+        else
+            buffered = 1;
+    }
     if (!recv_fn)
         return VAL_ERR_IO;
-    size_t have = 0;
     uint32_t start = ticks_fn ? ticks_fn() : 0u;
     for (;;)
     {
+        if (buffered && s->rx_ra_tail - s->rx_ra_head >= need)
+        {
+            memcpy(dst, s->rx_ra_buf + s->rx_ra_head, need);
+            s->rx_ra_head += need;
+            return VAL_OK;
+        }
         if (have >= need)
             return VAL_OK;
         uint32_t now = ticks_fn ? ticks_fn() : 0u;
@@ -29,13 +73,23 @@ static int val_recv_full(void *io_context,
         uint32_t remaining = (to_ms > elapsed) ? (to_ms - elapsed) : 0u;
         // Ensure at least a minimal wait to avoid busy looping on transports that need >0 timeout
         uint32_t slice = remaining ? remaining : (to_ms ? 1u : 0u);
-        size_t rgot = 0;
-        int r = recv_fn(io_context, (uint8_t *)dst + have, need - have, &rgot, slice);
-        if (r < 0)
-            return VAL_ERR_IO;
-        have += rgot;
-        if (have >= need)
-            return VAL_OK;
+        if (buffered)
+        {
+            if (val__ra_fill(s, need, slice) != VAL_OK)
+                return VAL_ERR_IO;
+            if (s->rx_ra_tail - s->rx_ra_head >= need)
+                continue;
+        }
+        else
+        {
+            size_t rgot = 0;
+            int r = recv_fn(io_context, (uint8_t *)dst + have, need - have, &rgot, slice);
+            if (r < 0)
+                return VAL_ERR_IO;
+            have += rgot;
+            if (have >= need)
+                return VAL_OK;
+        }
         if ((ticks_fn ? ticks_fn() : 0u) - start >= to_ms)
             return VAL_ERR_TIMEOUT;
         // Otherwise, loop again within remaining time
@@ -126,62 +180,6 @@ void val_internal_logf(val_session_t *s, int level, const char *file, int line,
     }
 }
 
-// Simple CRC32 (IEEE 802.3) table
-static uint32_t crc32_table[256];
-static int crc32_table_init = 0;
-
-static void crc32_init_table(void)
-{
-    if (crc32_table_init)
-        return;
-    uint32_t poly = 0xEDB88320u;
-    for (uint32_t i = 0; i < 256; ++i)
-    {
-        uint32_t c = i;
-        for (int j = 0; j < 8; ++j)
-        {
-            c = (c & 1u) ? (poly ^ (c >> 1)) : (c >> 1);
-        }
-        crc32_table[i] = c;
-    }
-    crc32_table_init = 1;
-}
-
-uint32_t val_crc32(const void *data, size_t length)
-{
-    crc32_init_table();
-    const uint8_t *p = (const uint8_t *)data;
-    uint32_t c = 0xFFFFFFFFu;
-    for (size_t i = 0; i < length; ++i)
-    {
-        c = crc32_table[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
-    }
-    return c ^ 0xFFFFFFFFu;
-}
-
-uint32_t val_crc32_init_state(void)
-{
-    crc32_init_table();
-    return 0xFFFFFFFFu;
-}
-
-uint32_t val_crc32_update_state(uint32_t state, const void *data, size_t length)
-{
-    crc32_init_table();
-    const uint8_t *p = (const uint8_t *)data;
-    uint32_t c = state;
-    for (size_t i = 0; i < length; ++i)
-    {
-        c = crc32_table[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
-    }
-    return c;
-}
-
-uint32_t val_crc32_finalize_state(uint32_t state)
-{
-    return state ^ 0xFFFFFFFFu;
-}
-
 uint32_t val_get_builtin_features(void)
 {
     return VAL_BUILTIN_FEATURES;
@@ -343,8 +341,7 @@ val_status_t val_get_cwnd_packets(val_session_t *session, uint32_t *out_cwnd)
         return VAL_ERR_INVALID_ARG;
     val_internal_lock(session);
     {
-        uint32_t w = session->current_window_packets ? session->current_window_packets : 1u;
-        *out_cwnd = w;
+        *out_cwnd = val_internal_cc_cwnd(session);
     }
     val_internal_unlock(session);
     return VAL_OK;
@@ -377,6 +374,16 @@ val_status_t val_get_effective_packet_size(val_session_t *session, size_t *out_p
     return VAL_OK;
 }
 
+// Public: optional features active for this session (thread-safe)
+val_status_t val_get_negotiated_features(val_session_t *session, uint32_t *out_features)
+{
+    if (!session || !out_features)
+        return VAL_ERR_INVALID_ARG;
+    val_internal_lock(session);
+    *out_features = session->handshake_done ? session->negotiated_features : 0u;
+    val_internal_unlock(session);
+    return VAL_OK;
+}
 
 // Metadata validation helpers
 void val_config_validation_disabled(val_config_t *config)
@@ -405,16 +412,80 @@ uint32_t val_internal_crc32(val_session_t *s, const void *data, size_t length)
     return val_crc32(data, length);
 }
 
+uint32_t val_internal_crc32_update_state(val_session_t *s, uint32_t state, const void *data, size_t length)
+{
+    if (s && (s->negotiated_features & VAL_FEAT_CRC32C))
+        return val_crc32c_update_state(state, data, length);
+    if (s && s->config && s->config->crc32_provider)
+    {
+        // Provider contract: seed is the raw initial state and the result carries the final XOR
+        return s->config->crc32_provider(state, data, length) ^ 0xFFFFFFFFu;
+    }
+    return val_crc32_update_state(state, data, length);
+}
 
+uint32_t val_internal_frame_crc32(val_session_t *s, uint8_t type, const void *data, size_t length)
+{
+    if (type != VAL_PKT_HELLO && s && (s->negotiated_features & VAL_FEAT_CRC32C))
+        return val_crc32c(data, length);
+    return val_internal_crc32(s, data, length);
+}
 
+size_t val_internal_frame_header_size(val_session_t *s, size_t content_max)
+{
+    if (content_max > VAL_WIRE_STD_MAX_CONTENT && s && (s->negotiated_features & VAL_FEAT_EXT_LEN))
+        return VAL_WIRE_EXT_HEADER_SIZE;
+    return VAL_WIRE_HEADER_SIZE;
+}
 
+uint32_t val_internal_crc32_combine(val_session_t *s, uint32_t crc_a, uint32_t crc_b, uint64_t len_b)
+{
+    int c = (s && (s->negotiated_features & VAL_FEAT_CRC32C)) ? 1 : 0;
+    if (!s)
+        return val_crc32_combine_op(c, crc_a, crc_b, val_crc32_combine_gen(c, len_b));
+    if (s->crc_combine_op == 0 || s->crc_combine_len != len_b || s->crc_combine_c != (uint8_t)c)
+    {
+        s->crc_combine_op = val_crc32_combine_gen(c, len_b);
+        s->crc_combine_len = len_b;
+        s->crc_combine_c = (uint8_t)c;
+    }
+    return val_crc32_combine_op(c, crc_a, crc_b, s->crc_combine_op);
+}
 
-
+// CRC of [start_offset, start_offset + length) hashed in place from read-only mappings. Returns 0 when the
+// first window cannot be mapped (the caller reads instead), -1 when a later one fails, 1 on success.
+static int val__crc32_region_mapped(val_session_t *s, void *file_handle, uint64_t start_offset, uint64_t length,
+                                    uint32_t *out_crc)
+{
+    const val_config_t *cfg = s->config;
+    uint32_t state = val_crc32_init_state();
+    uint64_t pos = start_offset, end = start_offset + length;
+    while (pos < end)
+    {
+        uint64_t base = pos - (pos % VAL_MAP_ALIGN);
+        size_t span = (end - base < (uint64_t)VAL_MAP_SPAN) ? (size_t)(end - base) : (size_t)VAL_MAP_SPAN;
+        uint8_t *m = (uint8_t *)cfg->filesystem.map(cfg->filesystem.fs_context, file_handle, base, span, false);
+        if (!m)
+            return (pos == start_offset) ? 0 : -1;
+        state = val_internal_crc32_update_state(s, state, m + (size_t)(pos - base), span - (size_t)(pos - base));
+        (void)cfg->filesystem.unmap(cfg->filesystem.fs_context, file_handle, m, base, span, span);
+        pos = base + span;
+    }
+    *out_crc = val_crc32_finalize_state(state);
+    return 1;
+}
 
 val_status_t val_internal_crc32_region(val_session_t *s, void *file_handle, uint64_t start_offset,
                                        uint64_t length, uint32_t *out_crc)
 {
-    if (!s || !s->config || !s->config->filesystem.fseek || !s->config->filesystem.fread || !out_crc)
+    const val_config_t *cfg = s ? s->config : NULL;
+    if (cfg && out_crc && cfg->filesystem.map && length)
+    {
+        int r = val__crc32_region_mapped(s, file_handle, start_offset, length, out_crc);
+        if (r != 0)
+            return (r > 0) ? VAL_OK : VAL_ERR_IO;
+    }
+    if (!cfg || !out_crc || (!cfg->filesystem.pread && (!cfg->filesystem.fseek || !cfg->filesystem.fread)))
         return VAL_ERR_INVALID_ARG;
     if (!s->config->buffers.recv_buffer)
         return VAL_ERR_INVALID_ARG;
@@ -423,31 +494,25 @@ val_status_t val_internal_crc32_region(val_session_t *s, void *file_handle, uint
         return VAL_ERR_INVALID_ARG;
     if (step > s->config->buffers.packet_size)
         step = s->config->buffers.packet_size;
-    // Seek to start
-    if (s->config->filesystem.fseek(s->config->filesystem.fs_context, file_handle, (long)start_offset, SEEK_SET) != 0)
+    // Seek to start (positional reads need no seek)
+    if (!cfg->filesystem.pread &&
+        cfg->filesystem.fseek(cfg->filesystem.fs_context, file_handle, (int64_t)start_offset, SEEK_SET) != 0)
         return VAL_ERR_IO;
-    
-    // Use hardware CRC if available and data fits in buffer for single-shot operation
-    if (s->config->crc32_provider && length <= step) {
-        size_t rr = s->config->filesystem.fread(s->config->filesystem.fs_context,
-                                                s->config->buffers.recv_buffer, 1, (size_t)length, file_handle);
-        if (rr != (size_t)length)
-            return VAL_ERR_IO;
-        *out_crc = s->config->crc32_provider(0xFFFFFFFFu, s->config->buffers.recv_buffer, (size_t)length);
-        return VAL_OK;
-    }
-    
-    // Fallback to incremental CRC for large files or when no hardware provider
+
+    // Incremental CRC with the session's algorithm (negotiated CRC32C, provider, or built-in IEEE)
     uint32_t state = val_crc32_init_state();
     uint64_t left = length;
     while (left > 0)
     {
         size_t take = (left < (uint64_t)step) ? (size_t)left : step;
-        size_t rr = s->config->filesystem.fread(s->config->filesystem.fs_context,
-                                                s->config->buffers.recv_buffer, 1, take, file_handle);
+        size_t rr = cfg->filesystem.pread
+                        ? cfg->filesystem.pread(cfg->filesystem.fs_context, file_handle, cfg->buffers.recv_buffer, take,
+                                                start_offset + (length - left))
+                        : cfg->filesystem.fread(cfg->filesystem.fs_context, cfg->buffers.recv_buffer, 1, take,
+                                                file_handle);
         if (rr != take)
             return VAL_ERR_IO;
-        state = val_crc32_update_state(state, s->config->buffers.recv_buffer, take);
+        state = val_internal_crc32_update_state(s, state, s->config->buffers.recv_buffer, take);
         left -= take;
     }
     *out_crc = val_crc32_finalize_state(state);
@@ -510,6 +575,8 @@ void val_internal_record_rtt(val_session_t *s, uint32_t measured_rtt_ms)
     if (s->timing.samples_taken < 0xFF)
         s->timing.samples_taken++;
     val_metrics_inc_rtt_sample(s);
+    if (s->cc_ops && s->cc_ops->on_rtt_sample)
+        s->cc_ops->on_rtt_sample(s, rtt);
 }
 
 uint32_t val_internal_get_timeout(val_session_t *s, val_operation_type_t op)
@@ -570,6 +637,22 @@ void val_session_destroy(val_session_t *session)
         else
             free(session->tracking_slots);
     }
+    // Free reorder metadata
+    if (session->rx_reorder)
+    {
+        if (session->cfg.tx_flow.allocator.free && session->cfg.tx_flow.allocator.alloc)
+            session->cfg.tx_flow.allocator.free(session->rx_reorder, session->cfg.tx_flow.allocator.context);
+        else
+            free(session->rx_reorder);
+    }
+    // Free read-ahead buffer
+    if (session->rx_ra_buf)
+    {
+        if (session->cfg.tx_flow.allocator.free && session->cfg.tx_flow.allocator.alloc)
+            session->cfg.tx_flow.allocator.free(session->rx_ra_buf, session->cfg.tx_flow.allocator.context);
+        else
+            free(session->rx_ra_buf);
+    }
     // Free session
     if (session->cfg.tx_flow.allocator.free && session->cfg.tx_flow.allocator.alloc)
         session->cfg.tx_flow.allocator.free(session, session->cfg.tx_flow.allocator.context);
@@ -577,6 +660,20 @@ void val_session_destroy(val_session_t *session)
         free(session);
 }
 
+// Local window cap in packets: tx_flow.window_cap_packets, else the byte cap in whole frames of packet_size,
+// else 0 (implementation default). Never more than the congestion controllers can represent.
+static uint32_t val__local_window_packets(const val_config_t *cfg, size_t packet_size)
+{
+    uint32_t w = cfg->tx_flow.window_cap_packets;
+    if (!w && cfg->tx_flow.window_cap_bytes && packet_size)
+    {
+        w = (uint32_t)(cfg->tx_flow.window_cap_bytes / packet_size);
+        if (w == 0)
+            w = 1;
+    }
+    return (w > VAL_WINDOW_MAX_PACKETS) ? VAL_WINDOW_MAX_PACKETS : w;
+}
+
 val_status_t val_session_create(const val_config_t *config, val_session_t **out_session, uint32_t *out_detail)
 {
     if (out_detail)
@@ -599,6 +696,17 @@ val_status_t val_session_create(const val_config_t *config, val_session_t **out_
             *out_detail = VAL_SET_MISSING_HOOKS();
         return VAL_ERR_INVALID_ARG;
     }
+    if (!val_cc_lookup(config->tx_flow.congestion_control))
+        return VAL_ERR_INVALID_ARG;
+    if (!config->filesystem.read_submit != !config->filesystem.read_wait ||
+        !config->filesystem.map != !config->filesystem.unmap)
+        return VAL_ERR_INVALID_ARG;
+    if (!config->filesystem.write_submit != !config->filesystem.write_wait ||
+        config->tx_flow.ack_policy > VAL_ACK_ON_WRITE)
+        return VAL_ERR_INVALID_ARG;
+    if (config->tx_flow.pacing_mode > VAL_PACING_LINK_RATE ||
+        (config->tx_flow.pacing_mode == VAL_PACING_LINK_RATE && config->tx_flow.pacing_rate_bps < 8u))
+        return VAL_ERR_INVALID_ARG;
     // Validate packet size bounds
     size_t P = config->buffers.packet_size;
     if (P < VAL_MIN_PACKET_SIZE || P > VAL_MAX_PACKET_SIZE)
@@ -645,9 +753,11 @@ val_status_t val_session_create(const val_config_t *config, val_session_t **out_
     // Initialize adaptive TX defaults
     // New bounded-window defaults: start conservative; detailed negotiation occurs in HELLO adopt
     s->negotiated_window_packets = 1;
+    s->negotiated_window_bytes = 0;
     s->current_window_packets = 1;
     s->peer_tx_window_packets = 1;
     s->ack_stride_packets = 0; // 0 => default to window
+    s->cc_ops = val_cc_lookup(s->cfg.tx_flow.congestion_control);
     s->consecutive_errors = 0;
     s->consecutive_successes = 0;
     s->packets_since_mode_change = 0;
@@ -664,15 +774,13 @@ val_status_t val_session_create(const val_config_t *config, val_session_t **out_
     memset(&s->metrics, 0, sizeof(s->metrics));
 #endif
     s->output_directory[0] = '\0';
-    // Allocate tracking slots based on a safe default (will be adequate for initial window)
-    // Note: this will be re-used; current implementation doesn't reallocate on increases.
-    // Use tx_flow.window_cap_packets (preferred) to size tracking slots if specified; else a safe default.
-    if (s->cfg.tx_flow.window_cap_packets)
-        s->max_tracking_slots = s->cfg.tx_flow.window_cap_packets;
-    else
-        s->max_tracking_slots = 64u; // reasonable default; can be tuned or made configurable
-    if (s->max_tracking_slots == 0)
-        s->max_tracking_slots = 1;
+    // Allocate tracking slots for the local window cap, up to VAL_TRACKING_SLOTS_INITIAL; the sender grows
+    // the table as the negotiated window opens further, so large caps cost nothing until they are used.
+    s->max_tracking_slots = val__local_window_packets(&s->cfg, s->cfg.buffers.packet_size);
+    if (s->max_tracking_slots == 0 || s->max_tracking_slots > VAL_TRACKING_SLOTS_INITIAL)
+        s->max_tracking_slots = VAL_TRACKING_SLOTS_INITIAL;
+    s->tracking_next = 0;
+    s->tracking_high = 0;
     size_t tsz = sizeof(val_inflight_packet_t) * (size_t)s->max_tracking_slots;
     if (A->alloc && A->free)
         s->tracking_slots = (val_inflight_packet_t *)A->alloc(tsz, A->context);
@@ -687,6 +795,38 @@ val_status_t val_session_create(const val_config_t *config, val_session_t **out_
         return VAL_ERR_NO_MEMORY;
     }
     memset(s->tracking_slots, 0, tsz);
+    // Reorder store metadata: one slot per packet_size chunk of the caller's reorder buffer
+    if (s->cfg.buffers.rx_reorder_buffer && s->cfg.buffers.rx_reorder_size >= s->cfg.buffers.packet_size)
+    {
+        s->rx_reorder_slots = (uint32_t)(s->cfg.buffers.rx_reorder_size / s->cfg.buffers.packet_size);
+        size_t rsz = sizeof(val_rx_reorder_slot_t) * (size_t)s->rx_reorder_slots;
+        if (A->alloc && A->free)
+            s->rx_reorder = (val_rx_reorder_slot_t *)A->alloc(rsz, A->context);
+        else
+            s->rx_reorder = (val_rx_reorder_slot_t *)malloc(rsz);
+        if (!s->rx_reorder)
+        {
+            s->rx_reorder_slots = 0;
+            val_session_destroy(s);
+            return VAL_ERR_NO_MEMORY;
+        }
+        memset(s->rx_reorder, 0, rsz);
+    }
+    // Read-ahead buffer when the transport can return partial reads; one packet holds many control frames
+    if (s->cfg.transport.recv_some)
+    {
+        s->rx_ra_cap = s->cfg.buffers.packet_size;
+        if (A->alloc && A->free)
+            s->rx_ra_buf = (uint8_t *)A->alloc(s->rx_ra_cap, A->context);
+        else
+            s->rx_ra_buf = (uint8_t *)malloc(s->rx_ra_cap);
+        if (!s->rx_ra_buf)
+        {
+            s->rx_ra_cap = 0;
+            val_session_destroy(s);
+            return VAL_ERR_NO_MEMORY;
+        }
+    }
 
     *out_session = s;
     if (out_detail)
@@ -714,6 +854,140 @@ val_status_t val_get_error(val_session_t *session, val_error_t *out)
     return VAL_OK;
 }
 
+// Post-send bookkeeping shared by the copy and scatter-gather paths: metrics, TX capture, flush
+static void val__send_epilogue(val_session_t *s, val_packet_type_t type, size_t total_len, uint32_t payload_len, uint64_t offset)
+{
+    // Metrics: count one packet and bytes on successful low-level send
+    val_metrics_add_sent(s, total_len, (uint8_t)type);
+    // Packet capture hook (TX)
+    if (s->config->capture.on_packet)
+    {
+        val_packet_record_t rec;
+        rec.direction = VAL_DIR_TX;
+        rec.type = (uint8_t)type;
+        rec.wire_len = (uint32_t)total_len;
+        rec.payload_len = payload_len;
+        rec.offset = offset;
+    rec.crc_ok = true; // not meaningful on TX
+        uint32_t now = s->config->system.get_ticks_ms ? s->config->system.get_ticks_ms() : 0u;
+        rec.timestamp_ms = now;
+        rec.session_id = (const void *)s;
+        s->config->capture.on_packet(s->config->capture.context, &rec);
+    }
+    // Best-effort flush after control packets where timely delivery matters
+    if (type == VAL_PKT_DONE || type == VAL_PKT_EOT || type == VAL_PKT_HELLO || type == VAL_PKT_ERROR || type == VAL_PKT_CANCEL)
+    {
+        val_internal_transport_flush(s);
+    }
+}
+
+// Header (+ offset prefix) and trailer of a DATA frame sent as separate segments around a payload that is
+// not copied; the trailer CRC is accumulated over head and payload. Returns the head length, or 0 (error
+// recorded) when the content does not fit the MTU.
+static size_t val__data_frame_segments(val_session_t *s, const void *payload, uint32_t payload_len, uint64_t offset,
+                                       int include_data_offset, uint8_t *head, uint8_t *trailer)
+{
+    size_t P = s->effective_packet_size ? s->effective_packet_size : s->config->buffers.packet_size; // MTU
+    uint8_t flags = (uint8_t)((include_data_offset ? VAL_DATA_OFFSET_PRESENT : VAL_DATA_OFFSET_HINT) | s->tx_data_flags);
+    uint32_t content_len = payload_len + (include_data_offset ? 8u : 0u);
+    uint32_t hint = include_data_offset ? 0u : (uint32_t)(offset & 0xFFFFFFFFull);
+    size_t hdr_len = val_internal_frame_header_size(s, (size_t)payload_len + 8u);
+    if ((size_t)content_len > (P - hdr_len - VAL_WIRE_TRAILER_SIZE) ||
+        (hdr_len == VAL_WIRE_HEADER_SIZE && content_len > VAL_WIRE_STD_MAX_CONTENT))
+    {
+        val_internal_set_error_detailed(s, VAL_ERR_INVALID_ARG, VAL_ERROR_DETAIL_PAYLOAD_SIZE);
+        VAL_LOG_ERROR(s, "send_packet: content too large for MTU");
+        return 0;
+    }
+    if (hdr_len == VAL_WIRE_EXT_HEADER_SIZE)
+        val_serialize_frame_header_ext((uint8_t)VAL_PKT_DATA, flags, content_len, hint, head);
+    else
+        val_serialize_frame_header((uint8_t)VAL_PKT_DATA, flags, (uint16_t)content_len, hint, head);
+    size_t head_len = hdr_len;
+    if (include_data_offset)
+    {
+        VAL_PUT_LE64(head + hdr_len, offset);
+        head_len += 8u;
+    }
+    uint32_t crc = val_crc32_init_state();
+    crc = val_internal_crc32_update_state(s, crc, head, head_len);
+    if (payload_len)
+        crc = val_internal_crc32_update_state(s, crc, payload, payload_len);
+    VAL_PUT_LE32(trailer, val_crc32_finalize_state(crc));
+    return head_len;
+}
+
+// DATA frame via transport.sendv: header (+ offset prefix), the caller's payload in place and the
+// trailer go out as separate segments, so no payload byte is copied. Called with the session lock held;
+// releases it.
+static int val__send_data_gather(val_session_t *s, const void *payload, uint32_t payload_len, uint64_t offset,
+                                 int include_data_offset)
+{
+    uint8_t head[VAL_WIRE_EXT_HEADER_SIZE + 8u];
+    uint8_t trailer[VAL_WIRE_TRAILER_SIZE];
+    size_t head_len = val__data_frame_segments(s, payload, payload_len, offset, include_data_offset, head, trailer);
+    if (!head_len)
+    {
+        val_internal_unlock(s);
+        return VAL_ERR_INVALID_ARG;
+    }
+
+    val_iovec_t iov[3];
+    size_t iovcnt = 0;
+    iov[iovcnt].base = head;
+    iov[iovcnt++].len = head_len;
+    if (payload_len)
+    {
+        iov[iovcnt].base = payload;
+        iov[iovcnt++].len = payload_len;
+    }
+    iov[iovcnt].base = trailer;
+    iov[iovcnt++].len = VAL_WIRE_TRAILER_SIZE;
+    size_t total_len = head_len + payload_len + VAL_WIRE_TRAILER_SIZE;
+    int rc = s->config->transport.sendv(s->config->transport.io_context, iov, iovcnt);
+    val_internal_unlock(s);
+    if (rc != (int)total_len)
+    {
+        VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_SEND_FAILED);
+        VAL_LOG_ERROR(s, "send_packet: transport sendv failed");
+        return VAL_ERR_IO;
+    }
+    val__send_epilogue(s, VAL_PKT_DATA, total_len, payload_len, offset);
+    return VAL_OK;
+}
+
+int val_internal_send_data_file(val_session_t *s, void *file, const void *view, uint32_t payload_len, uint64_t offset,
+                                int include_data_offset)
+{
+    val_internal_lock(s);
+    if (!val_internal_transport_is_connected(s))
+    {
+        VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_CONNECTION);
+        val_internal_unlock(s);
+        return VAL_ERR_IO;
+    }
+    uint8_t head[VAL_WIRE_EXT_HEADER_SIZE + 8u];
+    uint8_t trailer[VAL_WIRE_TRAILER_SIZE];
+    size_t head_len = val__data_frame_segments(s, view, payload_len, offset, include_data_offset, head, trailer);
+    if (!head_len)
+    {
+        val_internal_unlock(s);
+        return VAL_ERR_INVALID_ARG;
+    }
+    size_t total_len = head_len + payload_len + VAL_WIRE_TRAILER_SIZE;
+    int rc = s->config->transport.send_file(s->config->transport.io_context, head, head_len, file, offset, payload_len,
+                                            trailer, VAL_WIRE_TRAILER_SIZE);
+    val_internal_unlock(s);
+    if (rc != (int)total_len)
+    {
+        VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_SEND_FAILED);
+        VAL_LOG_ERROR(s, "send_packet: transport send_file failed");
+        return VAL_ERR_IO;
+    }
+    val__send_epilogue(s, VAL_PKT_DATA, total_len, payload_len, offset);
+    return VAL_OK;
+}
+
 // Core sender with control over including explicit DATA offset and finalized NAK encoding
 static int val__internal_send_packet_core(val_session_t *s, val_packet_type_t type, const void *payload, uint32_t payload_len, uint64_t offset, int include_data_offset)
 {
@@ -722,7 +996,6 @@ static int val__internal_send_packet_core(val_session_t *s, val_packet_type_t ty
     // Cache hooks used repeatedly in this function (function pointers + context)
     void *io = s->config->transport.io_context;
     int (*send_fn)(void *, const void *, size_t) = s->config->transport.send;
-    uint32_t (*ticks_fn)(void) = s->config->system.get_ticks_ms;
     // Optional preflight connection check
     if (!val_internal_transport_is_connected(s))
     {
@@ -730,60 +1003,62 @@ static int val__internal_send_packet_core(val_session_t *s, val_packet_type_t ty
         val_internal_unlock(s);
         return VAL_ERR_IO;
     }
+    if (type == VAL_PKT_DATA && s->config->transport.sendv && (payload || payload_len == 0))
+        return val__send_data_gather(s, payload, payload_len, offset, include_data_offset);
     size_t P = s->effective_packet_size ? s->effective_packet_size : s->config->buffers.packet_size; // MTU
     uint8_t *buf = (uint8_t *)s->config->buffers.send_buffer;
     uint8_t flags = 0;
-    uint16_t content_len = payload_len;
+    uint32_t content_len = payload_len;
     uint32_t type_data = 0;
-    uint8_t *content_dst = buf + VAL_WIRE_HEADER_SIZE;
+    // Extended header once the content (incl. a DATA offset prefix) may not fit 16 bits
+    size_t hdr_len = val_internal_frame_header_size(s, (size_t)payload_len + 8u);
+    uint8_t *content_dst = buf + hdr_len;
     size_t copy_payload_from = 0; // 0 means use provided payload as-is
 
     switch (type)
     {
     case VAL_PKT_DATA:
+        flags |= s->tx_data_flags;
         if (include_data_offset)
         {
             flags |= VAL_DATA_OFFSET_PRESENT;
-            content_len = (uint16_t)(payload_len + 8u);
-            if (payload_len && payload)
-            {
-                if (payload == content_dst)
-                {
-                    // Shift existing payload right by 8 bytes to make room for offset; handle overlap safely
-                    memmove(content_dst + 8, content_dst, payload_len);
-                    VAL_PUT_LE64(content_dst, offset);
-                }
-                else
-                {
-                    VAL_PUT_LE64(content_dst, offset);
-                    memcpy(content_dst + 8, payload, payload_len);
-                }
-            }
-            else
-            {
-                VAL_PUT_LE64(content_dst, offset);
-            }
+            content_len = payload_len + 8u;
+            // Payload may already sit in the send buffer (sender reads in place): move it first to make
+            // room for the offset; memmove handles the overlap
+            if (payload_len && payload && payload != content_dst + 8)
+                memmove(content_dst + 8, payload, payload_len);
+            VAL_PUT_LE64(content_dst, offset);
         }
         else
         {
-            // Implied offset: no prefix; copy payload as-is
+            // Implied offset: no prefix; copy payload as-is. The low 32 bits ride in type_data so the
+            // receiver can tell a frame that follows a lost one from the next in-order frame.
+            flags |= VAL_DATA_OFFSET_HINT;
+            type_data = (uint32_t)(offset & 0xFFFFFFFFull);
             content_len = payload_len;
-            if (payload_len && payload)
-                memcpy(content_dst, payload, payload_len);
+            if (payload_len && payload && payload != content_dst)
+                memmove(content_dst, payload, payload_len);
         }
         break;
     case VAL_PKT_DATA_ACK:
+    case VAL_PKT_DONE:
     case VAL_PKT_DONE_ACK:
     case VAL_PKT_EOT_ACK:
     {
-        // Encode cumulative ACK offset: low32 in type_data, optional high32 in content (4 bytes)
+        // Encode cumulative ACK offset (file size for DONE): low32 in type_data, optional high32 in content (4 bytes)
         uint32_t low = (uint32_t)(offset & 0xFFFFFFFFull);
         uint32_t high = (uint32_t)((offset >> 32) & 0xFFFFFFFFull);
         type_data = low;
-        if (high != 0)
+        if (high != 0 || (type == VAL_PKT_DATA_ACK && payload && payload_len))
         {
             content_len = 4u;
             VAL_PUT_LE32(content_dst, high);
+            // Selective repeat: SACK blocks follow the high word
+            if (type == VAL_PKT_DATA_ACK && payload && payload_len)
+            {
+                memcpy(content_dst + 4, payload, payload_len);
+                content_len += payload_len;
+            }
         }
         else
         {
@@ -818,18 +1093,22 @@ static int val__internal_send_packet_core(val_session_t *s, val_packet_type_t ty
     }
 
     // Validate computed content length now that it's known
-    if ((size_t)content_len > (P - VAL_WIRE_HEADER_SIZE - VAL_WIRE_TRAILER_SIZE))
+    if ((size_t)content_len > (P - hdr_len - VAL_WIRE_TRAILER_SIZE) ||
+        (hdr_len == VAL_WIRE_HEADER_SIZE && content_len > VAL_WIRE_STD_MAX_CONTENT))
     {
         val_internal_set_error_detailed(s, VAL_ERR_INVALID_ARG, VAL_ERROR_DETAIL_PAYLOAD_SIZE);
         VAL_LOG_ERROR(s, "send_packet: content too large for MTU");
         val_internal_unlock(s);
         return VAL_ERR_INVALID_ARG;
     }
-    // Serialize 8-byte header
-    val_serialize_frame_header((uint8_t)type, flags, content_len, type_data, buf);
+    // Serialize 8-byte (or extended 12-byte) header
+    if (hdr_len == VAL_WIRE_EXT_HEADER_SIZE)
+        val_serialize_frame_header_ext((uint8_t)type, flags, content_len, type_data, buf);
+    else
+        val_serialize_frame_header((uint8_t)type, flags, (uint16_t)content_len, type_data, buf);
     // Trailer CRC over [header + content]
-    size_t used = VAL_WIRE_HEADER_SIZE + (size_t)content_len;
-    uint32_t pkt_crc = val_internal_crc32(s, buf, used);
+    size_t used = hdr_len + (size_t)content_len;
+    uint32_t pkt_crc = val_internal_frame_crc32(s, (uint8_t)type, buf, used);
     VAL_PUT_LE32(buf + used, pkt_crc);
     size_t total_len = used + VAL_WIRE_TRAILER_SIZE;
     int rc = send_fn ? send_fn(io, buf, total_len) : -1;
@@ -840,27 +1119,77 @@ static int val__internal_send_packet_core(val_session_t *s, val_packet_type_t ty
         VAL_LOG_ERROR(s, "send_packet: transport send failed");
         return VAL_ERR_IO;
     }
-    // Metrics: count one packet and bytes on successful low-level send
-    val_metrics_add_sent(s, total_len, (uint8_t)type);
-    // Packet capture hook (TX)
-    if (s->config->capture.on_packet)
+    val__send_epilogue(s, type, total_len, payload_len, offset);
+    return VAL_OK;
+}
+
+size_t val_internal_data_frame_prefix(val_session_t *s, uint32_t payload_len, int include_data_offset)
+{
+    return val_internal_frame_header_size(s, (size_t)payload_len + 8u) + (include_data_offset ? 8u : 0u);
+}
+
+size_t val_internal_seal_data_frame(val_session_t *s, uint8_t *frame, uint32_t payload_len, uint64_t offset,
+                                    int include_data_offset)
+{
+    size_t hdr_len = val_internal_frame_header_size(s, (size_t)payload_len + 8u);
+    uint8_t flags = (uint8_t)((include_data_offset ? VAL_DATA_OFFSET_PRESENT : VAL_DATA_OFFSET_HINT) | s->tx_data_flags);
+    uint32_t content_len = payload_len + (include_data_offset ? 8u : 0u);
+    uint32_t hint = include_data_offset ? 0u : (uint32_t)(offset & 0xFFFFFFFFull);
+    if (hdr_len == VAL_WIRE_EXT_HEADER_SIZE)
+        val_serialize_frame_header_ext((uint8_t)VAL_PKT_DATA, flags, content_len, hint, frame);
+    else
+        val_serialize_frame_header((uint8_t)VAL_PKT_DATA, flags, (uint16_t)content_len, hint, frame);
+    if (include_data_offset)
+        VAL_PUT_LE64(frame + hdr_len, offset);
+    size_t used = hdr_len + (size_t)content_len;
+    VAL_PUT_LE32(frame + used, val_internal_frame_crc32(s, (uint8_t)VAL_PKT_DATA, frame, used));
+    return used + VAL_WIRE_TRAILER_SIZE;
+}
+
+int val_internal_send_data_batch(val_session_t *s, const uint8_t *frames, size_t len, uint32_t count,
+                                 uint64_t first_offset)
+{
+    val_internal_lock(s);
+    if (!val_internal_transport_is_connected(s))
     {
-        val_packet_record_t rec;
-        rec.direction = VAL_DIR_TX;
-        rec.type = (uint8_t)type;
-        rec.wire_len = (uint32_t)total_len;
-        rec.payload_len = payload_len;
-        rec.offset = offset;
-    rec.crc_ok = true; // not meaningful on TX
-        uint32_t now = ticks_fn ? ticks_fn() : 0u;
-        rec.timestamp_ms = now;
-        rec.session_id = (const void *)s;
-        s->config->capture.on_packet(s->config->capture.context, &rec);
+        VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_CONNECTION);
+        val_internal_unlock(s);
+        return VAL_ERR_IO;
     }
-    // Best-effort flush after control packets where timely delivery matters
-    if (type == VAL_PKT_DONE || type == VAL_PKT_EOT || type == VAL_PKT_HELLO || type == VAL_PKT_ERROR || type == VAL_PKT_CANCEL)
+    int rc = s->config->transport.send(s->config->transport.io_context, frames, len);
+    val_internal_unlock(s);
+    if (rc != (int)len)
     {
-        val_internal_transport_flush(s);
+        VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_SEND_FAILED);
+        VAL_LOG_ERROR(s, "send_packet: transport batch send failed");
+        return VAL_ERR_IO;
+    }
+    // Per-frame metrics and capture, recovered from the frames just sent
+    size_t at = 0;
+    uint64_t offset = first_offset;
+    for (uint32_t i = 0; i < count && at + VAL_WIRE_HEADER_SIZE <= len; ++i)
+    {
+        uint8_t tbyte = 0, flags = 0;
+        uint16_t clen16 = 0;
+        uint32_t type_data = 0;
+        val_deserialize_frame_header(frames + at, &tbyte, &flags, &clen16, &type_data);
+        size_t hdr_len = VAL_WIRE_HEADER_SIZE;
+        uint32_t content_len = clen16;
+        if (flags & VAL_FRAME_EXT_LEN)
+        {
+            hdr_len = VAL_WIRE_EXT_HEADER_SIZE;
+            content_len = val_deserialize_frame_ext_len(frames + at);
+        }
+        uint32_t payload_len = content_len;
+        if (flags & VAL_DATA_OFFSET_PRESENT)
+        {
+            offset = VAL_GET_LE64(frames + at + hdr_len);
+            payload_len -= 8u;
+        }
+        size_t frame_len = hdr_len + (size_t)content_len + VAL_WIRE_TRAILER_SIZE;
+        val__send_epilogue(s, VAL_PKT_DATA, frame_len, payload_len, offset);
+        offset += payload_len;
+        at += frame_len;
     }
     return VAL_OK;
 }
@@ -877,20 +1206,100 @@ int val_internal_send_packet_ex(val_session_t *s, val_packet_type_t type, const
     return val__internal_send_packet_core(s, type, payload, payload_len, offset, include_data_offset);
 }
 
+// Post-receive bookkeeping shared by the buffered and direct DATA paths: metrics, RX capture
+static void val__recv_epilogue(val_session_t *s, uint8_t type_byte, size_t wire_len, uint32_t payload_len, uint64_t offset)
+{
+    val_metrics_add_recv(s, wire_len, type_byte);
+    // Packet capture hook (RX)
+    if (s->config->capture.on_packet)
+    {
+        val_packet_record_t rec;
+        rec.direction = VAL_DIR_RX;
+        rec.type = type_byte;
+        rec.wire_len = (uint32_t)wire_len;
+        rec.payload_len = payload_len;
+        rec.offset = offset;
+    rec.crc_ok = true; // we verified CRC above
+        uint32_t now = s->config->system.get_ticks_ms ? s->config->system.get_ticks_ms() : 0u;
+        rec.timestamp_ms = now;
+        rec.session_id = (const void *)s;
+        s->config->capture.on_packet(s->config->capture.context, &rec);
+    }
+}
+
+// DATA frame whose header is already in buf: the offset prefix lands behind the header, the file
+// bytes go straight into payload_out (no staging in recv_buffer, no move), and the trailer is
+// checked by combining the prefix CRC with the payload CRC, which is kept for the receiver.
+// payload_out may alias buf: header and offset are consumed before the payload read overwrites them.
+// Called with the session lock held; releases it.
+static int val__recv_data_direct(val_session_t *s, uint8_t *buf, size_t hdr_len, uint8_t flags, uint32_t content_len,
+                                 void *payload_out, val_packet_type_t *type, uint32_t *payload_len_out,
+                                 uint64_t *offset_out, uint32_t timeout_ms)
+{
+    uint32_t prefix = (flags & VAL_DATA_OFFSET_PRESENT) ? 8u : 0u;
+    uint32_t data_len = content_len - prefix;
+    uint8_t trailer_bytes[VAL_WIRE_TRAILER_SIZE];
+    int rc = VAL_OK;
+    if (prefix)
+        rc = val_recv_full(s, buf + hdr_len, prefix, timeout_ms);
+    uint64_t offv = prefix ? VAL_GET_LE64(buf + hdr_len) : UINT64_MAX; // UINT64_MAX: implied offset
+    uint32_t head_crc = val_internal_frame_crc32(s, VAL_PKT_DATA, buf, hdr_len + prefix);
+    if (rc == VAL_OK && data_len > 0)
+        rc = val_recv_full(s, payload_out, data_len, timeout_ms);
+    if (rc == VAL_OK)
+        rc = val_recv_full(s, trailer_bytes, VAL_WIRE_TRAILER_SIZE, timeout_ms);
+    if (rc != VAL_OK)
+    {
+        if (rc == VAL_ERR_IO)
+        {
+            VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_RECV_FAILED);
+            VAL_LOG_ERROR(s, "recv_packet: transport error on DATA body");
+        }
+        else
+        {
+            val_internal_set_last_error(s, VAL_ERR_TIMEOUT, VAL_ERROR_DETAIL_TIMEOUT_DATA);
+            if (timeout_ms > 50u) {
+                VAL_LOG_DEBUGF(s, "recv_packet: DATA body timeout ts=%u timeout_ms=%u", (unsigned)s->config->system.get_ticks_ms(), timeout_ms);
+            }
+        }
+        val_internal_unlock(s);
+        return rc;
+    }
+
+    uint32_t data_crc = val_internal_frame_crc32(s, VAL_PKT_DATA, payload_out, data_len);
+    if (VAL_GET_LE32(trailer_bytes) != val_internal_crc32_combine(s, head_crc, data_crc, data_len))
+    {
+        VAL_SET_CRC_ERROR(s, VAL_ERROR_DETAIL_CRC_TRAILER);
+        VAL_LOG_ERROR(s, "recv_packet: trailer CRC mismatch");
+#if VAL_ENABLE_METRICS
+        s->metrics.crc_errors++;
+#endif
+        val_internal_unlock(s);
+        return VAL_ERR_CRC;
+    }
+    s->rx_data_crc = data_crc;
+    s->rx_data_flags = flags;
+    if (type) *type = VAL_PKT_DATA;
+    if (payload_len_out) *payload_len_out = data_len;
+    if (offset_out) *offset_out = offv;
+    val_internal_unlock(s);
+
+    val__recv_epilogue(s, (uint8_t)VAL_PKT_DATA, hdr_len + content_len + VAL_WIRE_TRAILER_SIZE, content_len,
+                       prefix ? offv : 0u);
+    return VAL_OK;
+}
+
 int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *payload_out, uint32_t payload_cap,
                              uint32_t *payload_len_out, uint64_t *offset_out, uint32_t timeout_ms)
 {
     // Serialize low-level recv operations; recursive with public API locks
     val_internal_lock(s);
-    void *io = s->config->transport.io_context;
-    int (*recv_fn)(void *, void *, size_t, size_t *, uint32_t) = s->config->transport.recv;
-    uint32_t (*ticks_fn)(void) = s->config->system.get_ticks_ms;
     size_t P = s->effective_packet_size ? s->effective_packet_size : s->config->buffers.packet_size; // MTU
     uint8_t *buf = (uint8_t *)s->config->buffers.recv_buffer;
     size_t got = 0;
 
     // Read header first (8 bytes) using robust partial-read loop
-    int rc = val_recv_full(io, recv_fn, ticks_fn, buf, VAL_WIRE_HEADER_SIZE, timeout_ms);
+    int rc = val_recv_full(s, buf, VAL_WIRE_HEADER_SIZE, timeout_ms);
     if (rc == VAL_ERR_IO)
     {
         VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_RECV_FAILED);
@@ -903,7 +1312,7 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         // Benign timeout while waiting for a header; record without emitting a CRITICAL numeric log
         val_internal_set_last_error(s, VAL_ERR_TIMEOUT, VAL_ERROR_DETAIL_TIMEOUT_DATA);
         if (timeout_ms > 50u) {
-            VAL_LOG_DEBUGF(s, "recv_packet: HEADER timeout ts=%u timeout_ms=%u", (unsigned)(ticks_fn ? ticks_fn() : 0u), timeout_ms);
+            VAL_LOG_DEBUGF(s, "recv_packet: HEADER timeout ts=%u timeout_ms=%u", (unsigned)s->config->system.get_ticks_ms(), timeout_ms);
         }
         val_internal_unlock(s);
         return VAL_ERR_TIMEOUT;
@@ -911,8 +1320,36 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
     // Parse 8-byte header
     uint8_t tbyte = 0, flags = 0; uint16_t content_len = 0; uint32_t type_data = 0;
     val_deserialize_frame_header(buf, &tbyte, &flags, &content_len, &type_data);
+    if (tbyte == VAL_PKT_DATA)
+        s->rx_data_offset_hint = type_data;
     uint32_t payload_len = (uint32_t)content_len;
-    if (payload_len > (uint32_t)(P - VAL_WIRE_HEADER_SIZE - VAL_WIRE_TRAILER_SIZE))
+    size_t hdr_len = VAL_WIRE_HEADER_SIZE;
+    if (flags & VAL_FRAME_EXT_LEN)
+    {
+        // Extended header: 32-bit content length follows; only legal once negotiated
+        if (!(s->negotiated_features & VAL_FEAT_EXT_LEN))
+        {
+            VAL_SET_PROTOCOL_ERROR(s, VAL_ERROR_DETAIL_MALFORMED_PKT);
+            VAL_LOG_ERROR(s, "recv_packet: extended header without VAL_FEAT_EXT_LEN");
+            val_internal_unlock(s);
+            return VAL_ERR_PROTOCOL;
+        }
+        rc = val_recv_full(s, buf + VAL_WIRE_HEADER_SIZE, VAL_WIRE_EXT_HEADER_SIZE - VAL_WIRE_HEADER_SIZE,
+                           timeout_ms);
+        if (rc != VAL_OK)
+        {
+            if (rc == VAL_ERR_IO)
+                VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_RECV_FAILED);
+            else
+                val_internal_set_last_error(s, VAL_ERR_TIMEOUT, VAL_ERROR_DETAIL_TIMEOUT_DATA);
+            val_internal_unlock(s);
+            return rc;
+        }
+        hdr_len = VAL_WIRE_EXT_HEADER_SIZE;
+        payload_len = val_deserialize_frame_ext_len(buf);
+    }
+    uint8_t *body = buf + hdr_len;
+    if (payload_len > (uint32_t)(P - hdr_len - VAL_WIRE_TRAILER_SIZE))
     {
         VAL_SET_PROTOCOL_ERROR(s, VAL_ERROR_DETAIL_PAYLOAD_SIZE);
         VAL_LOG_ERROR(s, "recv_packet: payload_len exceeds MTU");
@@ -920,9 +1357,18 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         return VAL_ERR_PROTOCOL;
     }
 
+    // DATA into a caller buffer that can hold it: take the direct path (no intermediate copy)
+    if (tbyte == VAL_PKT_DATA && payload_out && payload_cap)
+    {
+        uint32_t prefix = (flags & VAL_DATA_OFFSET_PRESENT) ? 8u : 0u;
+        if (payload_len >= prefix && payload_len - prefix <= payload_cap)
+            return val__recv_data_direct(s, buf, hdr_len, flags, payload_len, payload_out, type, payload_len_out,
+                                         offset_out, timeout_ms);
+    }
+
     if (payload_len > 0)
     {
-        rc = val_recv_full(io, recv_fn, ticks_fn, buf + VAL_WIRE_HEADER_SIZE, payload_len, timeout_ms);
+        rc = val_recv_full(s, body, payload_len, timeout_ms);
         if (rc == VAL_ERR_IO)
         {
             VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_RECV_FAILED);
@@ -934,7 +1380,7 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         {
             val_internal_set_last_error(s, VAL_ERR_TIMEOUT, VAL_ERROR_DETAIL_TIMEOUT_DATA);
             if (timeout_ms > 50u) {
-                VAL_LOG_DEBUGF(s, "recv_packet: PAYLOAD timeout ts=%u timeout_ms=%u", (unsigned)(ticks_fn ? ticks_fn() : 0u), timeout_ms);
+                VAL_LOG_DEBUGF(s, "recv_packet: PAYLOAD timeout ts=%u timeout_ms=%u", (unsigned)s->config->system.get_ticks_ms(), timeout_ms);
             }
             val_internal_unlock(s);
             return VAL_ERR_TIMEOUT;
@@ -942,7 +1388,7 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
     }
 
     uint8_t trailer_bytes[VAL_WIRE_TRAILER_SIZE];
-    rc = val_recv_full(io, recv_fn, ticks_fn, trailer_bytes, VAL_WIRE_TRAILER_SIZE, timeout_ms);
+    rc = val_recv_full(s, trailer_bytes, VAL_WIRE_TRAILER_SIZE, timeout_ms);
     if (rc == VAL_ERR_IO)
     {
         VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_RECV_FAILED);
@@ -954,14 +1400,14 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
     {
         val_internal_set_last_error(s, VAL_ERR_TIMEOUT, VAL_ERROR_DETAIL_TIMEOUT_DATA);
         if (timeout_ms > 50u) {
-            VAL_LOG_DEBUGF(s, "recv_packet: TRAILER timeout ts=%u timeout_ms=%u", (unsigned)(ticks_fn ? ticks_fn() : 0u), timeout_ms);
+            VAL_LOG_DEBUGF(s, "recv_packet: TRAILER timeout ts=%u timeout_ms=%u", (unsigned)s->config->system.get_ticks_ms(), timeout_ms);
         }
         val_internal_unlock(s);
         return VAL_ERR_TIMEOUT;
     }
 
     uint32_t trailer_crc = VAL_GET_LE32(trailer_bytes);
-    uint32_t calc_crc = val_internal_crc32(s, buf, VAL_WIRE_HEADER_SIZE + payload_len);
+    uint32_t calc_crc = val_internal_frame_crc32(s, tbyte, buf, hdr_len + payload_len);
     if (trailer_crc != calc_crc)
     {
         VAL_SET_CRC_ERROR(s, VAL_ERROR_DETAIL_CRC_TRAILER);
@@ -973,6 +1419,20 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         return VAL_ERR_CRC;
     }
 
+    if (tbyte == VAL_PKT_DATA)
+    {
+        // CRC of the file bytes alone, derived from the verified trailer instead of a second pass:
+        // crc(data) = crc(prefix || data) combined with crc(prefix) over |data|
+        uint32_t prefix_len = (uint32_t)hdr_len + ((flags & VAL_DATA_OFFSET_PRESENT) ? 8u : 0u);
+        uint32_t frame_len = (uint32_t)hdr_len + payload_len;
+        if (frame_len >= prefix_len)
+        {
+            uint32_t prefix_crc = val_internal_frame_crc32(s, tbyte, buf, prefix_len);
+            s->rx_data_crc = val_internal_crc32_combine(s, prefix_crc, calc_crc, frame_len - prefix_len);
+        }
+        s->rx_data_flags = flags;
+    }
+
     // Interpret per-type semantics and set out params
     uint8_t type_byte = tbyte;
     if (type) *type = (val_packet_type_t)type_byte;
@@ -984,7 +1444,7 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         {
             if (flags & VAL_DATA_OFFSET_PRESENT)
             {
-                offv = VAL_GET_LE64(buf + VAL_WIRE_HEADER_SIZE);
+                offv = VAL_GET_LE64(body);
             }
             else
             {
@@ -992,19 +1452,20 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
                 offv = UINT64_MAX;
             }
         }
-        else if (type_byte == VAL_PKT_DATA_ACK || type_byte == VAL_PKT_DONE_ACK || type_byte == VAL_PKT_EOT_ACK)
+        else if (type_byte == VAL_PKT_DATA_ACK || type_byte == VAL_PKT_DONE || type_byte == VAL_PKT_DONE_ACK ||
+                 type_byte == VAL_PKT_EOT_ACK)
         {
             uint32_t low = type_data;
             uint32_t high = 0;
             if (payload_len >= 4)
-                high = VAL_GET_LE32(buf + VAL_WIRE_HEADER_SIZE);
+                high = VAL_GET_LE32(body);
             offv = ((uint64_t)high << 32) | (uint64_t)low;
         }
         else if (type_byte == VAL_PKT_DATA_NAK)
         {
             // Reconstruct next_expected from header+content
             uint32_t low = type_data;
-            uint32_t high = (payload_len >= 4) ? VAL_GET_LE32(buf + VAL_WIRE_HEADER_SIZE) : 0u;
+            uint32_t high = (payload_len >= 4) ? VAL_GET_LE32(body) : 0u;
             offv = ((uint64_t)high << 32) | (uint64_t)low;
         }
         else
@@ -1023,7 +1484,7 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
     if (payload_out && payload_cap)
     {
         // Special handling for DATA with explicit offset: deliver only payload bytes to caller
-        const uint8_t *src = buf + VAL_WIRE_HEADER_SIZE;
+        const uint8_t *src = body;
         uint32_t copy_len = payload_len;
         if (type_byte == VAL_PKT_DATA && (flags & VAL_DATA_OFFSET_PRESENT))
         {
@@ -1042,33 +1503,19 @@ int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *pa
         memmove(payload_out, src, copy_len);
     }
 
-    val_internal_unlock(s);
-
-    val_metrics_add_recv(s, (size_t)(VAL_WIRE_HEADER_SIZE + payload_len + VAL_WIRE_TRAILER_SIZE), type_byte);
-    // Packet capture hook (RX)
-    if (s->config->capture.on_packet)
+    // Best-effort: compute offset as above for capture too
+    uint64_t cap_off = 0;
+    if (type_byte == VAL_PKT_DATA && (flags & VAL_DATA_OFFSET_PRESENT))
+        cap_off = VAL_GET_LE64(body);
+    else if (type_byte == VAL_PKT_DATA_ACK || type_byte == VAL_PKT_DONE || type_byte == VAL_PKT_DONE_ACK ||
+             type_byte == VAL_PKT_EOT_ACK)
     {
-        val_packet_record_t rec;
-        rec.direction = VAL_DIR_RX;
-        rec.type = type_byte;
-        rec.wire_len = VAL_WIRE_HEADER_SIZE + payload_len + VAL_WIRE_TRAILER_SIZE;
-        rec.payload_len = payload_len;
-        // Best-effort: compute offset as above for capture too
-        uint64_t cap_off = 0;
-        if (type_byte == VAL_PKT_DATA && (flags & VAL_DATA_OFFSET_PRESENT))
-            cap_off = VAL_GET_LE64(buf + VAL_WIRE_HEADER_SIZE);
-        else if (type_byte == VAL_PKT_DATA_ACK || type_byte == VAL_PKT_DONE_ACK || type_byte == VAL_PKT_EOT_ACK)
-        {
-            uint32_t low = type_data; uint32_t high = (payload_len >= 4) ? VAL_GET_LE32(buf + VAL_WIRE_HEADER_SIZE) : 0;
-            cap_off = ((uint64_t)high << 32) | (uint64_t)low;
-        }
-        rec.offset = cap_off;
-    rec.crc_ok = true; // we verified CRC above
-        uint32_t now = ticks_fn ? ticks_fn() : 0u;
-        rec.timestamp_ms = now;
-        rec.session_id = (const void *)s;
-        s->config->capture.on_packet(s->config->capture.context, &rec);
+        uint32_t low = type_data; uint32_t high = (payload_len >= 4) ? VAL_GET_LE32(body) : 0;
+        cap_off = ((uint64_t)high << 32) | (uint64_t)low;
     }
+    val_internal_unlock(s);
+
+    val__recv_epilogue(s, type_byte, hdr_len + payload_len + VAL_WIRE_TRAILER_SIZE, payload_len, cap_off);
     return VAL_OK;
 }
 
@@ -1278,6 +1725,43 @@ val_status_t val_internal_wait_done_ack(val_session_t *s, uint64_t file_size)
     return st;
 }
 
+// Pipelined DONE (VAL_FEAT_PIPELINE): the next file's RESUME_REQ, or EOT, follows the DONE. The receiver answers
+// those only after finishing this file, so their reply acknowledges the DONE as well.
+static int accept_done_ack_pipelined_cb(val_session_t *ss, val_packet_type_t t, const uint8_t *p, uint32_t l, uint64_t o,
+                                        void *cx)
+{
+    (void)ss; (void)p; (void)o; (void)cx;
+    if (t == VAL_PKT_RESUME_RESP)
+        return (l >= VAL_WIRE_RESUME_RESP_SIZE) ? 1 : 0;
+    return (t == VAL_PKT_DONE_ACK || t == VAL_PKT_EOT_ACK) ? 1 : 0;
+}
+
+val_status_t val_internal_wait_done_ack_pipelined(val_session_t *s, uint64_t file_size, val_packet_type_t *out_type,
+                                                  uint8_t *resp, uint32_t *resp_len)
+{
+    if (!s || !out_type || !resp || !resp_len)
+        return VAL_ERR_INVALID_ARG;
+    uint32_t to = val_internal_get_timeout(s, VAL_OP_DONE_ACK);
+    uint8_t tries = s->config->retries.ack_retries ? s->config->retries.ack_retries : 0;
+    uint32_t backoff = s->config->retries.backoff_ms_base ? s->config->retries.backoff_ms_base : 0;
+    uint32_t t0 = s->config->system.get_ticks_ms ? s->config->system.get_ticks_ms() : 0u;
+    val_done_retry_ctx_t ctx = { file_size };
+    // Room for a late DATA_ACK with SACK blocks too; they are skipped
+    uint8_t buf[128]; uint64_t oo = 0;
+    val_status_t st = val_internal_wait_control(s, to, tries, backoff, buf, (uint32_t)sizeof(buf), out_type, resp_len,
+                                                &oo, accept_done_ack_pipelined_cb, retry_send_done_cb, &ctx);
+    if (st == VAL_OK && *out_type == VAL_PKT_RESUME_RESP)
+        memcpy(resp, buf, VAL_WIRE_RESUME_RESP_SIZE);
+    // A DONE_ACK times the DONE round trip; the other replies queued behind the receiver's file work
+    if (st == VAL_OK && *out_type == VAL_PKT_DONE_ACK && t0 && !s->timing.in_retransmit)
+    {
+        uint32_t now = s->config->system.get_ticks_ms ? s->config->system.get_ticks_ms() : 0u;
+        if (now)
+            val_internal_record_rtt(s, now - t0);
+    }
+    return st;
+}
+
 val_status_t val_internal_wait_eot_ack(val_session_t *s)
 {
     if (!s)
@@ -1539,42 +2023,18 @@ val_status_t val_internal_wait_verify_result(val_session_t *s,
     {
         *out_resume_offset = end_off;
         VAL_LOG_TRACEF(s, "verify_result: status=OK -> resume_off=%llu", (unsigned long long)*out_resume_offset);
-        {
-            FILE *tf = fopen("resume_trace.log", "a");
-            if (tf)
-            {
-                fprintf(tf, "VERIFY_RESULT status=OK resume_off=%llu\n", (unsigned long long)*out_resume_offset);
-                fclose(tf);
-            }
-        }
         return VAL_OK;
     }
     if (status == VAL_SKIPPED)
     {
         *out_resume_offset = UINT64_MAX;
         VAL_LOG_TRACEF(s, "verify_result: status=SKIPPED -> resume_off=UINT64_MAX");
-        {
-            FILE *tf = fopen("resume_trace.log", "a");
-            if (tf)
-            {
-                fprintf(tf, "VERIFY_RESULT status=SKIPPED resume_off=UINT64_MAX\n");
-                fclose(tf);
-            }
-        }
         return VAL_OK;
     }
     if (status == VAL_ERR_RESUME_VERIFY)
     {
         *out_resume_offset = 0;
         VAL_LOG_TRACEF(s, "verify_result: status=ERR_RESUME_VERIFY -> resume_off=0");
-        {
-            FILE *tf = fopen("resume_trace.log", "a");
-            if (tf)
-            {
-                fprintf(tf, "VERIFY_RESULT status=ERR_RESUME_VERIFY resume_off=0\n");
-                fclose(tf);
-            }
-        }
         return VAL_OK;
     }
     return (val_status_t)status;
@@ -1751,20 +2211,27 @@ static void val__fill_local_hello(val_session_t *s, size_t packet_size, val_hand
     hello->features = negotiable;
     hello->required = s->config->features.required & negotiable;
     hello->requested = requested_sanitized;
-    // Flow-control capability exchange (bounded-window)
-    uint32_t w = s->cfg.tx_flow.window_cap_packets ? s->cfg.tx_flow.window_cap_packets : 1u;
-    if (w > 0xFFFFu) w = 0xFFFFu;
-    hello->tx_max_window_packets = (uint16_t)w;
-    hello->rx_max_window_packets = (uint16_t)w;
-    // Prefer conservative ACKs by default to guarantee progress with small sender windows
-    hello->ack_stride_packets = 1u; // default preference: ACK every packet
+    // Flow-control capability exchange (bounded-window). Caps above 65535 packets are sent scaled down by
+    // window_shift (rounding down, so the peer never sees more than we can take).
+    uint32_t w = val__local_window_packets(&s->cfg, packet_size);
+    if (!w)
+        w = 1u;
+    uint8_t shift = 0;
+    while ((w >> shift) > 0xFFFFu)
+        shift++;
+    hello->tx_max_window_packets = (uint16_t)(w >> shift);
+    hello->rx_max_window_packets = (uint16_t)(w >> shift);
+    hello->window_shift = shift;
+    hello->rx_max_window_bytes = s->cfg.tx_flow.window_cap_bytes;
+    // Most in-order DATA packets this side is willing to cover with one DATA_ACK when receiving
+    hello->ack_stride_packets = s->cfg.tx_flow.ack_stride_packets ? s->cfg.tx_flow.ack_stride_packets
+                                                                  : (uint8_t)VAL_ACK_STRIDE_DEFAULT;
     hello->reserved_capabilities[0] = 0;
     hello->reserved_capabilities[1] = 0;
     hello->reserved_capabilities[2] = 0;
     hello->supported_features16 = 0;
     hello->required_features16 = 0;
     hello->requested_features16 = 0;
-    hello->reserved2 = 0;
 }
 
 // Adopt peer HELLO and finalize negotiation; returns VAL_OK or a specific error
@@ -1804,37 +2271,77 @@ static val_status_t val__adopt_peer_hello(val_session_t *s, const val_handshake_
         (void)val_internal_send_error(s, VAL_ERR_FEATURE_NEGOTIATION, VAL_SET_MISSING_FEATURE(missing_on_peer));
         return VAL_ERR_FEATURE_NEGOTIATION;
     }
+    // Active set: supported by both, wanted by either side. Symmetric, so both peers derive the same
+    // mask from the two HELLOs without an extra round trip.
+    uint32_t local_wanted = (s->config->features.requested | s->config->features.required) & negotiable;
+    uint32_t peer_wanted = peer_h->requested | peer_h->required;
+    // Extended headers are wanted whenever the negotiated packet size exceeds what 16-bit content_len
+    // can describe (both sides derive this from the same min packet size)
+    uint32_t implied = (negotiated > VAL_WIRE_STD_MAX_PACKET) ? VAL_FEAT_EXT_LEN : 0u;
+    s->negotiated_features = negotiable & peer_h->features & (local_wanted | peer_wanted | implied);
+    if (s->negotiated_features)
+        VAL_LOG_INFOF(s, "handshake: negotiated features 0x%08x", (unsigned)s->negotiated_features);
+    if (!(s->negotiated_features & VAL_FEAT_EXT_LEN) && s->effective_packet_size > VAL_WIRE_STD_MAX_PACKET)
+    {
+        // Peer cannot parse extended headers: cap the packet size so every frame fits the 16-bit length
+        VAL_LOG_INFOF(s, "handshake: packet size %u capped to %u (no extended headers)",
+                      (unsigned)s->effective_packet_size, (unsigned)VAL_WIRE_STD_MAX_PACKET);
+        s->effective_packet_size = VAL_WIRE_STD_MAX_PACKET;
+    }
 
     // Bounded-window capability negotiation
     // Local desired TX window (fallbacks: prefer buffers.packet_size heuristics if no explicit config exists)
-    uint16_t local_desired = 0;
+    uint32_t local_desired = 0;
     if (s->cfg.tx_flow.window_cap_packets) {
-        local_desired = s->cfg.tx_flow.window_cap_packets;
+        local_desired = val__local_window_packets(&s->cfg, s->effective_packet_size);
+    } else if (s->cfg.tx_flow.window_cap_bytes) {
+        local_desired = VAL_WINDOW_MAX_PACKETS; // bounded by the byte cap below
     } else {
         local_desired = 4; // conservative default
     }
 
-    // Peer capabilities from HELLO
-    uint16_t peer_rx_cap = peer_h->rx_max_window_packets ? peer_h->rx_max_window_packets : 1;
-    uint16_t peer_tx_cap = peer_h->tx_max_window_packets ? peer_h->tx_max_window_packets : 1;
+    // Peer capabilities from HELLO (scaled by window_shift; older peers send 0)
+    uint8_t peer_shift = (peer_h->window_shift < 16u) ? peer_h->window_shift : 16u;
+    uint32_t peer_rx_cap = peer_h->rx_max_window_packets ? ((uint32_t)peer_h->rx_max_window_packets << peer_shift) : 1u;
+    uint32_t peer_tx_cap = peer_h->tx_max_window_packets ? ((uint32_t)peer_h->tx_max_window_packets << peer_shift) : 1u;
     s->peer_tx_window_packets = peer_tx_cap;
 
     // Negotiate sender cap: we cannot exceed peer's RX max
-    uint16_t negotiated_window = (local_desired < peer_rx_cap) ? local_desired : peer_rx_cap;
+    uint32_t negotiated_window = (local_desired < peer_rx_cap) ? local_desired : peer_rx_cap;
+    // Byte caps: the smaller non-zero one, applied in whole frames of the negotiated packet size
+    uint32_t local_bytes = s->cfg.tx_flow.window_cap_bytes;
+    uint32_t peer_bytes = peer_h->rx_max_window_bytes;
+    uint32_t window_bytes = (!peer_bytes || (local_bytes && local_bytes < peer_bytes)) ? local_bytes : peer_bytes;
+    s->negotiated_window_bytes = window_bytes;
+    if (window_bytes && s->effective_packet_size)
+    {
+        uint32_t by_bytes = (uint32_t)(window_bytes / s->effective_packet_size);
+        if (by_bytes < negotiated_window)
+            negotiated_window = by_bytes;
+    }
+    if (negotiated_window > VAL_WINDOW_MAX_PACKETS) negotiated_window = VAL_WINDOW_MAX_PACKETS;
     if (negotiated_window == 0) negotiated_window = 1;
     s->negotiated_window_packets = negotiated_window;
-    // Start conservatively (e.g., 1..4) and ramp up additively later
+    if (window_bytes)
+        VAL_LOG_INFOF(s, "handshake: window %u packets (%u byte cap)", (unsigned)negotiated_window, (unsigned)window_bytes);
+    // Start conservatively (e.g., 1..4); the congestion controller ramps up from there
     if (s->cfg.tx_flow.initial_cwnd_packets) {
-        uint16_t cw0 = s->cfg.tx_flow.initial_cwnd_packets;
+        uint32_t cw0 = s->cfg.tx_flow.initial_cwnd_packets;
         if (cw0 < 1) cw0 = 1;
         if (cw0 > negotiated_window) cw0 = negotiated_window;
         s->current_window_packets = cw0;
     } else {
         s->current_window_packets = (negotiated_window >= 4 ? 4 : negotiated_window);
     }
-    // Receiver ACK stride preference: be conservative to ensure progress regardless of sender's current window.
-    // For now, ACK every packet. We can make this adaptive later based on observed inflight and RTT.
-    s->ack_stride_packets = 1;
+    // Receiver ACK stride cap: both preferences (0/1 = ACK every packet, so older peers keep per-packet ACKs)
+    // and never more than the peer can have in flight. The receiver adapts within [1, cap] per file.
+    uint16_t local_stride = s->cfg.tx_flow.ack_stride_packets ? s->cfg.tx_flow.ack_stride_packets : VAL_ACK_STRIDE_DEFAULT;
+    uint16_t peer_stride = peer_h->ack_stride_packets ? peer_h->ack_stride_packets : 1u;
+    uint16_t stride = (local_stride < peer_stride) ? local_stride : peer_stride;
+    if (stride > peer_tx_cap)
+        stride = (uint16_t)peer_tx_cap;
+    s->ack_stride_packets = stride ? stride : 1u;
+    val_internal_cc_init(s);
     return VAL_OK;
 }
 
@@ -2087,75 +2594,6 @@ val_status_t val_internal_send_error(val_session_t *s, val_status_t code, uint32
     return val_internal_send_packet(s, VAL_PKT_ERROR, wire, VAL_WIRE_ERROR_PAYLOAD_SIZE, 0);
 }
 
-// Adaptive transmission mode management
-// (Removed legacy mode upgrade/degrade helpers)
-
-void val_internal_record_transmission_error(val_session_t *s)
-{
-    if (!s)
-        return;
-
-    s->consecutive_errors++;
-    s->consecutive_successes = 0; // reset success counter
-
-    // AIMD halve on sustained errors
-    uint16_t threshold = s->cfg.tx_flow.degrade_error_threshold ? s->cfg.tx_flow.degrade_error_threshold : 0;
-    if (threshold == 0)
-        threshold = 3; // default threshold
-
-    if (s->consecutive_errors >= threshold)
-    {
-        uint16_t cur = s->current_window_packets ? s->current_window_packets : 1u;
-        uint16_t new_w = (uint16_t)(cur / 2u);
-        if (new_w < 1u) new_w = 1u;
-        if (new_w != cur)
-        {
-            VAL_LOG_INFOF(s, "adaptive(win): decrease %u -> %u after %u errors", (unsigned)cur, (unsigned)new_w,
-                          (unsigned)s->consecutive_errors);
-            s->current_window_packets = new_w;
-            s->consecutive_errors = 0; // reset after adjustment
-            s->packets_since_mode_change = 0;
-            if (s->tracking_slots)
-                memset(s->tracking_slots, 0, sizeof(val_inflight_packet_t) * s->max_tracking_slots);
-        }
-    }
-}
-
-void val_internal_record_transmission_success(val_session_t *s)
-{
-    if (!s)
-        return;
-
-    s->consecutive_successes++;
-    s->consecutive_errors = 0; // reset error counter
-
-    // AIMD additive increase on sustained successes
-    uint16_t threshold = s->cfg.tx_flow.recovery_success_threshold ? s->cfg.tx_flow.recovery_success_threshold : 0;
-    if (threshold == 0)
-        threshold = 10; // default threshold
-
-    if (s->consecutive_successes >= threshold)
-    {
-        uint16_t cur = s->current_window_packets ? s->current_window_packets : 1u;
-        uint16_t cap = s->negotiated_window_packets ? s->negotiated_window_packets : cur;
-        if (cur < cap)
-        {
-            uint16_t new_w = (uint16_t)(cur + 1u);
-            if (new_w > cap) new_w = cap;
-            if (new_w != cur)
-            {
-                VAL_LOG_INFOF(s, "adaptive(win): increase %u -> %u after %u successes", (unsigned)cur, (unsigned)new_w,
-                              (unsigned)s->consecutive_successes);
-                s->current_window_packets = new_w;
-                s->consecutive_successes = 1; // keep momentum
-                s->packets_since_mode_change = 0;
-                if (s->tracking_slots)
-                    memset(s->tracking_slots, 0, sizeof(val_inflight_packet_t) * s->max_tracking_slots);
-            }
-        }
-    }
-}
-
 #if VAL_ENABLE_METRICS
 #include <string.h>
 val_status_t val_get_metrics(val_session_t *session, val_metrics_t *out)
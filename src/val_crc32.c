@@ -0,0 +1,596 @@
+#include "val_internal.h"
+#include <string.h>
+
+// CRC32 engines for the IEEE 802.3 (reflected 0xEDB88320) and Castagnoli/CRC32C (reflected
+// 0x82F63B78) polynomials.
+//
+// All engines operate on the raw (non-inverted) running state so that the incremental
+// val_crc32_* helpers and the one-shot val_crc32() share the same code path. The engine family is
+// selected once at first use (fastest available) and may be overridden with val_crc32_set_impl();
+// the selection applies to both polynomials.
+
+// Number of slicing tables to build. 16 enables slicing-by-16 (16 KiB of tables), 8 limits the
+// engine to slicing-by-8 (8 KiB), and 1 keeps the classic bytewise walk (1 KiB) for MCU builds.
+#ifndef VAL_CRC32_SLICE_TABLES
+#define VAL_CRC32_SLICE_TABLES 16
+#endif
+#if VAL_CRC32_SLICE_TABLES != 1 && VAL_CRC32_SLICE_TABLES != 8 && VAL_CRC32_SLICE_TABLES != 16
+#error "VAL_CRC32_SLICE_TABLES must be 1, 8 or 16"
+#endif
+
+// Hardware engines (x86 PCLMULQDQ folding / SSE4.2 CRC32, AArch64 CRC32 instructions) are compiled
+// in where the toolchain allows it and used only when the running CPU reports support. Define
+// VAL_CRC32_ENABLE_HW=0 to build the software engines only.
+#ifndef VAL_CRC32_ENABLE_HW
+#define VAL_CRC32_ENABLE_HW 1
+#endif
+
+#if VAL_CRC32_ENABLE_HW && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64)) && \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(_MSC_VER))
+#define VAL_CRC32_HW_X86 1
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define VAL_CRC32_TARGET_CLMUL
+#define VAL_CRC32_TARGET_SSE42
+#else
+#include <cpuid.h>
+#define VAL_CRC32_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#define VAL_CRC32_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#elif VAL_CRC32_ENABLE_HW && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN) && \
+    (defined(__ARM_FEATURE_CRC32) || (defined(__linux__) && (defined(__GNUC__) || defined(__clang__))))
+#define VAL_CRC32_HW_ARM64 1
+#include <arm_acle.h>
+#if defined(__ARM_FEATURE_CRC32)
+#define VAL_CRC32_TARGET_CRC
+#else
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#if defined(__clang__)
+#define VAL_CRC32_TARGET_CRC __attribute__((target("crc")))
+#else
+#define VAL_CRC32_TARGET_CRC __attribute__((target("+crc")))
+#endif
+#endif
+#endif
+
+#define VAL_CRC32_POLY_REFLECTED 0xEDB88320u
+#define VAL_CRC32C_POLY_REFLECTED 0x82F63B78u
+
+typedef uint32_t (*val_crc32_engine_fn)(uint32_t state, const uint8_t *p, size_t length);
+typedef uint32_t val_crc32_tables_t[VAL_CRC32_SLICE_TABLES][256];
+
+// tables[0] is the classic bytewise table; tables[k][i] is the CRC of byte i followed by k zero
+// bytes, which lets the slicing engines fold 8 or 16 input bytes per iteration.
+static val_crc32_tables_t crc32_tables;
+static val_crc32_tables_t crc32c_tables;
+static int crc32_table_init = 0;
+static val_crc32_impl_t crc32_impl = VAL_CRC32_IMPL_AUTO;
+static val_crc32_engine_fn crc32_engine = NULL;
+static val_crc32_engine_fn crc32c_engine = NULL;
+// x^(8*2^k) mod P for k = 0..63 (the operator for 2^k bytes), used by the combine operators below.
+// No wrap-around: x^(2^32) = x holds mod the IEEE polynomial but not mod Castagnoli's.
+static uint32_t crc32_x2n_table[64];
+static uint32_t crc32c_x2n_table[64];
+
+static void crc32_build_tables(val_crc32_tables_t t, uint32_t poly)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t c = i;
+        for (int j = 0; j < 8; ++j)
+        {
+            c = (c & 1u) ? (poly ^ (c >> 1)) : (c >> 1);
+        }
+        t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t c = t[0][i];
+        for (int k = 1; k < VAL_CRC32_SLICE_TABLES; ++k)
+        {
+            c = t[0][c & 0xFFu] ^ (c >> 8);
+            t[k][i] = c;
+        }
+    }
+}
+
+// Multiply a by b modulo the (reflected) polynomial; bit 31 is x^0.
+static uint32_t crc_multmodp(uint32_t poly, uint32_t a, uint32_t b)
+{
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if ((a & (m - 1u)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = (b & 1u) ? (b >> 1) ^ poly : b >> 1;
+    }
+    return p;
+}
+
+static void crc_build_x2n(uint32_t *x2n, uint32_t poly)
+{
+    uint32_t p = 1u << 23; // x^8
+    x2n[0] = p;
+    for (int k = 1; k < 64; ++k)
+        x2n[k] = p = crc_multmodp(poly, p, p);
+}
+
+static void crc32_init_table(void)
+{
+    if (crc32_table_init)
+        return;
+    crc32_build_tables(crc32_tables, VAL_CRC32_POLY_REFLECTED);
+    crc32_build_tables(crc32c_tables, VAL_CRC32C_POLY_REFLECTED);
+    crc_build_x2n(crc32_x2n_table, VAL_CRC32_POLY_REFLECTED);
+    crc_build_x2n(crc32c_x2n_table, VAL_CRC32C_POLY_REFLECTED);
+    crc32_table_init = 1;
+}
+
+static inline uint32_t crc32_load_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t crc_bytewise(const uint32_t (*t)[256], uint32_t state, const uint8_t *p, size_t length)
+{
+    uint32_t c = state;
+    for (size_t i = 0; i < length; ++i)
+    {
+        c = t[0][(c ^ p[i]) & 0xFFu] ^ (c >> 8);
+    }
+    return c;
+}
+
+#if VAL_CRC32_SLICE_TABLES >= 8
+static uint32_t crc_slice8(const uint32_t (*t)[256], uint32_t state, const uint8_t *p, size_t length)
+{
+    uint32_t c = state;
+    while (length >= 8)
+    {
+        uint32_t a = c ^ crc32_load_le32(p);
+        uint32_t b = crc32_load_le32(p + 4);
+        c = t[7][a & 0xFFu] ^ t[6][(a >> 8) & 0xFFu] ^ t[5][(a >> 16) & 0xFFu] ^ t[4][a >> 24] ^
+            t[3][b & 0xFFu] ^ t[2][(b >> 8) & 0xFFu] ^ t[1][(b >> 16) & 0xFFu] ^ t[0][b >> 24];
+        p += 8;
+        length -= 8;
+    }
+    return crc_bytewise(t, c, p, length);
+}
+#endif
+
+#if VAL_CRC32_SLICE_TABLES >= 16
+static uint32_t crc_slice16(const uint32_t (*t)[256], uint32_t state, const uint8_t *p, size_t length)
+{
+    uint32_t c = state;
+    while (length >= 16)
+    {
+        uint32_t a = c ^ crc32_load_le32(p);
+        uint32_t b = crc32_load_le32(p + 4);
+        uint32_t d = crc32_load_le32(p + 8);
+        uint32_t e = crc32_load_le32(p + 12);
+        c = t[15][a & 0xFFu] ^ t[14][(a >> 8) & 0xFFu] ^ t[13][(a >> 16) & 0xFFu] ^ t[12][a >> 24] ^
+            t[11][b & 0xFFu] ^ t[10][(b >> 8) & 0xFFu] ^ t[9][(b >> 16) & 0xFFu] ^ t[8][b >> 24] ^
+            t[7][d & 0xFFu] ^ t[6][(d >> 8) & 0xFFu] ^ t[5][(d >> 16) & 0xFFu] ^ t[4][d >> 24] ^
+            t[3][e & 0xFFu] ^ t[2][(e >> 8) & 0xFFu] ^ t[1][(e >> 16) & 0xFFu] ^ t[0][e >> 24];
+        p += 16;
+        length -= 16;
+    }
+    return crc_bytewise(t, c, p, length);
+}
+#endif
+
+// Per-polynomial software engines (bound to their table set)
+static uint32_t crc32_engine_bytewise(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_bytewise((const uint32_t (*)[256])crc32_tables, state, p, length);
+}
+
+static uint32_t crc32c_engine_bytewise(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_bytewise((const uint32_t (*)[256])crc32c_tables, state, p, length);
+}
+
+#if VAL_CRC32_SLICE_TABLES >= 8
+static uint32_t crc32_engine_slice8(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_slice8((const uint32_t (*)[256])crc32_tables, state, p, length);
+}
+
+static uint32_t crc32c_engine_slice8(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_slice8((const uint32_t (*)[256])crc32c_tables, state, p, length);
+}
+#endif
+
+#if VAL_CRC32_SLICE_TABLES >= 16
+static uint32_t crc32_engine_slice16(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_slice16((const uint32_t (*)[256])crc32_tables, state, p, length);
+}
+
+static uint32_t crc32c_engine_slice16(uint32_t state, const uint8_t *p, size_t length)
+{
+    return crc_slice16((const uint32_t (*)[256])crc32c_tables, state, p, length);
+}
+#endif
+
+#if defined(VAL_CRC32_HW_X86)
+// Best software engine, used for the short tail of the folding engine.
+static uint32_t crc32_engine_sw(uint32_t state, const uint8_t *p, size_t length)
+{
+#if VAL_CRC32_SLICE_TABLES >= 8
+    return crc32_engine_slice8(state, p, length);
+#else
+    return crc32_engine_bytewise(state, p, length);
+#endif
+}
+
+// Build a 128-bit lane from two 64-bit folding constants without 64-bit set intrinsics (i386).
+#define VAL_CRC32_K128(lo, hi)                                                                  \
+    _mm_set_epi32((int)(uint32_t)((uint64_t)(hi) >> 32), (int)(uint32_t)(hi),                  \
+                  (int)(uint32_t)((uint64_t)(lo) >> 32), (int)(uint32_t)(lo))
+
+// Carry-less multiply folding ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ",
+// Intel 2009) for the reflected IEEE polynomial. Requires length >= 64 and a multiple of 16;
+// takes and returns the raw running state.
+static VAL_CRC32_TARGET_CLMUL uint32_t crc32_pclmul_fold(uint32_t state, const uint8_t *p, size_t length)
+{
+    const __m128i k1k2 = VAL_CRC32_K128(0x0154442bd4ull, 0x01c6e41596ull);
+    const __m128i k3k4 = VAL_CRC32_K128(0x01751997d0ull, 0x00ccaa009eull);
+    const __m128i k5k0 = VAL_CRC32_K128(0x0163cd6124ull, 0x0000000000ull);
+    const __m128i poly = VAL_CRC32_K128(0x01db710641ull, 0x01f7011641ull);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)state));
+    p += 64;
+    length -= 64;
+
+    // Fold four 128-bit lanes in parallel while 64-byte blocks remain
+    while (length >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(p + 0x30)));
+        p += 64;
+        length -= 64;
+    }
+
+    // Fold the four lanes into one
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Single-lane fold of remaining 16-byte blocks
+    while (length >= 16)
+    {
+        x2 = _mm_loadu_si128((const __m128i *)p);
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        p += 16;
+        length -= 16;
+    }
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t crc32_engine_hw(uint32_t state, const uint8_t *p, size_t length)
+{
+    if (length >= 64)
+    {
+        size_t bulk = length & ~(size_t)15;
+        state = crc32_pclmul_fold(state, p, bulk);
+        p += bulk;
+        length -= bulk;
+    }
+    return crc32_engine_sw(state, p, length);
+}
+
+// SSE4.2 CRC32 instruction implements the reflected Castagnoli polynomial on the raw state.
+static VAL_CRC32_TARGET_SSE42 uint32_t crc32c_engine_hw(uint32_t state, const uint8_t *p, size_t length)
+{
+    uint32_t c = state;
+    while (length && ((uintptr_t)p & 7u))
+    {
+        c = _mm_crc32_u8(c, *p++);
+        --length;
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t c64 = c;
+    while (length >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c64 = _mm_crc32_u64(c64, v);
+        p += 8;
+        length -= 8;
+    }
+    c = (uint32_t)c64;
+#endif
+    while (length >= 4)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        c = _mm_crc32_u32(c, v);
+        p += 4;
+        length -= 4;
+    }
+    while (length--)
+        c = _mm_crc32_u8(c, *p++);
+    return c;
+}
+
+// Bit 0: IEEE engine usable (PCLMULQDQ + SSE4.1), bit 1: CRC32C engine usable (SSE4.2)
+static int crc32_hw_available(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 1);
+    unsigned int ecx = (unsigned int)info[2];
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+#endif
+    // ECX bit 1: PCLMULQDQ, bit 19: SSE4.1, bit 20: SSE4.2
+    int mask = 0;
+    if ((ecx & (1u << 1)) && (ecx & (1u << 19)))
+        mask |= 1;
+    if (ecx & (1u << 20))
+        mask |= 2;
+    return mask;
+}
+#elif defined(VAL_CRC32_HW_ARM64)
+// ARMv8 CRC32/CRC32C instructions implement both reflected polynomials on the raw state directly.
+#define VAL_CRC32_ARM64_ENGINE(name, op_b, op_d)                                                  \
+    static VAL_CRC32_TARGET_CRC uint32_t name(uint32_t state, const uint8_t *p, size_t length)  \
+    {                                                                                            \
+        uint32_t c = state;                                                                      \
+        while (length && ((uintptr_t)p & 7u))                                                    \
+        {                                                                                        \
+            c = op_b(c, *p++);                                                                   \
+            --length;                                                                            \
+        }                                                                                        \
+        while (length >= 8)                                                                      \
+        {                                                                                        \
+            uint64_t v;                                                                          \
+            memcpy(&v, p, 8);                                                                    \
+            c = op_d(c, v);                                                                      \
+            p += 8;                                                                              \
+            length -= 8;                                                                         \
+        }                                                                                        \
+        while (length--)                                                                         \
+            c = op_b(c, *p++);                                                                   \
+        return c;                                                                                \
+    }
+
+VAL_CRC32_ARM64_ENGINE(crc32_engine_hw, __crc32b, __crc32d)
+VAL_CRC32_ARM64_ENGINE(crc32c_engine_hw, __crc32cb, __crc32cd)
+
+static int crc32_hw_available(void)
+{
+#if defined(__ARM_FEATURE_CRC32)
+    return 3;
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) ? 3 : 0;
+#endif
+}
+#endif
+
+#if defined(VAL_CRC32_HW_X86) || defined(VAL_CRC32_HW_ARM64)
+static int crc32_hw_probed = 0;
+static int crc32_hw_mask = 0;
+
+static int crc32_hw_supported(int castagnoli)
+{
+    if (!crc32_hw_probed)
+    {
+        crc32_hw_mask = crc32_hw_available();
+        crc32_hw_probed = 1;
+    }
+    return (crc32_hw_mask & (castagnoli ? 2 : 1)) ? 1 : 0;
+}
+#endif
+
+// Map an implementation id to its engine for one polynomial; returns NULL if it is not compiled in
+// (or, for the hardware engine, not supported by the running CPU).
+static val_crc32_engine_fn crc32_engine_for(val_crc32_impl_t impl, int castagnoli)
+{
+    switch (impl)
+    {
+#if defined(VAL_CRC32_HW_X86) || defined(VAL_CRC32_HW_ARM64)
+    case VAL_CRC32_IMPL_HW:
+        if (!crc32_hw_supported(castagnoli))
+            return NULL;
+        return castagnoli ? crc32c_engine_hw : crc32_engine_hw;
+#endif
+    case VAL_CRC32_IMPL_BYTEWISE:
+        return castagnoli ? crc32c_engine_bytewise : crc32_engine_bytewise;
+#if VAL_CRC32_SLICE_TABLES >= 8
+    case VAL_CRC32_IMPL_SLICE8:
+        return castagnoli ? crc32c_engine_slice8 : crc32_engine_slice8;
+#endif
+#if VAL_CRC32_SLICE_TABLES >= 16
+    case VAL_CRC32_IMPL_SLICE16:
+        return castagnoli ? crc32c_engine_slice16 : crc32_engine_slice16;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static val_crc32_impl_t crc32_best_sw_impl(void)
+{
+#if VAL_CRC32_SLICE_TABLES >= 16
+    return VAL_CRC32_IMPL_SLICE16;
+#elif VAL_CRC32_SLICE_TABLES >= 8
+    return VAL_CRC32_IMPL_SLICE8;
+#else
+    return VAL_CRC32_IMPL_BYTEWISE;
+#endif
+}
+
+static val_crc32_impl_t crc32_best_impl(void)
+{
+#if defined(VAL_CRC32_HW_X86) || defined(VAL_CRC32_HW_ARM64)
+    if (crc32_hw_supported(0))
+        return VAL_CRC32_IMPL_HW;
+#endif
+    return crc32_best_sw_impl();
+}
+
+// Bind both polynomials to the selected family. The IEEE engine must exist; CRC32C falls back to
+// the best software engine when the CPU only accelerates IEEE (e.g. PCLMULQDQ without SSE4.2).
+static val_status_t crc32_bind(val_crc32_impl_t impl)
+{
+    val_crc32_engine_fn fn = crc32_engine_for(impl, 0);
+    if (!fn)
+        return VAL_ERR_INVALID_ARG;
+    val_crc32_engine_fn fnc = crc32_engine_for(impl, 1);
+    if (!fnc)
+        fnc = crc32_engine_for(crc32_best_sw_impl(), 1);
+    crc32_impl = impl;
+    crc32_engine = fn;
+    crc32c_engine = fnc;
+    return VAL_OK;
+}
+
+static void crc32_ensure_engines(void)
+{
+    if (!crc32_engine)
+    {
+        crc32_init_table();
+        (void)crc32_bind(crc32_impl == VAL_CRC32_IMPL_AUTO ? crc32_best_impl() : crc32_impl);
+    }
+}
+
+val_status_t val_crc32_set_impl(val_crc32_impl_t impl)
+{
+    crc32_init_table();
+    if (impl == VAL_CRC32_IMPL_AUTO)
+        impl = crc32_best_impl();
+    return crc32_bind(impl);
+}
+
+val_crc32_impl_t val_crc32_get_impl(void)
+{
+    crc32_ensure_engines();
+    return crc32_impl;
+}
+
+uint32_t val_crc32(const void *data, size_t length)
+{
+    crc32_ensure_engines();
+    return crc32_engine(0xFFFFFFFFu, (const uint8_t *)data, length) ^ 0xFFFFFFFFu;
+}
+
+uint32_t val_crc32_init_state(void)
+{
+    crc32_ensure_engines();
+    return 0xFFFFFFFFu;
+}
+
+uint32_t val_crc32_update_state(uint32_t state, const void *data, size_t length)
+{
+    crc32_ensure_engines();
+    return crc32_engine(state, (const uint8_t *)data, length);
+}
+
+uint32_t val_crc32_finalize_state(uint32_t state)
+{
+    return state ^ 0xFFFFFFFFu;
+}
+
+uint32_t val_crc32c(const void *data, size_t length)
+{
+    crc32_ensure_engines();
+    return crc32c_engine(0xFFFFFFFFu, (const uint8_t *)data, length) ^ 0xFFFFFFFFu;
+}
+
+uint32_t val_crc32c_update_state(uint32_t state, const void *data, size_t length)
+{
+    crc32_ensure_engines();
+    return crc32c_engine(state, (const uint8_t *)data, length);
+}
+
+// CRC combination: crc(A || B) = (crc(A) * x^(8*|B|) mod P) ^ crc(B). The init/final XOR terms
+// cancel out, so this holds for the finalized values returned by val_crc32()/val_crc32c() and
+// costs O(log |B|) carry-less multiplies without touching the data.
+uint32_t val_crc32_combine_gen(int castagnoli, uint64_t len_b)
+{
+    crc32_init_table();
+    const uint32_t *x2n = castagnoli ? crc32c_x2n_table : crc32_x2n_table;
+    uint32_t poly = castagnoli ? VAL_CRC32C_POLY_REFLECTED : VAL_CRC32_POLY_REFLECTED;
+    uint32_t p = 1u << 31; // x^0
+    unsigned k = 0;
+    while (len_b)
+    {
+        if (len_b & 1u)
+            p = crc_multmodp(poly, x2n[k], p);
+        len_b >>= 1;
+        k++;
+    }
+    return p;
+}
+
+uint32_t val_crc32_combine_op(int castagnoli, uint32_t crc_a, uint32_t crc_b, uint32_t op)
+{
+    return crc_multmodp(castagnoli ? VAL_CRC32C_POLY_REFLECTED : VAL_CRC32_POLY_REFLECTED, op, crc_a) ^ crc_b;
+}
+
+uint32_t val_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b)
+{
+    return val_crc32_combine_op(0, crc_a, crc_b, val_crc32_combine_gen(0, len_b));
+}
+
+uint32_t val_crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b)
+{
+    return val_crc32_combine_op(1, crc_a, crc_b, val_crc32_combine_gen(1, len_b));
+}
@@ -94,6 +94,53 @@ typedef struct
     uint8_t in_retransmit;   // Karn's algorithm flag (do not sample when set)
 } val_timing_t;
 
+// Congestion controller state (val_cc.c). Windows are in 1/VAL_CC_FP_ONE packet units so sub-packet
+// growth per ACK accumulates.
+#define VAL_CC_FP_SHIFT 10u
+#define VAL_CC_FP_ONE (1u << VAL_CC_FP_SHIFT)
+// Largest window the fixed-point controllers can hold; negotiated windows are clamped to it
+#define VAL_WINDOW_MAX_PACKETS (0xFFFFFFFFu >> VAL_CC_FP_SHIFT)
+typedef struct
+{
+    uint32_t ssthresh;          // slow start threshold (packets)
+    uint32_t w_max_fp;          // window just before the last reduction
+    uint32_t origin_fp;         // plateau of the current cubic epoch
+    uint32_t w_est_fp;          // Reno-friendly estimate (never grow slower than AIMD would)
+    uint32_t k_ms;              // time from epoch start to reach origin_fp
+    uint32_t epoch_start_ms;    // ticks when the current growth epoch began
+    uint32_t last_reduction_ms; // ticks of the last multiplicative decrease (one per RTT)
+    uint8_t epoch_valid;
+    uint8_t reduced; // last_reduction_ms is meaningful
+} val_cc_cubic_state_t;
+// BBR: delivery-rate samples (one per round trip) kept for the windowed max bandwidth filter
+#define VAL_BBR_BW_ROUNDS 10u
+typedef struct
+{
+    uint32_t bw_fp[VAL_BBR_BW_ROUNDS]; // delivery rate per round (packets/s, fixed point)
+    uint32_t delivered;                // packets acknowledged so far
+    uint32_t round_end_delivered;      // delivered count that completes the current round
+    uint32_t round_start_delivered;
+    uint32_t round_start_ms;
+    uint32_t rounds;
+    uint32_t min_rtt_ms; // 0 = no sample yet
+    uint32_t min_rtt_stamp_ms;
+    uint32_t probe_rtt_done_ms;
+    uint32_t full_bw_fp; // STARTUP plateau detection
+    uint8_t full_bw_rounds;
+    uint8_t filled_pipe;
+    uint8_t mode;        // VAL_BBR_* (val_cc.c)
+    uint8_t cycle_index; // PROBE_BW gain cycle position
+} val_cc_bbr_state_t;
+typedef struct
+{
+    uint32_t cwnd_fp; // current window
+    union
+    {
+        val_cc_cubic_state_t cubic;
+        val_cc_bbr_state_t bbr;
+    } u;
+} val_cc_state_t;
+
 struct val_session_s
 {
     val_config_t cfg;
@@ -103,15 +150,63 @@ struct val_session_s
     size_t effective_packet_size; // negotiated packet size after handshake
     bool handshake_done;          // handshake completed once per session
     uint32_t peer_features;       // features advertised by peer during handshake
+    uint32_t negotiated_features; // optional features active for this session (both sides agree)
+    // CRC combine operator cache (x^(8*len) mod P for the last length; DATA payloads repeat lengths)
+    uint64_t crc_combine_len;
+    uint32_t crc_combine_op; // 0 = empty (the operator is never zero)
+    uint8_t crc_combine_c;   // operator belongs to CRC32C
+    // Read-ahead (transport.recv_some): bytes [rx_ra_head, rx_ra_tail) of rx_ra_buf arrived but are not parsed yet
+    uint8_t *rx_ra_buf;
+    size_t rx_ra_cap;
+    size_t rx_ra_head;
+    size_t rx_ra_tail;
+    // Receiver: CRC of the last DATA payload, derived from its verified frame trailer
+    uint32_t rx_data_crc;
+    // Receiver: frame flags of the last DATA packet (VAL_DATA_ACK_NOW drives the delayed-ACK policy)
+    uint8_t rx_data_flags;
+    // Receiver: type_data of the last DATA packet (low 32 bits of an implied offset under VAL_DATA_OFFSET_HINT)
+    uint32_t rx_data_offset_hint;
+    // Sender: extra flags OR'd into outgoing DATA frames (VAL_DATA_ACK_NOW on the last frame before an ACK wait)
+    uint8_t tx_data_flags;
+    // Receiver: last known CRC of a local file region (resume tail or bytes received this session),
+    // reused for VERIFY and later tail checks instead of re-reading the file
+    struct
+    {
+        bool valid;
+        uint64_t start;
+        uint64_t length;
+        uint32_t crc;
+        char path[512];
+    } rx_region_crc;
     val_timing_t timing;
     // last error info
     val_error_t last_error;
     // --- Bounded-window flow control state ---
     // Negotiated caps and dynamic window
-    uint16_t negotiated_window_packets; // min(local desired_tx, peer rx_max)
-    uint16_t current_window_packets;    // dynamic window used by sender (AIMD-tuned)
-    uint16_t peer_tx_window_packets;    // best-effort: peer's tx cap from HELLO (for observability)
+    uint32_t negotiated_window_packets; // min(local desired_tx, peer rx_max, byte cap / packet size)
+    uint32_t negotiated_window_bytes;   // min(local, peer) byte cap ignoring zeros; 0 = none
+    uint32_t current_window_packets;    // initial cwnd from HELLO adopt; AIMD's window (see val_internal_cc_cwnd)
+    uint32_t peer_tx_window_packets;    // best-effort: peer's tx cap from HELLO (for observability)
     uint16_t ack_stride_packets;        // receiver's preferred ACK cadence (0 => window)
+    // Sender congestion controller (selected by tx_flow.congestion_control at session create)
+    const struct val_cc_ops_s *cc_ops;
+    val_cc_state_t cc;
+    // Sender pacing token bucket (bytes), refilled at the pacing rate; last_us is on the pacing clock
+    // (system.get_ticks_us, or get_ticks_ms x 1000)
+    struct
+    {
+        uint64_t tokens;
+        uint32_t last_us;
+    } pacing;
+    // Sender fast retransmit (Go-Back-N): duplicate DATA_ACKs seen at the cumulative offset, and where and
+    // when the last NAK/duplicate-ACK rewind happened so frames still in flight behind the same loss do not
+    // rewind the window again
+    struct
+    {
+        uint64_t rewind_at;
+        uint32_t rewind_ms;
+        uint8_t dupacks;
+    } fast_rexmit;
     // Performance counters
     uint32_t consecutive_errors;
     uint32_t consecutive_successes;
@@ -120,9 +215,16 @@ struct val_session_s
     uint32_t packets_in_flight;
     uint32_t next_seq_to_send;
     uint32_t oldest_unacked_seq;
-    // In-flight packet tracking array (allocated at session create)
+    // In-flight packet tracking array (per-packet RTT samples and selective repeat). Allocated at session
+    // create for up to VAL_TRACKING_SLOTS_INITIAL packets and grown by the sender, through tx_flow.allocator,
+    // as the window opens (never beyond negotiated_window_packets).
     struct val_inflight_packet_s *tracking_slots;
     uint32_t max_tracking_slots;
+    uint32_t tracking_next;  // where the next free-slot search starts (slots are taken round robin)
+    uint64_t tracking_high;  // no tracked packet ends beyond this offset (fresh sends cannot overlap a slot)
+    // Receiver reorder store metadata (allocated at session create when buffers.rx_reorder_buffer is set)
+    struct val_rx_reorder_slot_s *rx_reorder;
+    uint32_t rx_reorder_slots;
     // File state for retransmissions (sender side)
     void *current_file_handle;
     uint64_t current_file_position;
@@ -158,9 +260,31 @@ typedef struct val_inflight_packet_s
     uint32_t payload_length; // data length
     uint32_t send_timestamp; // ticks at send
     uint8_t retransmit_count;
-    uint8_t state; // 0=SENT,1=ACKED,2=TIMEOUT
+    uint8_t state; // VAL_SLOT_*
 } val_inflight_packet_t;
 
+#define VAL_SLOT_FREE 0u   // unused (or cumulatively acknowledged)
+#define VAL_SLOT_SENT 1u   // outstanding, not known to be received
+#define VAL_SLOT_SACKED 2u // reported received out of order (receiver holds it)
+
+// Selective repeat: at most this many SACK blocks follow the high32 word in a DATA_ACK. Each block is
+// [start - ack_offset : u32][length : u32], lowest offsets first.
+#define VAL_SACK_MAX_BLOCKS 4u
+
+// Delayed ACKs: default most in-order DATA packets per DATA_ACK (tx_flow.ack_stride_packets == 0)
+#define VAL_ACK_STRIDE_DEFAULT 8u
+// Tracking slots allocated at session create; more are allocated as the window grows past them
+#define VAL_TRACKING_SLOTS_INITIAL 64u
+
+// Receiver reorder slot (payload lives in buffers.rx_reorder_buffer at index * packet_size)
+typedef struct val_rx_reorder_slot_s
+{
+    uint64_t offset;
+    uint32_t length;
+    uint32_t crc; // payload CRC from the verified frame
+    uint8_t used;
+} val_rx_reorder_slot_t;
+
 // (Legacy transmission mode helpers removed in 0.7)
 
 // Mode synchronization payloads
@@ -240,11 +364,26 @@ int val_internal_send_packet(val_session_t *s, val_packet_type_t type, const voi
                              uint64_t offset);
 // Extended variant: for VAL_PKT_DATA, include_data_offset controls whether to include the explicit 8-byte offset
 // in the frame content and set VAL_DATA_OFFSET_PRESENT. Ignored for other packet types. When not included, the
-// receiver must treat the DATA packet as having an implied offset equal to its current next-expected position.
+// frame carries VAL_DATA_OFFSET_HINT with the offset's low 32 bits in type_data, and the receiver places it
+// relative to its next-expected position (a peer without the hint implies exactly that position).
 int val_internal_send_packet_ex(val_session_t *s, val_packet_type_t type, const void *payload, uint32_t payload_len,
                                 uint64_t offset, int include_data_offset);
+// DATA frame whose payload is [offset, offset + payload_len) of the open source 'file', moved by
+// transport.send_file; 'view' maps the same bytes and is only read for the trailer CRC
+int val_internal_send_data_file(val_session_t *s, void *file, const void *view, uint32_t payload_len, uint64_t offset,
+                                int include_data_offset);
 int val_internal_recv_packet(val_session_t *s, val_packet_type_t *type, void *payload_out, uint32_t payload_cap,
                              uint32_t *payload_len_out, uint64_t *offset_out, uint32_t timeout_ms);
+// Batched DATA: a frame built in place in a caller buffer has its payload at
+// frame + val_internal_data_frame_prefix(); val_internal_seal_data_frame writes header, offset prefix
+// and trailer around it and returns the frame length. val_internal_send_data_batch hands 'count'
+// such frames, back to back, to the transport in one send call; first_offset is the file offset of
+// the first frame (needed for capture when its offset is implied).
+size_t val_internal_data_frame_prefix(val_session_t *s, uint32_t payload_len, int include_data_offset);
+size_t val_internal_seal_data_frame(val_session_t *s, uint8_t *frame, uint32_t payload_len, uint64_t offset,
+                                    int include_data_offset);
+int val_internal_send_data_batch(val_session_t *s, const uint8_t *frames, size_t len, uint32_t count,
+                                 uint64_t first_offset);
 
 // Micro-poll until a packet arrives or the absolute deadline passes, slicing waits to remain cancel-responsive.
 // Returns VAL_OK and fills out_type/len/off on packet; VAL_ERR_TIMEOUT when deadline elapses; VAL_ERR_ABORTED on cancel;
@@ -281,6 +420,10 @@ val_status_t val_internal_wait_control(val_session_t *s,
 
 // Centralized control ACK waits
 val_status_t val_internal_wait_done_ack(val_session_t *s, uint64_t file_size);
+// DONE_ACK wait with the next file announced or EOT sent behind the DONE (VAL_FEAT_PIPELINE): also accepts
+// RESUME_RESP (payload into resp, VAL_WIRE_RESUME_RESP_SIZE bytes) or EOT_ACK; *out_type says which arrived.
+val_status_t val_internal_wait_done_ack_pipelined(val_session_t *s, uint64_t file_size, val_packet_type_t *out_type,
+                                                  uint8_t *resp, uint32_t *resp_len);
 val_status_t val_internal_wait_eot_ack(val_session_t *s);
 
 // Centralized VERIFY result wait with resend-on-timeout. Caller should have already
@@ -630,8 +773,22 @@ uint32_t val_crc32_init_state(void);
 uint32_t val_crc32_update_state(uint32_t state, const void *data, size_t length);
 uint32_t val_crc32_finalize_state(uint32_t state);
 
+uint32_t val_crc32c_update_state(uint32_t state, const void *data, size_t length);
+// Combine primitives: op = val_crc32_combine_gen(c, len_b); crc(A||B) = val_crc32_combine_op(c, crc(A), crc(B), op).
+// The same call with crc(A||B) in place of crc(B) yields crc(B), i.e. strips a known prefix.
+uint32_t val_crc32_combine_gen(int castagnoli, uint64_t len_b);
+uint32_t val_crc32_combine_op(int castagnoli, uint32_t crc_a, uint32_t crc_b, uint32_t op);
+
 // Session-aware CRC adapter (prefer user provider if present)
 uint32_t val_internal_crc32(val_session_t *s, const void *data, size_t length);
+// Session-aware incremental update: CRC32C when negotiated, else IEEE (provider if present).
+// Use with val_crc32_init_state()/val_crc32_finalize_state() for resume/verify CRCs.
+uint32_t val_internal_crc32_update_state(val_session_t *s, uint32_t state, const void *data, size_t length);
+// Frame trailer CRC: HELLO always uses IEEE CRC32 (negotiation not yet known), other frames follow
+// the negotiated algorithm.
+uint32_t val_internal_frame_crc32(val_session_t *s, uint8_t type, const void *data, size_t length);
+// crc(A||B) from crc(A), crc(B), |B| using the session's algorithm (operator cached per length).
+uint32_t val_internal_crc32_combine(val_session_t *s, uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
 
 // Compute CRC32 over a file region using the session's configured filesystem and recv buffer.
 // Reads [start_offset, start_offset+length) from the given open file handle in chunk sizes based
@@ -640,7 +797,35 @@ uint32_t val_internal_crc32(val_session_t *s, const void *data, size_t length);
 val_status_t val_internal_crc32_region(val_session_t *s, void *file_handle, uint64_t start_offset,
                                        uint64_t length, uint32_t *out_crc);
 
-// Adaptive transmission mode management
+// Frame header size for content up to content_max bytes: VAL_WIRE_EXT_HEADER_SIZE when that does
+// not fit the 16-bit length and VAL_FEAT_EXT_LEN is negotiated, else VAL_WIRE_HEADER_SIZE.
+size_t val_internal_frame_header_size(val_session_t *s, size_t content_max);
+
+// Congestion control module: the sender reports ACK progress, loss events and RTT samples; the module
+// owns the window and answers cwnd queries. init runs when HELLO is adopted, with current_window_packets
+// holding the initial cwnd and negotiated_window_packets the cap.
+typedef struct val_cc_ops_s
+{
+    const char *name;
+    void (*init)(val_session_t *s);
+    void (*on_ack)(val_session_t *s, uint32_t acked_packets);
+    void (*on_loss)(val_session_t *s);
+    void (*on_rtt_sample)(val_session_t *s, uint32_t rtt_ms);
+    uint32_t (*cwnd)(const val_session_t *s);
+    // Optional: bytes per second the sender should pace DATA at (0 = send the window back to back)
+    uint32_t (*pacing_rate)(const val_session_t *s);
+} val_cc_ops_t;
+
+// Module for a val_congestion_control_t value; NULL if unknown.
+const val_cc_ops_t *val_cc_lookup(uint8_t algorithm);
+void val_internal_cc_init(val_session_t *s);
+void val_internal_cc_on_ack(val_session_t *s, uint32_t acked_packets);
+// Sender window in packets, within [1, negotiated_window_packets]
+uint32_t val_internal_cc_cwnd(const val_session_t *s);
+// Controller pacing rate in bytes per second; 0 = unpaced
+uint32_t val_internal_cc_pacing_rate(const val_session_t *s);
+
+// Adaptive transmission mode management: error = loss event, success = one ACK of progress
 void val_internal_record_transmission_error(val_session_t *s);
 void val_internal_record_transmission_success(val_session_t *s);
 
@@ -64,6 +64,507 @@ static inline uint64_t clamp_u64(uint64_t v, uint64_t lo, uint64_t hi)
     return (v < lo) ? lo : (v > hi ? hi : v);
 }
 
+// --- Write-behind (buffers.rx_writebehind_buffer) ---
+// In-order DATA is copied into the staging chunk; a full chunk is written with one fwrite, or submitted with
+// filesystem.write_submit and reaped (oldest first) when its slot is needed again, when an ACK must cover it
+// (VAL_ACK_ON_WRITE) or at DONE. 'durable' is the file offset up to which writes have completed.
+// With filesystem.map the output file is mapped writable instead and the buffer is only a fallback: in-order
+// payloads are received straight into the mapping and nothing is copied or written.
+#define VAL_RX_WB_MAX_CHUNKS 8u
+
+typedef struct
+{
+    val_session_t *session;
+    void *file;
+    uint8_t *base;
+    uint32_t chunk_len;
+    uint32_t nchunks; // 0 = write-behind off: every payload is written at once
+    uint32_t head;    // oldest submitted chunk
+    uint32_t count;   // submitted chunks not yet reaped (async only)
+    uint32_t fill;    // bytes staged in chunk (head + count) % nchunks
+    uint32_t len[VAL_RX_WB_MAX_CHUNKS];
+    uint64_t staged_at; // file offset of the first staged byte
+    uint64_t durable;
+    uint64_t acked; // cumulative offset of the last DATA_ACK sent
+    int async;      // filesystem.write_submit/write_wait in use
+    int on_write;   // VAL_ACK_ON_WRITE
+    int failed;     // a write came up short; DISK_FULL has been recorded
+    int mapped;     // filesystem.map in use for this file
+    uint8_t *map;   // writable mapping of [map_off, map_off + map_len); NULL = none
+    uint64_t map_off;
+    size_t map_len;
+    uint64_t total; // file size: mappings never extend the file past it
+} val_rx_wb_t;
+
+static void rx_wb_init(val_rx_wb_t *wb, val_session_t *s, void *f, uint64_t start, uint64_t total)
+{
+    const val_config_t *cfg = s->config;
+    memset(wb, 0, sizeof(*wb));
+    wb->session = s;
+    wb->file = f;
+    wb->staged_at = wb->durable = wb->acked = start;
+    wb->total = total;
+    wb->on_write = (cfg->tx_flow.ack_policy == VAL_ACK_ON_WRITE) ? 1 : 0;
+    wb->mapped = (cfg->filesystem.map && f && start < total) ? 1 : 0;
+    size_t size = cfg->buffers.rx_writebehind_buffer ? cfg->buffers.rx_writebehind_size : 0u;
+    size_t payload = cfg->buffers.packet_size;
+    if (size < 2u * payload)
+        return;
+    size_t chunk = size / VAL_RX_WB_MAX_CHUNKS;
+    if (chunk < payload)
+        chunk = payload;
+    if (chunk > 0xFFFFFFFFu)
+        chunk = 0xFFFFFFFFu;
+    wb->base = (uint8_t *)cfg->buffers.rx_writebehind_buffer;
+    wb->chunk_len = (uint32_t)chunk;
+    wb->nchunks = (uint32_t)(size / chunk);
+    if (wb->nchunks > VAL_RX_WB_MAX_CHUNKS)
+        wb->nchunks = VAL_RX_WB_MAX_CHUNKS;
+    wb->async = (cfg->filesystem.write_submit && cfg->filesystem.write_wait) ? 1 : 0;
+}
+
+// Write at 'offset', the next byte of the file: filesystem.pwrite when provided, else fwrite
+static size_t rx_write_at(const val_config_t *cfg, void *file, const uint8_t *data, size_t len, uint64_t offset)
+{
+    if (cfg->filesystem.pwrite)
+        return cfg->filesystem.pwrite(cfg->filesystem.fs_context, file, data, len, offset);
+    return cfg->filesystem.fwrite(cfg->filesystem.fs_context, data, 1, len, file);
+}
+
+static uint8_t *rx_wb_buf(val_rx_wb_t *wb, uint32_t i)
+{
+    return wb->base + (size_t)i * wb->chunk_len;
+}
+
+static val_status_t rx_wb_fail(val_rx_wb_t *wb, uint64_t at)
+{
+    (void)at;
+    VAL_LOG_WARNF(wb->session, "writebehind: write failed at %llu", (unsigned long long)at);
+    wb->failed = 1;
+    val_internal_set_error_detailed(wb->session, VAL_ERR_IO, VAL_ERROR_DETAIL_DISK_FULL);
+    return VAL_ERR_IO;
+}
+
+// Reap completed async writes, blocking while more than 'keep' are outstanding
+static val_status_t rx_wb_reap(val_rx_wb_t *wb, uint32_t keep)
+{
+    const val_config_t *cfg = wb->session->config;
+    while (wb->count)
+    {
+        size_t done = 0;
+        int r = cfg->filesystem.write_wait(cfg->filesystem.fs_context, wb->file, rx_wb_buf(wb, wb->head), &done,
+                                           wb->count > keep);
+        if (r == 1)
+            break;
+        if (r < 0 || done != wb->len[wb->head])
+            return rx_wb_fail(wb, wb->durable);
+        wb->durable += wb->len[wb->head];
+        wb->head = (wb->head + 1u) % wb->nchunks;
+        wb->count--;
+    }
+    return VAL_OK;
+}
+
+// Write out the staging chunk (submit it when async, keeping a free slot to stage into)
+static val_status_t rx_wb_submit(val_rx_wb_t *wb)
+{
+    const val_config_t *cfg = wb->session->config;
+    if (!wb->fill)
+        return VAL_OK;
+    uint32_t i = (wb->head + wb->count) % wb->nchunks;
+    if (wb->async)
+    {
+        wb->len[i] = wb->fill;
+        if (cfg->filesystem.write_submit(cfg->filesystem.fs_context, wb->file, wb->staged_at, rx_wb_buf(wb, i),
+                                         wb->fill) < 0)
+            return rx_wb_fail(wb, wb->staged_at);
+        wb->count++;
+        wb->staged_at += wb->fill;
+        wb->fill = 0;
+        return rx_wb_reap(wb, wb->nchunks - 1u);
+    }
+    size_t w = rx_write_at(cfg, wb->file, rx_wb_buf(wb, i), wb->fill, wb->staged_at);
+    if (w != wb->fill)
+        return rx_wb_fail(wb, wb->staged_at);
+    wb->staged_at += wb->fill;
+    wb->durable = wb->staged_at;
+    wb->fill = 0;
+    return VAL_OK;
+}
+
+// Release the output mapping, trimming the file to what was written; a failed write-back is a full disk
+static val_status_t rx_map_release(val_rx_wb_t *wb)
+{
+    const val_config_t *cfg = wb->session->config;
+    if (!wb->map)
+        return VAL_OK;
+    size_t valid = (size_t)(wb->durable - wb->map_off);
+    int r = cfg->filesystem.unmap(cfg->filesystem.fs_context, wb->file, wb->map, wb->map_off, wb->map_len, valid);
+    wb->map = NULL;
+    return (r < 0) ? rx_wb_fail(wb, wb->map_off) : VAL_OK;
+}
+
+// Map the window holding 'durable' with at least 'room' bytes after it (or the rest of the file). The first
+// mapping of a file may be refused: its data is then written as usual. Later refusals fail the file.
+static val_status_t rx_map_window(val_rx_wb_t *wb, size_t room)
+{
+    const val_config_t *cfg = wb->session->config;
+    uint64_t rest = wb->total - wb->durable;
+    if ((uint64_t)room > rest)
+        room = (size_t)rest;
+    if (wb->map && wb->durable + room <= wb->map_off + wb->map_len)
+        return VAL_OK;
+    int first = !wb->map_len;
+    if (rx_map_release(wb) != VAL_OK)
+        return VAL_ERR_IO;
+    uint64_t base = wb->durable - (wb->durable % VAL_MAP_ALIGN);
+    uint64_t span = wb->total - base;
+    if (span > VAL_MAP_SPAN)
+        span = VAL_MAP_SPAN;
+    wb->map = (uint8_t *)cfg->filesystem.map(cfg->filesystem.fs_context, wb->file, base, (size_t)span, true);
+    if (!wb->map)
+    {
+        if (first)
+        {
+            VAL_LOG_INFO(wb->session, "map: cannot map output, writing instead");
+            wb->mapped = 0;
+            return VAL_OK;
+        }
+        return rx_wb_fail(wb, base);
+    }
+    wb->map_off = base;
+    wb->map_len = (size_t)span;
+    return VAL_OK;
+}
+
+// Where the next DATA payload should be received: in place at 'durable' in the output mapping when a
+// whole frame ('room' bytes) fits there, else 'fallback'
+static uint8_t *rx_wb_dst(val_rx_wb_t *wb, uint8_t *fallback, size_t room)
+{
+    if (!wb->mapped || wb->total - wb->durable < (uint64_t)room || rx_map_window(wb, room) != VAL_OK || !wb->map)
+        return fallback;
+    return wb->map + (size_t)(wb->durable - wb->map_off);
+}
+
+// Append the next in-order bytes of the file
+static val_status_t rx_wb_write(val_rx_wb_t *wb, const uint8_t *data, uint32_t len)
+{
+    while (wb->mapped && len)
+    {
+        if (wb->durable >= wb->total) // the mapping never grows the file past its announced size
+            return rx_wb_fail(wb, wb->durable);
+        if (rx_map_window(wb, 1) != VAL_OK)
+            return VAL_ERR_IO;
+        if (!wb->mapped)
+            break;
+        uint8_t *at = wb->map + (size_t)(wb->durable - wb->map_off);
+        size_t n = (size_t)(wb->map_off + wb->map_len - wb->durable);
+        if (n > len)
+            n = len;
+        if (data != at) // received in place: already there
+            memcpy(at, data, n);
+        wb->durable += n;
+        wb->staged_at = wb->durable;
+        data += n;
+        len -= (uint32_t)n;
+    }
+    if (!len)
+        return VAL_OK;
+    if (!wb->nchunks)
+    {
+        const val_config_t *cfg = wb->session->config;
+        if (rx_write_at(cfg, wb->file, data, len, wb->durable) != len)
+            return rx_wb_fail(wb, wb->durable);
+        wb->durable += len;
+        return VAL_OK;
+    }
+    while (len)
+    {
+        uint32_t n = wb->chunk_len - wb->fill;
+        if (n > len)
+            n = len;
+        memcpy(rx_wb_buf(wb, (wb->head + wb->count) % wb->nchunks) + wb->fill, data, n);
+        wb->fill += n;
+        data += n;
+        len -= n;
+        if (wb->fill == wb->chunk_len)
+        {
+            val_status_t st = rx_wb_submit(wb);
+            if (st != VAL_OK)
+                return st;
+        }
+    }
+    return VAL_OK;
+}
+
+// Write everything staged and wait until all of it is on the filesystem
+static val_status_t rx_wb_flush(val_rx_wb_t *wb)
+{
+    if (!wb->nchunks)
+        return VAL_OK;
+    val_status_t st = rx_wb_submit(wb);
+    return (st == VAL_OK) ? rx_wb_reap(wb, 0) : st;
+}
+
+// Close the output file once no async write still uses it or the buffer
+static void rx_wb_close(val_rx_wb_t *wb)
+{
+    const val_config_t *cfg = wb->session->config;
+    (void)rx_map_release(wb);
+    while (wb->count)
+    {
+        size_t done = 0;
+        (void)cfg->filesystem.write_wait(cfg->filesystem.fs_context, wb->file, rx_wb_buf(wb, wb->head), &done, true);
+        wb->head = (wb->head + 1u) % wb->nchunks;
+        wb->count--;
+    }
+    cfg->filesystem.fclose(cfg->filesystem.fs_context, wb->file);
+}
+
+// --- Selective-repeat reorder store (VAL_FEAT_SACK) ---
+// Out-of-order DATA is parked in buffers.rx_reorder_buffer (one packet_size slot each) and reported to
+// the sender as SACK blocks on every DATA_ACK; it is written once the gap before it has been filled.
+static int rx_reorder_store(val_session_t *s, uint64_t offset, const uint8_t *data, uint32_t len, uint32_t crc)
+{
+    val_rx_reorder_slot_t *free_slot = NULL;
+    for (uint32_t i = 0; i < s->rx_reorder_slots; ++i)
+    {
+        val_rx_reorder_slot_t *slot = &s->rx_reorder[i];
+        if (slot->used && slot->offset == offset)
+            return 1; // already held
+        if (!slot->used && !free_slot)
+            free_slot = slot;
+    }
+    if (!free_slot || len > s->config->buffers.packet_size)
+        return 0;
+    uint8_t *dst = (uint8_t *)s->config->buffers.rx_reorder_buffer +
+                   (size_t)(free_slot - s->rx_reorder) * s->config->buffers.packet_size;
+    memcpy(dst, data, len);
+    free_slot->offset = offset;
+    free_slot->length = len;
+    free_slot->crc = crc;
+    free_slot->used = 1;
+    return 1;
+}
+
+// Write every held slot that now continues the file at *written, folding each slot's CRC into *file_crc
+static val_status_t rx_reorder_drain(val_session_t *s, val_rx_wb_t *wb, uint64_t *written, uint32_t *file_crc)
+{
+    for (int found = 1; found;)
+    {
+        found = 0;
+        for (uint32_t i = 0; i < s->rx_reorder_slots; ++i)
+        {
+            val_rx_reorder_slot_t *slot = &s->rx_reorder[i];
+            if (!slot->used)
+                continue;
+            if (slot->offset < *written)
+            {
+                slot->used = 0; // superseded by an in-order copy
+                continue;
+            }
+            if (slot->offset != *written)
+                continue;
+            const uint8_t *src = (const uint8_t *)s->config->buffers.rx_reorder_buffer + (size_t)i * s->config->buffers.packet_size;
+            if (rx_wb_write(wb, src, slot->length) != VAL_OK)
+                return VAL_ERR_IO;
+            *file_crc = val_internal_crc32_combine(s, *file_crc, slot->crc, slot->length);
+            *written += slot->length;
+            slot->used = 0;
+            found = 1;
+        }
+    }
+    return VAL_OK;
+}
+
+// Cumulative DATA_ACK at 'ack', plus SACK blocks (lowest first, contiguous ranges merged) for data received
+// but not yet written when ack < written (VAL_ACK_ON_WRITE) and for held out-of-order ranges
+static val_status_t rx_send_data_ack(val_session_t *s, uint64_t ack, uint64_t written)
+{
+    uint8_t blocks[VAL_SACK_MAX_BLOCKS * 8u];
+    uint32_t nblocks = 0;
+    uint64_t floor = written;
+    uint64_t start = UINT64_MAX, end = 0;
+    if (ack < written)
+    {
+        start = ack;
+        end = written;
+    }
+    while (nblocks < VAL_SACK_MAX_BLOCKS)
+    {
+        // Next range: lowest held offset at or above 'floor', extended over contiguous slots
+        if (start == UINT64_MAX)
+        {
+            for (uint32_t i = 0; i < s->rx_reorder_slots; ++i)
+                if (s->rx_reorder[i].used && s->rx_reorder[i].offset >= floor && s->rx_reorder[i].offset < start)
+                    start = s->rx_reorder[i].offset;
+            end = start;
+        }
+        if (start == UINT64_MAX || start - ack > 0xFFFFFFFFull)
+            break;
+        for (int grown = 1; grown;)
+        {
+            grown = 0;
+            for (uint32_t i = 0; i < s->rx_reorder_slots; ++i)
+            {
+                if (s->rx_reorder[i].used && s->rx_reorder[i].offset == end)
+                {
+                    end += s->rx_reorder[i].length;
+                    grown = 1;
+                }
+            }
+        }
+        if (end - ack > 0xFFFFFFFFull)
+            break;
+        VAL_PUT_LE32(blocks + nblocks * 8u, (uint32_t)(start - ack));
+        VAL_PUT_LE32(blocks + nblocks * 8u + 4u, (uint32_t)(end - start));
+        ++nblocks;
+        floor = end + 1u;
+        start = UINT64_MAX;
+    }
+    return val_internal_send_packet(s, VAL_PKT_DATA_ACK, nblocks ? blocks : NULL, nblocks * 8u, ack);
+}
+
+// DATA_ACK under tx_flow.ack_policy. With VAL_ACK_ON_WRITE the cumulative offset is where completed writes
+// end: 'settle' first writes out everything received (ACKs the sender is waiting on, or that report a loss,
+// so they never sit below data already here); otherwise finished async writes are reaped and nothing is sent
+// unless that moved the offset (a repeated offset would read as a duplicate ACK). Write failures set
+// wb->failed and return VAL_ERR_IO.
+static val_status_t rx_ack(val_session_t *s, val_rx_wb_t *wb, uint64_t written, int settle)
+{
+    uint64_t ack = written;
+    if (wb->on_write && wb->nchunks)
+    {
+        val_status_t st = settle ? rx_wb_flush(wb) : (wb->async ? rx_wb_reap(wb, UINT32_MAX) : VAL_OK);
+        if (st != VAL_OK)
+            return st;
+        ack = wb->durable;
+        if (!settle && ack == wb->acked)
+            return VAL_OK;
+    }
+    wb->acked = ack;
+    return rx_send_data_ack(s, ack, written);
+}
+
+// Delayed-ACK timer: configured value, else a quarter of the smoothed RTT, bounded well below the
+// sender's minimum retransmission timeout so a held ACK never looks like a loss
+static uint32_t rx_ack_delay_ms(val_session_t *s)
+{
+    uint32_t cap = s->config->timeouts.min_timeout_ms ? s->config->timeouts.min_timeout_ms / 2u : 50u;
+    uint32_t d = s->config->tx_flow.ack_delay_ms;
+    if (!d)
+        d = s->timing.srtt_ms ? s->timing.srtt_ms / 4u : cap / 2u;
+    if (d > cap)
+        d = cap;
+    return d ? d : 1u;
+}
+
+// Gap NAK hold-off: after a NAK for a gap, further frames beyond the same gap are answered with at most
+// VAL_RX_GAP_DUPACKS duplicate ACKs until the retransmission has had a round trip to arrive
+#define VAL_RX_GAP_DUPACKS 3u
+static uint32_t rx_nak_holdoff_ms(val_session_t *s)
+{
+    uint32_t floor = s->config->timeouts.min_timeout_ms ? s->config->timeouts.min_timeout_ms / 2u : 50u;
+    uint32_t d = s->timing.srtt_ms ? 2u * s->timing.srtt_ms : floor;
+    return (d < floor) ? floor : d;
+}
+
+// Offset of an implied-offset DATA frame: its VAL_DATA_OFFSET_HINT low 32 bits placed nearest to the next
+// expected byte; without the hint (older sender) the frame is taken as the next expected one
+static uint64_t rx_implied_offset(val_session_t *s, uint64_t written)
+{
+    if (!(s->rx_data_flags & VAL_DATA_OFFSET_HINT))
+        return written;
+    uint64_t off = (written & ~0xFFFFFFFFull) | (uint64_t)s->rx_data_offset_hint;
+    if (off + 0x80000000ull < written)
+        off += 0x100000000ull;
+    else if (off > written + 0x80000000ull && off >= 0x100000000ull)
+        off -= 0x100000000ull;
+    return off;
+}
+
+// --- Region CRC cache ---
+// The receiver remembers the most recent CRC it knows for a local file region: the tail it hashed
+// for RESUME_RESP, or the bytes it received this session (derived per packet from frame trailers).
+// VERIFY and later tail checks reuse it, reading at most the part of a region not yet covered.
+static int rx_region_crc_lookup(val_session_t *s, const char *path, uint64_t start, uint64_t length, uint32_t *out_crc)
+{
+    if (!s->rx_region_crc.valid || s->rx_region_crc.start != start || s->rx_region_crc.length != length ||
+        strcmp(s->rx_region_crc.path, path) != 0)
+        return 0;
+    *out_crc = s->rx_region_crc.crc;
+    return 1;
+}
+
+static void rx_region_crc_store(val_session_t *s, const char *path, uint64_t start, uint64_t length, uint32_t crc)
+{
+    snprintf(s->rx_region_crc.path, sizeof(s->rx_region_crc.path), "%s", path);
+    s->rx_region_crc.start = start;
+    s->rx_region_crc.length = length;
+    s->rx_region_crc.crc = crc;
+    s->rx_region_crc.valid = true;
+}
+
+// Record freshly written bytes [start, start+length); extends the cached region when contiguous.
+static void rx_region_crc_append(val_session_t *s, const char *path, uint64_t start, uint64_t length, uint32_t crc)
+{
+    if (s->rx_region_crc.valid && s->rx_region_crc.start + s->rx_region_crc.length == start &&
+        strcmp(s->rx_region_crc.path, path) == 0)
+    {
+        crc = val_internal_crc32_combine(s, s->rx_region_crc.crc, crc, length);
+        length += s->rx_region_crc.length;
+        start = s->rx_region_crc.start;
+    }
+    rx_region_crc_store(s, path, start, length, crc);
+}
+
+static void rx_region_crc_invalidate(val_session_t *s, const char *path)
+{
+    if (s->rx_region_crc.valid && strcmp(s->rx_region_crc.path, path) == 0)
+        s->rx_region_crc.valid = false;
+}
+
+static val_status_t rx_region_crc(val_session_t *s, const char *path, void *file, uint64_t start, uint64_t length,
+                                  uint32_t *out_crc)
+{
+    if (rx_region_crc_lookup(s, path, start, length, out_crc))
+        return VAL_OK;
+    uint64_t end = start + length;
+    uint64_t c_start = s->rx_region_crc.start;
+    uint64_t c_end = c_start + s->rx_region_crc.length;
+    uint32_t c_crc = s->rx_region_crc.crc;
+    int same = s->rx_region_crc.valid && strcmp(s->rx_region_crc.path, path) == 0;
+    uint32_t part = 0, crc = 0;
+    val_status_t st;
+    if (same && c_end == end && c_start > start)
+    {
+        // Cached suffix: read only the missing head, then append the cached CRC
+        st = val_internal_crc32_region(s, file, start, c_start - start, &part);
+        crc = val_internal_crc32_combine(s, part, c_crc, c_end - c_start);
+    }
+    else if (same && c_end == end && c_start < start && start - c_start < length)
+    {
+        // Cached superset ending here: read the shorter surplus head and strip it
+        st = val_internal_crc32_region(s, file, c_start, start - c_start, &part);
+        crc = val_internal_crc32_combine(s, part, c_crc, length);
+    }
+    else if (same && c_start == start && c_end < end)
+    {
+        // Cached prefix: read only the missing tail
+        st = val_internal_crc32_region(s, file, c_end, end - c_end, &part);
+        crc = val_internal_crc32_combine(s, c_crc, part, end - c_end);
+    }
+    else
+    {
+        st = val_internal_crc32_region(s, file, start, length, &crc);
+    }
+    if (st != VAL_OK)
+        return st;
+    rx_region_crc_store(s, path, start, length, crc);
+    *out_crc = crc;
+    return VAL_OK;
+}
+
 static val_resume_action_t determine_resume_action(val_session_t *session, const char *filename, const char *sender_path,
                                                    uint64_t incoming_file_size, uint64_t *out_resume_offset,
                                                    uint32_t *out_verify_crc, uint64_t *out_verify_length)
@@ -85,8 +586,14 @@ static val_resume_action_t determine_resume_action(val_session_t *session, const
         return VAL_RESUME_START_ZERO;
     }
 
-    session->config->filesystem.fseek(session->config->filesystem.fs_context, file, 0, SEEK_END);
-    int64_t existing_size_l = session->config->filesystem.ftell(session->config->filesystem.fs_context, file);
+    int64_t existing_size_l;
+    if (session->config->filesystem.fsize)
+        existing_size_l = session->config->filesystem.fsize(session->config->filesystem.fs_context, full_output_path);
+    else
+    {
+        session->config->filesystem.fseek(session->config->filesystem.fs_context, file, 0, SEEK_END);
+        existing_size_l = session->config->filesystem.ftell(session->config->filesystem.fs_context, file);
+    }
     if (existing_size_l < 0)
     {
         session->config->filesystem.fclose(session->config->filesystem.fs_context, file);
@@ -167,7 +674,7 @@ static val_resume_action_t determine_resume_action(val_session_t *session, const
 
     uint32_t tail_crc = 0;
     long start_pos = (long)(existing_size - verify_len);
-    if (val_internal_crc32_region(session, file, (uint64_t)start_pos, verify_len, &tail_crc) != VAL_OK)
+    if (rx_region_crc(session, full_output_path, file, (uint64_t)start_pos, verify_len, &tail_crc) != VAL_OK)
     {
         session->config->filesystem.fclose(session->config->filesystem.fs_context, file);
         *out_resume_offset = 0;
@@ -252,11 +759,18 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
     (void)output_directory;
     size_t P = s->effective_packet_size ? s->effective_packet_size : s->config->buffers.packet_size;
     uint8_t *tmp = (uint8_t *)s->config->buffers.recv_buffer;
+    // DATA payloads are received in place here and written to the file from the same bytes
+    uint8_t *data_buf = s->config->buffers.rx_data_buffer ? (uint8_t *)s->config->buffers.rx_data_buffer : tmp;
 
     // Local batch progress context (no persistent RAM)
     uint64_t batch_transferred = 0; // sum of completed file sizes
     uint32_t files_completed = 0;
     uint32_t start_ms = s->config->system.get_ticks_ms();
+    // VAL_FEAT_PIPELINE: the next SEND_META (or EOT) may arrive before this file's DONE was seen. Once the file
+    // is complete it stands in for the lost DONE and is carried over (payload in tmp) to the next iteration.
+    int pipelined = (s->negotiated_features & VAL_FEAT_PIPELINE) ? 1 : 0;
+    val_packet_type_t carried = 0;
+    uint32_t carried_len = 0;
 
     // Handshake done upon public API entry; loop to receive files until EOT
     for (;;)
@@ -267,6 +781,13 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
         uint64_t off = 0;
         uint32_t to_meta = val_internal_get_timeout(s, VAL_OP_META);
         val_status_t st = VAL_OK;
+        if (carried)
+        {
+            t = carried;
+            len = carried_len;
+            carried = 0;
+        }
+        else
         {
             uint8_t tries = s->config->retries.meta_retries ? s->config->retries.meta_retries : 0;
             uint32_t backoff = s->config->retries.backoff_ms_base ? s->config->retries.backoff_ms_base : 0;
@@ -288,6 +809,12 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     return VAL_ERR_ABORTED;
                 }
                 st = val_internal_recv_packet(s, &t, tmp, (uint32_t)P, &len, &off, to_meta);
+                if (st == VAL_OK && t == VAL_PKT_DONE && files_completed)
+                {
+                    // DONE repeated while the last file was still being flushed: our DONE_ACK crossed it
+                    (void)val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, off);
+                    continue;
+                }
                 if (st == VAL_OK)
                 {
                     // Break to evaluate packet type (SEND_META/EOT/CANCEL/…) below
@@ -345,6 +872,9 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
         uint64_t resume_off = 0; // may be set by validation skip path
         int predecide_skip = 0; // if validator says SKIP, we still must participate in RESUME negotiation
         int skipping = 0;
+        // RESUME_RESP as sent for this file, resent if the sender repeats RESUME_REQ after it was lost
+        uint8_t resume_resp_wire[VAL_WIRE_RESUME_RESP_SIZE];
+        uint32_t resume_resp_len = 0;
         if (s->config->resume.mode == VAL_RESUME_NEVER)
         {
             /* If the peer (sender) actually issues a RESUME_REQ despite our local
@@ -378,23 +908,14 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     VAL_LOG_TRACEF(s, "resume_resp: action=%u resume_off=%llu verify_crc=0x%08x verify_len=%llu",
                                    (unsigned)rr.action, (unsigned long long)rr.resume_offset,
                                    (unsigned)rr.verify_crc, (unsigned long long)rr.verify_length);
-                    /* Also append a small diagnostic record to disk so test harness can inspect it */
-                    {
-                        FILE *tf = fopen("resume_trace.log", "a");
-                        if (tf)
-                        {
-                            fprintf(tf, "RECV_RESUME_RESP action=%u resume_off=%llu verify_crc=0x%08x verify_len=%llu\n",
-                                    (unsigned)rr.action, (unsigned long long)rr.resume_offset,
-                                    (unsigned)rr.verify_crc, (unsigned long long)rr.verify_length);
-                            fclose(tf);
-                        }
-                    }
                 val_status_t send_st = val_internal_send_packet(s, VAL_PKT_RESUME_RESP, rr_wire, (uint32_t)sizeof(rr_wire), 0);
                 if (send_st != VAL_OK)
                 {
                     VAL_LOG_ERRORF(s, "receiver: failed to send RESUME_RESP st=%d", (int)send_st);
                     return send_st;
                 }
+                memcpy(resume_resp_wire, rr_wire, sizeof(rr_wire));
+                resume_resp_len = (uint32_t)sizeof(rr_wire);
                 if (action == VAL_RESUME_SKIP_FILE)
                 {
                     validation_skipped = 1;
@@ -428,16 +949,21 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     if (vw != VAL_OK) return vw;
                     uint64_t verify_offset = 0; uint32_t sender_crc = 0; uint32_t verify_length = 0;
                     val_deserialize_verify_request(vbuf, &verify_offset, &sender_crc, &verify_length);
-                    void *lf = s->config->filesystem.fopen(s->config->filesystem.fs_context, full_output_path, "rb");
-                    if (!lf)
+                    // Usually the tail hashed for RESUME_RESP; only re-read on a cache miss
+                    uint32_t local_crc = 0; val_status_t crcst = VAL_OK;
+                    if (!rx_region_crc_lookup(s, full_output_path, verify_offset, verify_length, &local_crc))
                     {
-                        uint8_t resp[VAL_WIRE_VERIFY_RESP_PAYLOAD_SIZE];
-                        val_serialize_verify_response(VAL_ERR_RESUME_VERIFY, 0, resp);
-                        (void)val_internal_send_packet(s, VAL_PKT_VERIFY, resp, (uint32_t)sizeof(resp), (uint64_t)VAL_ERR_RESUME_VERIFY);
-                        return VAL_ERR_IO;
+                        void *lf = s->config->filesystem.fopen(s->config->filesystem.fs_context, full_output_path, "rb");
+                        if (!lf)
+                        {
+                            uint8_t resp[VAL_WIRE_VERIFY_RESP_PAYLOAD_SIZE];
+                            val_serialize_verify_response(VAL_ERR_RESUME_VERIFY, 0, resp);
+                            (void)val_internal_send_packet(s, VAL_PKT_VERIFY, resp, (uint32_t)sizeof(resp), (uint64_t)VAL_ERR_RESUME_VERIFY);
+                            return VAL_ERR_IO;
+                        }
+                        crcst = rx_region_crc(s, full_output_path, lf, verify_offset, verify_length, &local_crc);
+                        s->config->filesystem.fclose(s->config->filesystem.fs_context, lf);
                     }
-                    uint32_t local_crc = 0; val_status_t crcst = val_internal_crc32_region(s, lf, verify_offset, verify_length, &local_crc);
-                    s->config->filesystem.fclose(s->config->filesystem.fs_context, lf);
                     val_status_t result = (crcst == VAL_OK && local_crc == sender_crc) ? VAL_OK : VAL_ERR_RESUME_VERIFY;
                     uint8_t resp[VAL_WIRE_VERIFY_RESP_PAYLOAD_SIZE];
                     val_serialize_verify_response(result, local_crc, resp);
@@ -639,6 +1165,8 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                 return send_st;
             }
             VAL_LOG_INFO(s, "receiver: RESUME_RESP sent successfully");
+            memcpy(resume_resp_wire, rr_wire, sizeof(rr_wire));
+            resume_resp_len = (uint32_t)sizeof(rr_wire);
             if (action == VAL_RESUME_SKIP_FILE)
             {
                 // Resume policy says skip file - preserve existing file
@@ -674,18 +1202,22 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     return vw;
                 uint64_t verify_offset = 0; uint32_t sender_crc = 0; uint32_t verify_length = 0;
                 val_deserialize_verify_request(vbuf, &verify_offset, &sender_crc, &verify_length);
-                // Compute local CRC over requested window
-                // Open file for read - use full_output_path which includes directory
-                void *lf = s->config->filesystem.fopen(s->config->filesystem.fs_context, full_output_path, "rb");
-                if (!lf)
+                // Compute local CRC over requested window; usually the tail already hashed for RESUME_RESP
+                uint32_t local_crc = 0; val_status_t crcst = VAL_OK;
+                if (!rx_region_crc_lookup(s, full_output_path, verify_offset, verify_length, &local_crc))
                 {
-                    uint8_t resp[VAL_WIRE_VERIFY_RESP_PAYLOAD_SIZE];
-                    val_serialize_verify_response(VAL_ERR_RESUME_VERIFY, 0, resp);
-                    (void)val_internal_send_packet(s, VAL_PKT_VERIFY, resp, (uint32_t)sizeof(resp), (uint64_t)VAL_ERR_RESUME_VERIFY);
-                    return VAL_ERR_IO;
+                    // Open file for read - use full_output_path which includes directory
+                    void *lf = s->config->filesystem.fopen(s->config->filesystem.fs_context, full_output_path, "rb");
+                    if (!lf)
+                    {
+                        uint8_t resp[VAL_WIRE_VERIFY_RESP_PAYLOAD_SIZE];
+                        val_serialize_verify_response(VAL_ERR_RESUME_VERIFY, 0, resp);
+                        (void)val_internal_send_packet(s, VAL_PKT_VERIFY, resp, (uint32_t)sizeof(resp), (uint64_t)VAL_ERR_RESUME_VERIFY);
+                        return VAL_ERR_IO;
+                    }
+                    crcst = rx_region_crc(s, full_output_path, lf, verify_offset, verify_length, &local_crc);
+                    s->config->filesystem.fclose(s->config->filesystem.fs_context, lf);
                 }
-                uint32_t local_crc = 0; val_status_t crcst = val_internal_crc32_region(s, lf, verify_offset, verify_length, &local_crc);
-                s->config->filesystem.fclose(s->config->filesystem.fs_context, lf);
                 val_status_t result = (crcst == VAL_OK && local_crc == sender_crc) ? VAL_OK : VAL_ERR_RESUME_VERIFY;
                 // If verification failed but policy requests skipping on mismatch, advertise SKIPPED
                 if (result != VAL_OK && s->config->resume.mismatch_skip)
@@ -734,12 +1266,24 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
         void *f = NULL;
         if (!skipping)
         {
+            if (resume_off == 0)
+                rx_region_crc_invalidate(s, full_output_path);
             f = s->config->filesystem.fopen(s->config->filesystem.fs_context, full_output_path, mode);
             if (!f)
             {
                 val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_PERMISSION);
                 return VAL_ERR_IO;
             }
+            // Reserve the whole file now: contiguous extents, and a full disk is reported before any DATA
+            if (s->config->filesystem.preallocate && meta.file_size > resume_off &&
+                s->config->filesystem.preallocate(s->config->filesystem.fs_context, f, meta.file_size) < 0)
+            {
+                VAL_LOG_ERRORF(s, "recv: cannot reserve %llu bytes", (unsigned long long)meta.file_size);
+                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                (void)val_internal_send_error(s, VAL_ERR_IO, VAL_ERROR_DETAIL_DISK_FULL);
+                val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_DISK_FULL);
+                return VAL_ERR_IO;
+            }
         }
 
         uint64_t total = meta.file_size;
@@ -766,11 +1310,31 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     if (backoff && s->config->system.delay_ms) s->config->system.delay_ms(backoff);
                     if (backoff) backoff <<= 1; --tries;
                 }
+                if (t == VAL_PKT_DONE && pipelined && off != total)
+                {
+                    // Retried DONE of the previous file, whose DONE_ACK was lost: acknowledge it again
+                    (void)val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, off);
+                    continue;
+                }
                 if (t == VAL_PKT_DONE)
                 {
                     (void)val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, total);
                     break;
                 }
+                if (t == VAL_PKT_RESUME_REQ && resume_resp_len)
+                {
+                    // Our RESUME_RESP was lost: the skip decision stands
+                    (void)val_internal_send_packet(s, VAL_PKT_RESUME_RESP, resume_resp_wire, resume_resp_len, 0);
+                    continue;
+                }
+                if (pipelined && (t == VAL_PKT_SEND_META || t == VAL_PKT_EOT))
+                {
+                    // The DONE was lost ahead of the next announcement: acknowledge it, then handle this packet
+                    (void)val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, total);
+                    carried = t;
+                    carried_len = len;
+                    break;
+                }
                 if (t == VAL_PKT_EOT)
                 {
                     (void)val_internal_send_packet(s, VAL_PKT_EOT_ACK, NULL, 0, 0);
@@ -790,14 +1354,30 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
             batch_transferred += total;
             continue; // next file
         }
-        // Compute CRC across only the newly received bytes; no re-CRC of existing bytes.
-        uint32_t crc_state = val_crc32_init_state();
+        // CRC of the newly received bytes, folded in per packet from the CRC recv_packet derived off
+        // each verified trailer: no second pass over the data and no re-read at DONE.
+        uint32_t file_crc = 0;
+        // Selective repeat: park out-of-order DATA instead of NAKing it (needs the caller's reorder buffer)
+        int selective = ((s->negotiated_features & VAL_FEAT_SACK) && s->rx_reorder) ? 1 : 0;
+        if (selective)
+            memset(s->rx_reorder, 0, sizeof(val_rx_reorder_slot_t) * s->rx_reorder_slots);
+        // Writes go through the write-behind buffer when one is configured (direct fwrite otherwise)
+        val_rx_wb_t wb;
+        rx_wb_init(&wb, s, f, written, total);
+        uint8_t *dst = data_buf;
     // ACK coalescing state (per-file)
         uint32_t pkts_since_ack = 0;
     // Heartbeat removed: ACKs are emitted based on stride and progress only
-    // Conservative ACK cadence: ACK every packet to guarantee progress under jitter/reordering.
-    // We can make this adaptive later; for now, keep it simple and robust.
-    uint32_t ack_stride = 1u;
+    // Delayed ACKs: one DATA_ACK covers up to ack_stride in-order packets. The stride starts at 2, grows by
+    // one whenever it fills and halves when the delayed-ACK timer has to flush a partial stride (the sender
+    // ran out of window first). Frames flagged VAL_DATA_ACK_NOW, gaps, repairs and end of file ACK at once.
+    uint32_t ack_stride_cap = s->ack_stride_packets ? s->ack_stride_packets : 1u;
+    uint32_t ack_stride = (ack_stride_cap < 2u) ? ack_stride_cap : 2u;
+    uint32_t ack_delay = rx_ack_delay_ms(s);
+    // Gap NAK rate limit: next-expected offset last NAKed, when, and duplicate ACKs sent since
+    uint64_t nak_gap_at = UINT64_MAX;
+    uint32_t nak_gap_ms = 0;
+    uint32_t gap_dupacks = 0;
         for (;;)
         {
             t = 0;
@@ -814,14 +1394,14 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     if (health != VAL_OK)
                     {
                         if (!skipping && f)
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                            rx_wb_close(&wb);
                         return health;
                     }
                         
                     if (!val_internal_transport_is_connected(s))
                     {
                         if (!skipping && f)
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                            rx_wb_close(&wb);
                         VAL_SET_NETWORK_ERROR(s, VAL_ERROR_DETAIL_CONNECTION);
                         return VAL_ERR_IO;
                     }
@@ -829,14 +1409,17 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     {
                         VAL_LOG_WARN(s, "data: local cancel at receiver");
                         if (!skipping && f)
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                            rx_wb_close(&wb);
                         if (s->config->callbacks.on_file_complete)
                             s->config->callbacks.on_file_complete(clean_name, meta.sender_path, VAL_ERR_ABORTED);
                         val_internal_set_last_error(s, VAL_ERR_ABORTED, 0);
                         VAL_LOG_WARN(s, "[RX] Local cancel detected in data loop, last_error=ABORTED");
                         return VAL_ERR_ABORTED;
                     }
-                    st = val_internal_recv_packet(s, &t, tmp, (uint32_t)P, &len, &off, to_data);
+                    // With an ACK pending, wait no longer than the delayed-ACK timer
+                    uint32_t wait_ms = (pkts_since_ack && ack_delay < to_data) ? ack_delay : to_data;
+                    dst = rx_wb_dst(&wb, data_buf, P);
+                    st = val_internal_recv_packet(s, &t, dst, (uint32_t)P, &len, &off, wait_ms);
                     if (st == VAL_OK)
                     {
                         // Per-packet trace: keep at TRACE to avoid slowing tests under DEBUG builds
@@ -844,9 +1427,24 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                                        (unsigned long long)off);
                         break;
                     }
+                    if (st == VAL_ERR_TIMEOUT && pkts_since_ack)
+                    {
+                        // Delayed-ACK timer fired: flush the partial stride (not a retry) and shrink the stride
+                        VAL_LOG_TRACEF(s, "data: delayed DATA_ACK off=%llu after %u packets", (unsigned long long)written,
+                                       (unsigned)pkts_since_ack);
+                        val_status_t st2 = rx_ack(s, &wb, written, 1);
+                        if (st2 != VAL_OK)
+                        {
+                            rx_wb_close(&wb);
+                            return st2;
+                        }
+                        pkts_since_ack = 0;
+                        ack_stride = (ack_stride > 1u) ? ack_stride / 2u : 1u;
+                        continue;
+                    }
                     if ((st != VAL_ERR_TIMEOUT && st != VAL_ERR_CRC) || tries == 0)
                     {
-                        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                        rx_wb_close(&wb);
                         if (st == VAL_ERR_TIMEOUT)
                         {
                             VAL_SET_TIMEOUT_ERROR(s, VAL_ERROR_DETAIL_TIMEOUT_DATA);
@@ -870,38 +1468,47 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
             }
             if (t == VAL_PKT_DATA)
             {
-                // Determine effective offset: UINT64_MAX indicates implied offset (current 'written')
-                uint64_t eff_off = (off == UINT64_MAX) ? written : off;
+                // Determine effective offset: UINT64_MAX indicates implied offset (placed by its hint)
+                uint64_t eff_off = (off == UINT64_MAX) ? rx_implied_offset(s, written) : off;
                 // Determine ordering before mutating 'written'
                 int in_order = (eff_off == written) ? 1 : 0;
                 int dup_or_overlap = (eff_off < written) ? 1 : 0;
+                int gap_repaired = 0;
                 // Cumulative ACK semantics
                 if (in_order)
                 {
                     // Normal in-order chunk
                     if (!skipping && len)
                     {
-                        size_t w = s->config->filesystem.fwrite(s->config->filesystem.fs_context, tmp, 1, len, f);
-                        if (w != len)
+                        // A short write (now or of an earlier chunk) records VAL_ERROR_DETAIL_DISK_FULL
+                        if (rx_wb_write(&wb, dst, len) != VAL_OK)
                         {
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
-                            val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_DISK_FULL);
+                            rx_wb_close(&wb);
                             return VAL_ERR_IO;
                         }
-                        crc_state = val_crc32_update_state(crc_state, tmp, len);
+                        file_crc = val_internal_crc32_combine(s, file_crc, s->rx_data_crc, len);
                     }
-                    // If this completes the file exactly, force an ACK immediately regardless of stride
-                    uint8_t completes_file = (written + len >= total) ? 1u : 0u;
                     written += len;
-                    if (completes_file)
+                    // The gap just closed may release held out-of-order packets
+                    if (selective && !skipping)
+                    {
+                        uint64_t expect = written;
+                        if (rx_reorder_drain(s, &wb, &written, &file_crc) != VAL_OK)
+                        {
+                            rx_wb_close(&wb);
+                            return VAL_ERR_IO;
+                        }
+                        gap_repaired = (written != expect) ? 1 : 0;
+                    }
+                    // If this completes the file exactly, force an ACK immediately regardless of stride
+                    if (written >= total)
                     {
                         VAL_LOG_TRACEF(s, "data: final chunk received, forcing DATA_ACK off=%llu",
                                        (unsigned long long)written);
-                        val_status_t st2 = val_internal_send_packet(s, VAL_PKT_DATA_ACK, NULL, 0, written);
+                        val_status_t st2 = rx_ack(s, &wb, written, 1);
                         if (st2 != VAL_OK)
                         {
-                            if (!skipping && f)
-                                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                            rx_wb_close(&wb);
                             return st2;
                         }
                         pkts_since_ack = 0;
@@ -915,20 +1522,59 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     // This avoids NAK/ACK oscillation when sender has already advanced.
                     VAL_LOG_TRACEF(s, "data: duplicate/overlap -> reaffirm DATA_ACK off=%llu",
                                    (unsigned long long)written);
-                    (void)val_internal_send_packet(s, VAL_PKT_DATA_ACK, NULL, 0, written);
+                    if (rx_ack(s, &wb, written, 1) != VAL_OK && wb.failed)
+                    {
+                        rx_wb_close(&wb);
+                        return VAL_ERR_IO;
+                    }
+                    pkts_since_ack = 0;
+                }
+                else if (selective && eff_off < total && rx_reorder_store(s, eff_off, dst, len, s->rx_data_crc))
+                {
+                    // Sender ahead under selective repeat: hold the packet and SACK it; the sender fills the gap
+                    VAL_LOG_TRACEF(s, "data: held out-of-order off=%llu len=%u (next_expected=%llu)",
+                                   (unsigned long long)eff_off, (unsigned)len, (unsigned long long)written);
+                    if (rx_ack(s, &wb, written, 1) != VAL_OK && wb.failed)
+                    {
+                        rx_wb_close(&wb);
+                        return VAL_ERR_IO;
+                    }
+                    pkts_since_ack = 0;
                 }
                 else /* sender_ahead */
                 {
-                    // Sender is ahead; immediately NAK with next expected offset
-                    VAL_LOG_TRACEF(s, "data: sender ahead -> sending DATA_NAK (next_expected=%llu)",
-                                   (unsigned long long)written);
-                    uint32_t reason = 0x1u; // GAP
-                    // Use new NAK format: low32 in header (via offset param), content carries [high32, reason, reserved]
-                    uint8_t payload[4]; // pass reason only; core will build full 12-byte content
-                    VAL_PUT_LE32(payload, reason);
-                    (void)val_internal_send_packet_ex(s, VAL_PKT_DATA_NAK, payload, sizeof(payload), written, 0);
-                    // Also send an ACK at our current high-water to help the sender resync
-                    (void)val_internal_send_packet(s, VAL_PKT_DATA_ACK, NULL, 0, written);
+                    // Sender is ahead: NAK the gap once per hold-off; the frames still in flight behind the
+                    // lost one get a few duplicate ACKs (fast retransmit if the NAK is lost), then silence
+                    uint32_t now_ms = s->config->system.get_ticks_ms();
+                    if (nak_gap_at != written || (uint32_t)(now_ms - nak_gap_ms) >= rx_nak_holdoff_ms(s))
+                    {
+                        VAL_LOG_TRACEF(s, "data: sender ahead -> sending DATA_NAK (next_expected=%llu)",
+                                       (unsigned long long)written);
+                        uint32_t reason = 0x1u; // GAP
+                        // Use new NAK format: low32 in header (via offset param), content carries [high32, reason, reserved]
+                        uint8_t payload[4]; // pass reason only; core will build full 12-byte content
+                        VAL_PUT_LE32(payload, reason);
+                        (void)val_internal_send_packet_ex(s, VAL_PKT_DATA_NAK, payload, sizeof(payload), written, 0);
+                        // Flush a delayed ACK so the duplicates that follow sit exactly at the gap
+                        if (pkts_since_ack && rx_ack(s, &wb, written, 1) != VAL_OK && wb.failed)
+                        {
+                            rx_wb_close(&wb);
+                            return VAL_ERR_IO;
+                        }
+                        nak_gap_at = written;
+                        nak_gap_ms = now_ms;
+                        gap_dupacks = 0;
+                    }
+                    else if (gap_dupacks < VAL_RX_GAP_DUPACKS)
+                    {
+                        if (rx_ack(s, &wb, written, 1) != VAL_OK && wb.failed)
+                        {
+                            rx_wb_close(&wb);
+                            return VAL_ERR_IO;
+                        }
+                        gap_dupacks++;
+                    }
+                    pkts_since_ack = 0;
                 }
                 if (s->config->callbacks.on_progress)
                 {
@@ -959,7 +1605,7 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                     {
                         VAL_LOG_WARN(s, "data: local cancel after progress, before ACK");
                         if (!skipping && f)
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                            rx_wb_close(&wb);
                         if (s->config->callbacks.on_file_complete)
                             s->config->callbacks.on_file_complete(clean_name, meta.sender_path, VAL_ERR_ABORTED);
                         val_internal_set_last_error(s, VAL_ERR_ABORTED, 0);
@@ -969,12 +1615,13 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                 }
                 // ACK policy:
                 // - Immediate ACK on duplicate/overlap or sender-ahead (reaffirm position).
-                // - For in-order chunks, ACK once per receiver-preferred stride (ack_stride).
+                // - For in-order chunks, ACK once per adaptive stride (ack_stride), or at once when the sender
+                //   flagged the frame VAL_DATA_ACK_NOW or it repaired a gap.
                 // - Additionally, if we reached the end of file (written >= total), force an ACK so sender can proceed to DONE.
                 int force_ack = 0; // NAK covers negative feedback; reserve ACK for cadence/EOF
                 if (in_order)
                     pkts_since_ack++;
-                if (in_order && written >= total)
+                if (in_order && (written >= total || gap_repaired || (s->rx_data_flags & VAL_DATA_ACK_NOW)))
                     force_ack = 1;
                 int streaming = 0; // streaming removed in bounded-window flow control
                 // Log state for first packet and every 5000 packets for debugging
@@ -985,44 +1632,92 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
                                   debug_pkt_count, streaming,
                                   pkts_since_ack, (unsigned)ack_stride);
                 }
-                if (force_ack || pkts_since_ack >= ack_stride)
+                if (pkts_since_ack && pkts_since_ack >= ack_stride)
+                {
+                    // A full stride arrived before the sender had to wait: try a longer one
+                    if (ack_stride < ack_stride_cap)
+                        ack_stride++;
+                    force_ack = 1;
+                }
+                if (force_ack)
                 {
                     // ACK cadence trace moved to TRACE to reduce console overhead during tests
                     VAL_LOG_TRACEF(s, "data: sending DATA_ACK off=%llu", (unsigned long long)written);
-                    val_status_t st2 = val_internal_send_packet(s, VAL_PKT_DATA_ACK, NULL, 0, written);
+                    // Stride ACKs under VAL_ACK_ON_WRITE only report completed writes; until one covers
+                    // everything received the delayed-ACK timer stays armed and settles the rest
+                    int settle = (written >= total || gap_repaired || (s->rx_data_flags & VAL_DATA_ACK_NOW)) ? 1 : 0;
+                    val_status_t st2 = rx_ack(s, &wb, written, settle);
                     if (st2 != VAL_OK)
                     {
-                        if (!skipping && f)
-                            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                        rx_wb_close(&wb);
                         return st2;
                     }
-                    pkts_since_ack = 0;
+                    if (wb.acked == written)
+                        pkts_since_ack = 0;
                 }
             }
-            else if (t == VAL_PKT_DONE)
+            else if (t == VAL_PKT_DONE && (written < total || (pipelined && off != total)))
             {
+                // Not this file's DONE: with pipelining, a retry for the previous file whose DONE_ACK was lost
+                // after this file was already announced. Acknowledge that file again; this one carries on.
+                if (files_completed)
+                {
+                    VAL_LOG_DEBUGF(s, "data: repeated DONE for size %llu, re-sending DONE_ACK", (unsigned long long)off);
+                    (void)val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, off);
+                }
+                else
+                {
+                    VAL_LOG_DEBUG(s, "data: ignoring DONE before the file is complete");
+                }
+            }
+            else if (t == VAL_PKT_RESUME_REQ && resume_resp_len && written == resume_off)
+            {
+                // Our RESUME_RESP was lost and no DATA has arrived yet: answer the repeated request the same way
+                (void)val_internal_send_packet(s, VAL_PKT_RESUME_RESP, resume_resp_wire, resume_resp_len, 0);
+            }
+            else if (t == VAL_PKT_DONE ||
+                     (pipelined && (t == VAL_PKT_SEND_META || t == VAL_PKT_EOT) && written >= total))
+            {
+                if (t != VAL_PKT_DONE)
+                {
+                    // Pipelined announcement of the next file with this one complete: its DONE was lost. Keep the
+                    // packet for the next iteration (dst may be a mapping released below) and finish as on DONE.
+                    memmove(tmp, dst, len);
+                    carried = t;
+                    carried_len = len;
+                }
                 // Protocol no longer validates whole-file CRC at DONE; rely on packet-level integrity and resume verify
-                (void)crc_state; // kept for potential metrics/debug, not used for validation
+                // DONE_ACK only once every byte is written: a late short write still fails the file
+                if (rx_wb_flush(&wb) != VAL_OK || rx_map_release(&wb) != VAL_OK)
+                {
+                    rx_wb_close(&wb);
+                    return VAL_ERR_IO;
+                }
+                // Remember what we hashed so a later tail check on this file needs no re-read
+                if (written > resume_off)
+                    rx_region_crc_append(s, full_output_path, resume_off, written - resume_off, file_crc);
+                VAL_LOG_DEBUGF(s, "data: received range [%llu,%llu) crc=0x%08X", (unsigned long long)resume_off,
+                               (unsigned long long)written, (unsigned)file_crc);
                 // Acknowledge DONE explicitly
                 val_status_t st2 = val_internal_send_packet(s, VAL_PKT_DONE_ACK, NULL, 0, written);
                 if (st2 != VAL_OK)
                 {
                     if (!skipping && f)
-                        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                        rx_wb_close(&wb);
                     return st2;
                 }
                 break; // file complete
             }
             else if (t == VAL_PKT_ERROR)
             {
-                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                rx_wb_close(&wb);
                 return VAL_ERR_PROTOCOL;
             }
             else if (t == VAL_PKT_CANCEL)
             {
                 VAL_LOG_WARN(s, "data: received CANCEL");
                 if (!skipping && f)
-                    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                    rx_wb_close(&wb);
                 if (s->config->callbacks.on_file_complete)
                     s->config->callbacks.on_file_complete(clean_name, meta.sender_path, VAL_ERR_ABORTED);
                 val_internal_set_last_error(s, VAL_ERR_ABORTED, 0);
@@ -1036,7 +1731,7 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
             else if (t == VAL_PKT_SEND_META)
             {
                 // Unexpected new file; for simplicity, treat as protocol error for now
-                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                rx_wb_close(&wb);
                 VAL_SET_PROTOCOL_ERROR(s, VAL_ERROR_DETAIL_INVALID_STATE);
                 return VAL_ERR_PROTOCOL;
             }
@@ -1046,7 +1741,7 @@ val_status_t val_internal_receive_files(val_session_t *s, const char *output_dir
             }
         }
         if (!skipping && f)
-            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+            rx_wb_close(&wb);
         if (s->config->callbacks.on_file_complete)
             s->config->callbacks.on_file_complete(clean_name, meta.sender_path, skipping ? VAL_SKIPPED : VAL_OK);
         val_metrics_inc_files_recv(s);
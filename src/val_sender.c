@@ -3,20 +3,12 @@
 #include <stdlib.h>
 #include <string.h>
 
-static val_status_t get_file_size_and_name(val_session_t *s, const char *filepath, uint64_t *out_size, char *out_filename)
+// Size of an open source file without filesystem.fsize: seek to its end. The position is left there; the
+// data path seeks to where it starts reading.
+static val_status_t file_size_seek(val_session_t *s, void *f, uint64_t *out_size)
 {
-    // Open file to determine size
-
-    void *f = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
-    if (!f)
-    {
-        VAL_LOG_ERROR(s, "fopen failed");
-        val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_FILE_NOT_FOUND);
-        return VAL_ERR_IO;
-    }
     if (s->config->filesystem.fseek(s->config->filesystem.fs_context, f, 0, SEEK_END) != 0)
     {
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         VAL_LOG_ERROR(s, "fseek end failed");
         val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_PERMISSION);
         return VAL_ERR_IO;
@@ -24,22 +16,47 @@ static val_status_t get_file_size_and_name(val_session_t *s, const char *filepat
     int64_t sz = s->config->filesystem.ftell(s->config->filesystem.fs_context, f);
     if (sz < 0)
     {
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         VAL_LOG_ERROR(s, "ftell failed");
         val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_PERMISSION);
         return VAL_ERR_IO;
     }
-    if (s->config->filesystem.fseek(s->config->filesystem.fs_context, f, 0, SEEK_SET) != 0)
+    *out_size = (uint64_t)sz;
+    return VAL_OK;
+}
+
+// Size of the file at filepath: filesystem.fsize when provided, else seek on f (an open handle of the file, or
+// NULL to open one just for the probe)
+static val_status_t get_file_size(val_session_t *s, const char *filepath, void *f, uint64_t *out_size)
+{
+    if (s->config->filesystem.fsize)
     {
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
-        VAL_LOG_ERROR(s, "fseek set failed");
-        val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_PERMISSION);
+        int64_t sz = s->config->filesystem.fsize(s->config->filesystem.fs_context, filepath);
+        if (sz < 0)
+        {
+            VAL_LOG_ERROR(s, "fsize failed");
+            val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_FILE_NOT_FOUND);
+            return VAL_ERR_IO;
+        }
+        *out_size = (uint64_t)sz;
+        return VAL_OK;
+    }
+    if (f)
+        return file_size_seek(s, f, out_size);
+    f = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
+    if (!f)
+    {
+        VAL_LOG_ERROR(s, "fopen failed");
+        val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_FILE_NOT_FOUND);
         return VAL_ERR_IO;
     }
-    *out_size = (uint64_t)sz;
+    val_status_t st = file_size_seek(s, f, out_size);
     s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+    return st;
+}
 
-    // Derive filename from filepath (simple extraction of basename)
+// Name announced in SEND_META: the sanitized basename of filepath
+static void get_file_name(const char *filepath, char *out_filename)
+{
     const char *base = filepath;
     for (const char *p = filepath; *p; ++p)
     {
@@ -49,7 +66,6 @@ static val_status_t get_file_size_and_name(val_session_t *s, const char *filepat
     char cleaned[VAL_MAX_FILENAME + 1];
     val_clean_filename(base, cleaned, sizeof(cleaned));
     snprintf(out_filename, VAL_MAX_FILENAME + 1, "%s", cleaned);
-    return VAL_OK;
 }
 
 static val_status_t send_metadata(val_session_t *s, const char *sender_path, uint64_t file_size,
@@ -76,28 +92,6 @@ static val_status_t send_metadata(val_session_t *s, const char *sender_path, uin
     val_serialize_meta(&meta, meta_wire);
     return val_internal_send_packet(s, VAL_PKT_SEND_META, meta_wire, VAL_WIRE_META_SIZE, 0);
 }
-static val_status_t compute_crc_region(val_session_t *s, const char *filepath, uint64_t end_offset, uint64_t length,
-                                       uint32_t *out_crc)
-{
-    if (!s || !filepath || !out_crc || length == 0 || end_offset < length)
-        return VAL_ERR_INVALID_ARG;
-
-    void *f = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
-    if (!f)
-    {
-        val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_PERMISSION);
-        return VAL_ERR_IO;
-    }
-
-    uint64_t start = end_offset - length;
-    uint32_t crc_tmp = 0;
-    val_status_t rst = val_internal_crc32_region(s, f, start, length, &crc_tmp);
-    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
-    if (rst != VAL_OK)
-        return rst;
-    *out_crc = crc_tmp;
-    return VAL_OK;
-}
 
 typedef struct val_send_progress_ctx
 {
@@ -111,6 +105,21 @@ typedef struct val_send_progress_ctx
     uint32_t last_emit_tick;
 } val_send_progress_ctx_t;
 
+// Sender read-ahead ring (buffers.tx_readahead_buffer): chunks hold consecutive file ranges from the oldest
+// unacknowledged one up to next_read
+#define VAL_TX_RA_MAX_CHUNKS 8u
+#define VAL_RA_FREE 0u     // not holding a range
+#define VAL_RA_ASSIGNED 1u // range assigned, read with fread when first needed
+#define VAL_RA_PENDING 2u  // read_submit issued, not yet waited for
+#define VAL_RA_READY 3u    // data present
+
+typedef struct
+{
+    uint64_t offset;
+    uint32_t len;
+    uint8_t state; // VAL_RA_*
+} val_tx_ra_chunk_t;
+
 typedef struct val_sender_io_ctx_s
 {
     val_session_t *session;
@@ -119,6 +128,26 @@ typedef struct val_sender_io_ctx_s
     uint32_t max_payload;
     uint64_t file_size;
     uint64_t file_cursor; // tracked current file position to minimize ftell/fseek
+    int selective;        // VAL_FEAT_SACK active: every DATA carries its offset and is tracked per slot
+    const uint64_t *last_acked; // cumulative ACK offset; read-ahead chunks wholly below it are released
+    struct
+    {
+        uint8_t *base;
+        uint32_t chunk_len;
+        uint32_t nchunks; // 0 = read-ahead off
+        uint32_t head;    // oldest assigned chunk
+        uint32_t count;   // assigned chunks, in file order from head
+        uint64_t next_read;
+        int async; // filesystem.read_submit/read_wait in use
+        val_tx_ra_chunk_t chunk[VAL_TX_RA_MAX_CHUNKS];
+    } ra;
+    struct
+    {
+        uint8_t *addr; // read-only mapping of [offset, offset + len); NULL = none
+        uint64_t offset;
+        size_t len;
+        int off; // filesystem.map absent or refused for this file: read instead
+    } map;
 } val_sender_io_ctx_t;
 
 typedef struct val_sender_ack_ctx_s
@@ -143,8 +172,8 @@ typedef struct val_sender_ack_ctx_s
     uint32_t backoff;
     uint32_t backoff_initial;
     uint32_t wait_deadline;
-    uint32_t t0;
     uint64_t *file_cursor_ptr; // keep sender's local cursor in sync on rewinds
+    val_sender_io_ctx_t *io;   // selective repeat retransmits holes through the data path
 } val_sender_ack_ctx_t;
 
 static val_status_t send_data_packet(val_sender_io_ctx_t *io_ctx, uint64_t *next_to_send, uint32_t *inflight, int include_offset);
@@ -156,32 +185,88 @@ static void val_emit_progress_sender(val_session_t *s, val_send_progress_ctx_t *
                                      uint64_t bytes_sent, int force_emit);
 static val_status_t await_resume_ack(val_session_t *s, uint64_t file_size,
                                      uint64_t *resume_offset_out);
-// New: full resume negotiation using RESUME_REQ/RESUME_RESP and VERIFY
-static val_status_t handle_resume_negotiation(val_session_t *s, uint64_t file_size, const char *filepath,
-                                              uint64_t *resume_offset_out)
+// A source file from SEND_META to DONE_ACK. One handle serves the size probe, the resume tail CRC and the data.
+typedef struct
 {
-    if (!s || !resume_offset_out)
-        return VAL_ERR_INVALID_ARG;
-    // Send RESUME_REQ
-    VAL_LOG_INFO(s, "sender: sending RESUME_REQ");
-    val_status_t st = val_internal_send_packet(s, VAL_PKT_RESUME_REQ, NULL, 0, 0);
-    if (st != VAL_OK)
+    void *file;
+    uint64_t size;
+    uint64_t file_cursor; // position of file as far as known (UINT64_MAX = unknown); reads seek only if it differs
+    const char *reported_path;
+    char filename[VAL_MAX_FILENAME + 1];
+    uint8_t resume_resp[VAL_WIRE_RESUME_RESP_SIZE]; // RESUME_RESP already received during the previous DONE_ACK wait
+    uint32_t resume_resp_len;                        // 0 = not received yet
+} val_tx_file_t;
+
+// VAL_FEAT_PIPELINE: what follows a file's DONE before its DONE_ACK is awaited
+typedef struct
+{
+    const char *next_path;   // announce this file after the DONE; NULL = last file, send EOT instead
+    const char *sender_path;
+    val_tx_file_t *next;     // the announced file
+    int announced;           // next file announced, or EOT sent
+    int eot_acked;           // EOT_ACK arrived in place of the DONE_ACK
+    val_status_t status;     // why the next file could not be announced
+} val_tx_pipeline_t;
+
+// Open a source file and announce it: SEND_META, then RESUME_REQ. The file stays open for its transfer.
+static val_status_t announce_file(val_session_t *s, const char *filepath, const char *sender_path, val_tx_file_t *tf)
+{
+    memset(tf, 0, sizeof(*tf));
+    tf->file = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
+    if (!tf->file)
     {
-        VAL_LOG_ERRORF(s, "sender: failed to send RESUME_REQ st=%d", (int)st);
-        return st;
+        VAL_LOG_ERROR(s, "fopen failed");
+        val_internal_set_error_detailed(s, VAL_ERR_IO, VAL_ERROR_DETAIL_FILE_NOT_FOUND);
+        return VAL_ERR_IO;
+    }
+    val_status_t st = get_file_size(s, filepath, tf->file, &tf->size);
+    if (st == VAL_OK)
+    {
+        tf->file_cursor = s->config->filesystem.fsize ? 0 : tf->size;
+        get_file_name(filepath, tf->filename);
+        tf->reported_path = (sender_path && sender_path[0]) ? sender_path : filepath;
+        st = send_metadata(s, tf->reported_path, tf->size, tf->filename);
+    }
+    if (st == VAL_OK)
+    {
+        VAL_LOG_INFO(s, "sender: sending RESUME_REQ");
+        st = val_internal_send_packet(s, VAL_PKT_RESUME_REQ, NULL, 0, 0);
+        if (st != VAL_OK)
+            VAL_LOG_ERRORF(s, "sender: failed to send RESUME_REQ st=%d", (int)st);
     }
-    VAL_LOG_INFO(s, "sender: RESUME_REQ sent, waiting for RESUME_RESP");
-    // Wait for RESUME_RESP (payload up to VAL_WIRE_RESUME_RESP_SIZE bytes)
-    uint8_t resp_buf[VAL_WIRE_RESUME_RESP_SIZE];
-    uint32_t resp_len = 0; uint64_t resp_off = 0;
-    uint32_t to = val_internal_get_timeout(s, VAL_OP_META);
-    uint8_t tries = s->config->retries.ack_retries ? s->config->retries.ack_retries : 0;
-    uint32_t backoff = s->config->retries.backoff_ms_base ? s->config->retries.backoff_ms_base : 0;
-    st = val_internal_wait_resume_resp(s, to, tries, backoff, resp_buf, (uint32_t)sizeof(resp_buf), &resp_len, &resp_off);
     if (st != VAL_OK)
     {
-        VAL_LOG_ERRORF(s, "sender: failed waiting for RESUME_RESP st=%d", (int)st);
-        return st;
+        s->config->filesystem.fclose(s->config->filesystem.fs_context, tf->file);
+        tf->file = NULL;
+    }
+    return st;
+}
+
+// New: full resume negotiation using RESUME_REQ/RESUME_RESP and VERIFY, after announce_file sent the RESUME_REQ.
+// The tail CRC is read through the open source; its file_cursor becomes UINT64_MAX if that moved the position.
+static val_status_t handle_resume_negotiation(val_session_t *s, val_tx_file_t *tf, uint64_t *resume_offset_out)
+{
+    if (!s || !tf || !tf->file || !resume_offset_out)
+        return VAL_ERR_INVALID_ARG;
+    uint64_t file_size = tf->size;
+    void *f = tf->file;
+    // Wait for RESUME_RESP (payload up to VAL_WIRE_RESUME_RESP_SIZE bytes), unless it came in already
+    val_status_t st = VAL_OK;
+    uint8_t *resp_buf = tf->resume_resp;
+    uint32_t resp_len = tf->resume_resp_len; uint64_t resp_off = 0;
+    if (!resp_len)
+    {
+        VAL_LOG_INFO(s, "sender: RESUME_REQ sent, waiting for RESUME_RESP");
+        uint32_t to = val_internal_get_timeout(s, VAL_OP_META);
+        uint8_t tries = s->config->retries.ack_retries ? s->config->retries.ack_retries : 0;
+        uint32_t backoff = s->config->retries.backoff_ms_base ? s->config->retries.backoff_ms_base : 0;
+        st = val_internal_wait_resume_resp(s, to, tries, backoff, resp_buf, (uint32_t)sizeof(tf->resume_resp), &resp_len,
+                                           &resp_off);
+        if (st != VAL_OK)
+        {
+            VAL_LOG_ERRORF(s, "sender: failed waiting for RESUME_RESP st=%d", (int)st);
+            return st;
+        }
     }
     VAL_LOG_INFO(s, "sender: received RESUME_RESP");
     if (resp_len < VAL_WIRE_RESUME_RESP_SIZE)
@@ -215,14 +300,10 @@ static val_status_t handle_resume_negotiation(val_session_t *s, uint64_t file_si
         uint64_t start = resume_off - (uint64_t)vlen32;
         uint32_t crc = 0;
         // Compute CRC from local file tail
-        void *f = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
-        if (!f)
-            return VAL_ERR_IO;
-        if (start > 0)
-            s->config->filesystem.fseek(s->config->filesystem.fs_context, f, (int64_t)start, SEEK_SET);
         /* Compute CRC starting at the tail window start (start) for length vlen32. */
         val_status_t crcs = val_internal_crc32_region(s, f, start, (uint64_t)vlen32, &crc);
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+        if (!s->config->filesystem.pread)
+            tf->file_cursor = UINT64_MAX;
         if (crcs != VAL_OK)
             return crcs;
         // Build VERIFY request payload
@@ -231,14 +312,6 @@ static val_status_t handle_resume_negotiation(val_session_t *s, uint64_t file_si
         // Send VERIFY request
     VAL_LOG_TRACEF(s, "sender: sending VERIFY start=%llu crc=0x%08x len=%u",
                (unsigned long long)start, (unsigned)crc, (unsigned)vlen32);
-    {
-        FILE *tf = fopen("resume_trace.log", "a");
-        if (tf)
-        {
-            fprintf(tf, "SENDER_VERIFY start=%llu crc=0x%08x len=%u\n", (unsigned long long)start, (unsigned)crc, (unsigned)vlen32);
-            fclose(tf);
-        }
-    }
     st = val_internal_send_packet(s, VAL_PKT_VERIFY, verify_payload, (uint32_t)sizeof(verify_payload), 0);
         if (st != VAL_OK)
             return st;
@@ -255,17 +328,566 @@ static val_status_t handle_resume_negotiation(val_session_t *s, uint64_t file_si
     }
 }
 
+// Read [offset, offset + len) of the file into dst: with filesystem.pread at the offset, else with fread,
+// seeking only when the tracked cursor differs
+static size_t read_at(val_sender_io_ctx_t *io_ctx, uint64_t offset, uint8_t *dst, size_t len)
+{
+    val_session_t *s = io_ctx->session;
+    if (s->config->filesystem.pread)
+        return s->config->filesystem.pread(s->config->filesystem.fs_context, io_ctx->file_handle, dst, len, offset);
+    // Assume sequential IO; only seek if our tracked position differs
+    if (io_ctx->file_cursor != offset)
+    {
+        (void)s->config->filesystem.fseek(s->config->filesystem.fs_context, io_ctx->file_handle, (int64_t)offset, SEEK_SET);
+        io_ctx->file_cursor = offset;
+    }
+    size_t have = 0;
+    while (have < len)
+    {
+        size_t r = s->config->filesystem.fread(s->config->filesystem.fs_context, dst + have, 1, len - have,
+                                               io_ctx->file_handle);
+        if (r == 0)
+            break;
+        have += r;
+    }
+    io_ctx->file_cursor += have;
+    return have;
+}
+
+// ---- Read-ahead: a ring of file chunks read ahead of the window fill ----
+// Chunks are assigned to consecutive ranges as they free up and released once the cumulative ACK passes
+// them, so everything between last_acked and the read-ahead point (GBN rewinds, SR holes) is served from
+// memory. With async hooks the chunk reads are submitted on assignment and complete while the sender is
+// sending or waiting for ACKs; without them a chunk is read with one fread when first needed.
+
+static void ra_init(val_sender_io_ctx_t *io_ctx, uint64_t start)
+{
+    const val_config_t *cfg = io_ctx->session->config;
+    memset(&io_ctx->ra, 0, sizeof(io_ctx->ra));
+    size_t size = cfg->buffers.tx_readahead_buffer ? cfg->buffers.tx_readahead_size : 0u;
+    if (size < 2u * (size_t)io_ctx->max_payload)
+        return;
+    size_t chunk = size / VAL_TX_RA_MAX_CHUNKS;
+    if (chunk < io_ctx->max_payload)
+        chunk = io_ctx->max_payload;
+    if (chunk > 0xFFFFFFFFu)
+        chunk = 0xFFFFFFFFu;
+    io_ctx->ra.base = (uint8_t *)cfg->buffers.tx_readahead_buffer;
+    io_ctx->ra.chunk_len = (uint32_t)chunk;
+    io_ctx->ra.nchunks = (uint32_t)(size / chunk);
+    if (io_ctx->ra.nchunks > VAL_TX_RA_MAX_CHUNKS)
+        io_ctx->ra.nchunks = VAL_TX_RA_MAX_CHUNKS;
+    io_ctx->ra.next_read = start;
+    io_ctx->ra.async = (cfg->filesystem.read_submit && cfg->filesystem.read_wait) ? 1 : 0;
+}
+
+static uint8_t *ra_buf(val_sender_io_ctx_t *io_ctx, uint32_t i)
+{
+    return io_ctx->ra.base + (size_t)i * io_ctx->ra.chunk_len;
+}
+
+// Wait for a submitted chunk read; a short read marks the chunk as holding only what arrived
+static void ra_complete(val_sender_io_ctx_t *io_ctx, uint32_t i)
+{
+    const val_config_t *cfg = io_ctx->session->config;
+    val_tx_ra_chunk_t *c = &io_ctx->ra.chunk[i];
+    size_t got = 0;
+    if (cfg->filesystem.read_wait(cfg->filesystem.fs_context, io_ctx->file_handle, ra_buf(io_ctx, i), &got) < 0)
+        got = 0;
+    if (got < c->len)
+    {
+        VAL_LOG_WARNF(io_ctx->session, "readahead: short read at %llu (%u of %u)", (unsigned long long)c->offset,
+                      (unsigned)got, (unsigned)c->len);
+        c->len = (uint32_t)got;
+    }
+    c->state = VAL_RA_READY;
+}
+
+// Release acknowledged chunks and assign free ones to the next ranges (submitting them when async)
+static void ra_fill(val_sender_io_ctx_t *io_ctx)
+{
+    if (!io_ctx->ra.nchunks)
+        return;
+    const val_config_t *cfg = io_ctx->session->config;
+    uint64_t acked = io_ctx->last_acked ? *io_ctx->last_acked : 0u;
+    while (io_ctx->ra.count)
+    {
+        val_tx_ra_chunk_t *c = &io_ctx->ra.chunk[io_ctx->ra.head];
+        if (c->offset + c->len > acked && c->len)
+            break;
+        if (c->state == VAL_RA_PENDING)
+            ra_complete(io_ctx, io_ctx->ra.head); // the buffer is about to be reused
+        c->state = VAL_RA_FREE;
+        io_ctx->ra.head = (io_ctx->ra.head + 1u) % io_ctx->ra.nchunks;
+        io_ctx->ra.count--;
+    }
+    if (!io_ctx->ra.count && io_ctx->ra.next_read < acked)
+        io_ctx->ra.next_read = acked;
+    while (io_ctx->ra.count < io_ctx->ra.nchunks && io_ctx->ra.next_read < io_ctx->file_size)
+    {
+        uint32_t i = (io_ctx->ra.head + io_ctx->ra.count) % io_ctx->ra.nchunks;
+        val_tx_ra_chunk_t *c = &io_ctx->ra.chunk[i];
+        uint64_t remaining = io_ctx->file_size - io_ctx->ra.next_read;
+        c->offset = io_ctx->ra.next_read;
+        c->len = (remaining < io_ctx->ra.chunk_len) ? (uint32_t)remaining : io_ctx->ra.chunk_len;
+        c->state = VAL_RA_ASSIGNED;
+        if (io_ctx->ra.async &&
+            cfg->filesystem.read_submit(cfg->filesystem.fs_context, io_ctx->file_handle, c->offset, ra_buf(io_ctx, i),
+                                        c->len) == 0)
+            c->state = VAL_RA_PENDING;
+        io_ctx->ra.next_read += c->len;
+        io_ctx->ra.count++;
+    }
+}
+
+// Copy [offset, offset + len) out of the ring. Returns 0 when part of the range is not held (the caller
+// reads it directly), -1 when the file came up short.
+static int ra_copy(val_sender_io_ctx_t *io_ctx, uint64_t offset, uint8_t *dst, size_t len)
+{
+    size_t done = 0;
+    while (done < len)
+    {
+        uint64_t pos = offset + done;
+        uint32_t k = 0;
+        for (; k < io_ctx->ra.count; ++k)
+        {
+            val_tx_ra_chunk_t *c = &io_ctx->ra.chunk[(io_ctx->ra.head + k) % io_ctx->ra.nchunks];
+            if (pos >= c->offset && pos < c->offset + io_ctx->ra.chunk_len && pos < io_ctx->ra.next_read)
+                break;
+        }
+        if (k == io_ctx->ra.count)
+            return 0;
+        uint32_t i = (io_ctx->ra.head + k) % io_ctx->ra.nchunks;
+        val_tx_ra_chunk_t *c = &io_ctx->ra.chunk[i];
+        if (c->state == VAL_RA_PENDING)
+            ra_complete(io_ctx, i);
+        else if (c->state == VAL_RA_ASSIGNED)
+        {
+            c->len = (uint32_t)read_at(io_ctx, c->offset, ra_buf(io_ctx, i), c->len);
+            c->state = VAL_RA_READY;
+        }
+        if (pos >= c->offset + c->len)
+            return -1;
+        size_t n = (size_t)(c->offset + c->len - pos);
+        if (n > len - done)
+            n = len - done;
+        memcpy(dst + done, ra_buf(io_ctx, i) + (size_t)(pos - c->offset), n);
+        done += n;
+    }
+    return 1;
+}
+
+// Wait out reads still in flight (before the file handle is closed)
+static void ra_drain(val_sender_io_ctx_t *io_ctx)
+{
+    for (uint32_t k = 0; k < io_ctx->ra.count; ++k)
+    {
+        uint32_t i = (io_ctx->ra.head + k) % io_ctx->ra.nchunks;
+        if (io_ctx->ra.chunk[i].state == VAL_RA_PENDING)
+            ra_complete(io_ctx, i);
+    }
+    io_ctx->ra.count = 0;
+}
+
+// ---- Memory-mapped source (filesystem.map) ----
+// DATA is framed straight from the mapped pages: with transport.sendv the payload reaches the transport
+// without being copied, otherwise it is copied once into the frame. One mapping of up to VAL_MAP_SPAN bytes
+// is held and moved when a frame falls outside it; if the file cannot be mapped it is read as usual.
+
+static void map_release(val_sender_io_ctx_t *io_ctx)
+{
+    const val_config_t *cfg = io_ctx->session->config;
+    if (!io_ctx->map.addr)
+        return;
+    (void)cfg->filesystem.unmap(cfg->filesystem.fs_context, io_ctx->file_handle, io_ctx->map.addr, io_ctx->map.offset,
+                                io_ctx->map.len, io_ctx->map.len);
+    io_ctx->map.addr = NULL;
+}
+
+// [offset, offset + len) of the file in place, or NULL when the file is not mapped
+static const uint8_t *map_at(val_sender_io_ctx_t *io_ctx, uint64_t offset, size_t len)
+{
+    const val_config_t *cfg = io_ctx->session->config;
+    if (!cfg->filesystem.map || io_ctx->map.off)
+        return NULL;
+    if (!io_ctx->map.addr || offset < io_ctx->map.offset || offset + len > io_ctx->map.offset + io_ctx->map.len)
+    {
+        map_release(io_ctx);
+        uint64_t base = offset - (offset % VAL_MAP_ALIGN);
+        uint64_t rest = io_ctx->file_size - base;
+        size_t span = (rest < (uint64_t)VAL_MAP_SPAN) ? (size_t)rest : (size_t)VAL_MAP_SPAN;
+        if (offset + len > base + span)
+            return NULL;
+        io_ctx->map.addr = (uint8_t *)cfg->filesystem.map(cfg->filesystem.fs_context, io_ctx->file_handle, base, span,
+                                                           false);
+        if (!io_ctx->map.addr)
+        {
+            VAL_LOG_INFOF(io_ctx->session, "map: cannot map source at %llu, reading instead", (unsigned long long)base);
+            io_ctx->map.off = 1;
+            return NULL;
+        }
+        io_ctx->map.offset = base;
+        io_ctx->map.len = span;
+    }
+    return io_ctx->map.addr + (size_t)(offset - io_ctx->map.offset);
+}
+
+// Read [offset, offset + len) of the file into dst: from the mapping or the read-ahead ring when they hold
+// the range, else straight from the file
+static val_status_t read_payload(val_sender_io_ctx_t *io_ctx, uint64_t offset, uint8_t *dst, size_t len)
+{
+    const uint8_t *m = map_at(io_ctx, offset, len);
+    if (m)
+    {
+        memcpy(dst, m, len);
+        return VAL_OK;
+    }
+    if (io_ctx->ra.nchunks)
+    {
+        ra_fill(io_ctx);
+        int r = ra_copy(io_ctx, offset, dst, len);
+        if (r != 0)
+            return (r > 0) ? VAL_OK : VAL_ERR_IO;
+    }
+    return (read_at(io_ctx, offset, dst, len) == len) ? VAL_OK : VAL_ERR_IO;
+}
+
+// Send [offset, offset + len) as one DATA frame. A mapped range goes file-to-socket through transport.send_file
+// when provided (the mapping only feeds the trailer CRC), else out of the mapping in place; an unmapped range
+// is read into the frame's content area first.
+static val_status_t send_data_frame(val_sender_io_ctx_t *io_ctx, uint64_t offset, uint32_t len, int include_offset)
+{
+    val_session_t *s = io_ctx->session;
+    const uint8_t *payload = map_at(io_ctx, offset, len);
+    if (payload && s->config->transport.send_file)
+        return val_internal_send_data_file(s, io_ctx->file_handle, payload, len, offset, include_offset);
+    if (!payload)
+    {
+        if (read_payload(io_ctx, offset, io_ctx->payload_area, len) != VAL_OK)
+            return VAL_ERR_IO;
+        payload = io_ctx->payload_area;
+    }
+    return val_internal_send_packet_ex(s, VAL_PKT_DATA, payload, len, offset, include_offset);
+}
+
+// Close the source file once no read-ahead read still targets it
+static void close_source(val_sender_io_ctx_t *io_ctx)
+{
+    ra_drain(io_ctx);
+    map_release(io_ctx);
+    io_ctx->session->config->filesystem.fclose(io_ctx->session->config->filesystem.fs_context, io_ctx->file_handle);
+}
+
+// ---- Per-packet tracking: one slot per outstanding DATA packet ----
+// Every DATA send is timestamped in s->tracking_slots so each ACK yields an RTT sample from the packet it
+// acknowledged; selective repeat (VAL_FEAT_SACK) also drives its retransmissions from these slots.
+
+// Grow the slot table towards 'want' slots (doubling, never beyond the negotiated window). The table starts
+// small at session create so that a large window cap costs memory only once the window actually opens.
+// Returns the resulting capacity; on allocation failure the table keeps its size and bounds the window.
+static uint32_t track_reserve(val_session_t *s, uint32_t want)
+{
+    uint32_t limit = s->negotiated_window_packets;
+    if (want > limit)
+        want = limit;
+    if (want <= s->max_tracking_slots)
+        return s->max_tracking_slots;
+    uint32_t n = s->max_tracking_slots ? s->max_tracking_slots : 1u;
+    while (n < want)
+        n = (n > limit / 2u) ? limit : n * 2u;
+    const val_memory_allocator_t *A = &s->cfg.tx_flow.allocator;
+    size_t sz = sizeof(val_inflight_packet_t) * (size_t)n;
+    val_inflight_packet_t *grown = (A->alloc && A->free) ? (val_inflight_packet_t *)A->alloc(sz, A->context)
+                                                         : (val_inflight_packet_t *)malloc(sz);
+    if (!grown)
+    {
+        VAL_LOG_WARNF(s, "track: cannot grow to %u slots; window bounded at %u", (unsigned)n,
+                      (unsigned)s->max_tracking_slots);
+        return s->max_tracking_slots;
+    }
+    size_t used = sizeof(val_inflight_packet_t) * (size_t)s->max_tracking_slots;
+    memcpy(grown, s->tracking_slots, used);
+    memset((uint8_t *)grown + used, 0, sz - used);
+    if (A->alloc && A->free)
+        A->free(s->tracking_slots, A->context);
+    else
+        free(s->tracking_slots);
+    VAL_LOG_DEBUGF(s, "track: %u -> %u slots", (unsigned)s->max_tracking_slots, (unsigned)n);
+    s->tracking_next = s->max_tracking_slots;
+    s->tracking_slots = grown;
+    s->max_tracking_slots = n;
+    return n;
+}
+
+// Record a sent packet. A packet overlapping an older slot is a retransmission (after a Go-Back-N rewind
+// the segmentation may shift): the old slot is dropped and the new one inherits its retransmit count, so
+// Karn's rule keeps ambiguous ACKs out of the RTT estimate. Fresh data past tracking_high cannot overlap,
+// so it skips the overlap scan and takes the next free slot round robin (slots free in send order, so the
+// search usually stops at the first one).
+static void track_sent(val_session_t *s, uint64_t offset, uint32_t len)
+{
+    val_inflight_packet_t *free_slot = NULL;
+    uint8_t retransmits = 0;
+    uint32_t n = s->max_tracking_slots;
+    if (offset >= s->tracking_high)
+    {
+        for (uint32_t k = 0; k < n && !free_slot; ++k)
+        {
+            uint32_t i = (s->tracking_next + k) % n;
+            if (s->tracking_slots[i].state == VAL_SLOT_FREE)
+            {
+                free_slot = &s->tracking_slots[i];
+                s->tracking_next = (i + 1u) % n;
+            }
+        }
+    }
+    for (uint32_t i = 0; offset < s->tracking_high && i < n; ++i)
+    {
+        val_inflight_packet_t *slot = &s->tracking_slots[i];
+        if (slot->state != VAL_SLOT_FREE && slot->file_offset < offset + len &&
+            offset < slot->file_offset + slot->payload_length)
+        {
+            if (slot->retransmit_count >= retransmits)
+                retransmits = (uint8_t)((slot->retransmit_count < 0xFFu) ? slot->retransmit_count + 1u : 0xFFu);
+            slot->state = VAL_SLOT_FREE;
+        }
+        if (slot->state == VAL_SLOT_FREE && !free_slot)
+            free_slot = slot;
+    }
+    if (!free_slot && track_reserve(s, n + 1u) > n)
+        free_slot = &s->tracking_slots[n];
+    if (!free_slot)
+        return;
+    if (offset + len > s->tracking_high)
+        s->tracking_high = offset + len;
+    free_slot->sequence = s->next_seq_to_send++;
+    free_slot->file_offset = offset;
+    free_slot->payload_length = len;
+    free_slot->send_timestamp = s->config->system.get_ticks_ms();
+    free_slot->retransmit_count = retransmits;
+    free_slot->state = VAL_SLOT_SENT;
+}
+
+static uint32_t track_outstanding(val_session_t *s)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < s->max_tracking_slots; ++i)
+        n += (s->tracking_slots[i].state != VAL_SLOT_FREE) ? 1u : 0u;
+    return n;
+}
+
+// Apply a DATA_ACK: release slots below the cumulative offset, mark slots inside SACK blocks, and take
+// one RTT sample from the most recently sent packet this ACK newly covers, unless it was retransmitted
+// (Karn). Returns the end of the highest SACKed range (0 when none): unSACKed slots below it are holes.
+static uint64_t track_on_ack(val_session_t *s, uint64_t cum, const uint8_t *blocks, uint32_t nblocks)
+{
+    uint64_t sack_high = 0;
+    for (uint32_t b = 0; b < nblocks; ++b)
+    {
+        uint64_t end = cum + VAL_GET_LE32(blocks + b * 8u) + VAL_GET_LE32(blocks + b * 8u + 4u);
+        if (end > sack_high)
+            sack_high = end;
+    }
+    const val_inflight_packet_t *newest = NULL;
+    uint32_t newest_ts = 0;
+    uint32_t now = s->config->system.get_ticks_ms();
+    for (uint32_t i = 0; i < s->max_tracking_slots; ++i)
+    {
+        val_inflight_packet_t *slot = &s->tracking_slots[i];
+        if (slot->state == VAL_SLOT_FREE)
+            continue;
+        uint8_t was = slot->state;
+        uint64_t end = slot->file_offset + slot->payload_length;
+        if (end <= cum)
+        {
+            slot->state = VAL_SLOT_FREE;
+        }
+        else
+        {
+            for (uint32_t b = 0; b < nblocks; ++b)
+            {
+                uint64_t bs = cum + VAL_GET_LE32(blocks + b * 8u);
+                uint64_t be = bs + VAL_GET_LE32(blocks + b * 8u + 4u);
+                if (slot->file_offset >= bs && end <= be)
+                    slot->state = VAL_SLOT_SACKED;
+            }
+        }
+        // Newly acknowledged (cumulatively or selectively) and never retransmitted: an unambiguous sample
+        if (was == VAL_SLOT_SENT && slot->state != VAL_SLOT_SENT && slot->retransmit_count == 0 &&
+            (!newest || (int32_t)(slot->send_timestamp - newest_ts) > 0))
+        {
+            newest = slot;
+            newest_ts = slot->send_timestamp;
+        }
+    }
+    if (newest)
+        val_internal_record_rtt(s, now - newest_ts);
+    return sack_high;
+}
+
+// Sender pacing rate in bytes per second (0 = unpaced): the controller's own rate when it has one (BBR),
+// else per tx_flow.pacing_mode, capped by tx_flow.pacing_rate_bps when set
+static uint32_t pacing_rate(val_session_t *s, uint32_t frame_bytes)
+{
+    const val_tx_flow_config_t *f = &s->config->tx_flow;
+    uint64_t rate = val_internal_cc_pacing_rate(s);
+    if (rate == 0)
+    {
+        if (f->pacing_mode == VAL_PACING_WINDOW && s->timing.srtt_ms)
+            rate = (uint64_t)val_internal_cc_cwnd(s) * frame_bytes * 1250u / s->timing.srtt_ms; // 1.25 x cwnd/SRTT
+        else if (f->pacing_mode == VAL_PACING_LINK_RATE)
+            rate = f->pacing_rate_bps / 8u;
+    }
+    if (rate && f->pacing_rate_bps && rate > f->pacing_rate_bps / 8u)
+        rate = f->pacing_rate_bps / 8u;
+    if (rate > 0xFFFFFFFFu)
+        rate = 0xFFFFFFFFu;
+    return (uint32_t)rate;
+}
+
+// Pacing clock in microseconds: system.get_ticks_us when provided, else the millisecond clock scaled
+static uint32_t pacing_now_us(val_session_t *s)
+{
+    if (s->config->system.get_ticks_us)
+        return s->config->system.get_ticks_us();
+    return s->config->system.get_ticks_ms() * 1000u;
+}
+
+static void pacing_sleep_us(val_session_t *s, uint32_t us)
+{
+    const val_config_t *c = s->config;
+    if (c->system.delay_us)
+    {
+        c->system.delay_us(us);
+        return;
+    }
+    if (!c->system.get_ticks_us)
+    {
+        c->system.delay_ms((us + 999u) / 1000u);
+        return;
+    }
+    // Whole milliseconds asleep, the sub-millisecond remainder by polling the microsecond clock
+    uint32_t start = c->system.get_ticks_us();
+    if (us >= 1000u)
+        c->system.delay_ms(us / 1000u);
+    while ((uint32_t)(c->system.get_ticks_us() - start) < us)
+    {
+    }
+}
+
+static void pacing_refill(val_session_t *s, uint32_t rate, uint32_t now_us)
+{
+    uint32_t elapsed = now_us - s->pacing.last_us;
+    if (elapsed > 1000000u)
+        elapsed = 1000000u;
+    s->pacing.tokens += (uint64_t)rate * elapsed / 1000000u;
+    s->pacing.last_us = now_us;
+}
+
+// Pacing layer between the window fill and the transport: a token bucket refilled at pacing_rate() that
+// holds one frame or 1 ms worth on a microsecond clock (two frames or 2 ms on the millisecond clock),
+// whichever is more. Waits until one frame's worth is available and returns how many of 'want' frames may
+// go out back to back now.
+static uint32_t pace_frames(val_session_t *s, uint32_t frame_bytes, uint32_t want)
+{
+    uint32_t rate = (want && frame_bytes) ? pacing_rate(s, frame_bytes) : 0u;
+    if (rate == 0)
+        return want;
+    int fine = s->config->system.get_ticks_us ? 1 : 0;
+    uint64_t cap = (uint64_t)rate * (fine ? 1u : 2u) / 1000u;
+    if (cap < (uint64_t)frame_bytes * (fine ? 1u : 2u))
+        cap = (uint64_t)frame_bytes * (fine ? 1u : 2u);
+    pacing_refill(s, rate, pacing_now_us(s));
+    if (s->pacing.tokens > cap)
+        s->pacing.tokens = cap;
+    if (s->pacing.tokens < frame_bytes)
+    {
+        uint64_t wait = ((uint64_t)(frame_bytes - s->pacing.tokens) * 1000000u + rate - 1u) / rate;
+        pacing_sleep_us(s, (uint32_t)wait);
+        pacing_refill(s, rate, pacing_now_us(s));
+        // A clock coarser than the wait must not stall the sender
+        if (s->pacing.tokens < frame_bytes)
+            s->pacing.tokens = frame_bytes;
+    }
+    uint64_t n = s->pacing.tokens / frame_bytes;
+    if (n > want)
+        n = want;
+    s->pacing.tokens -= n * frame_bytes;
+    return (uint32_t)n;
+}
+
+static val_status_t sr_resend_slot(val_sender_io_ctx_t *io_ctx, val_inflight_packet_t *slot)
+{
+    val_session_t *s = io_ctx->session;
+    // Retransmissions share the pacing budget so a burst of holes does not overrun the link again
+    (void)pace_frames(s, (uint32_t)(s->effective_packet_size ? s->effective_packet_size : s->config->buffers.packet_size), 1u);
+    // A retransmission is worth immediate feedback: ask the receiver not to delay its ACK
+    s->tx_data_flags = VAL_DATA_ACK_NOW;
+    val_status_t st = send_data_frame(io_ctx, slot->file_offset, slot->payload_length, 1);
+    s->tx_data_flags = 0;
+    if (st != VAL_OK)
+        return st;
+    VAL_LOG_DEBUGF(s, "data(sr): retransmit off=%llu len=%u", (unsigned long long)slot->file_offset,
+                   (unsigned)slot->payload_length);
+    slot->send_timestamp = s->config->system.get_ticks_ms();
+    if (slot->retransmit_count < 0xFFu)
+        slot->retransmit_count++;
+    val_metrics_inc_retrans(s);
+    return VAL_OK;
+}
+
+// Retransmit holes: unSACKed slots below sack_high, once right away and then at most once per RTO.
+// With 'all' set (ACK timeout / NAK) every unSACKed slot is due; if none is left, the lowest slot is
+// resent so the receiver answers with a fresh ACK.
+static val_status_t sr_retransmit(val_sender_io_ctx_t *io_ctx, uint64_t sack_high, int all)
+{
+    val_session_t *s = io_ctx->session;
+    uint32_t now = s->config->system.get_ticks_ms();
+    uint32_t rto = val_internal_get_timeout(s, VAL_OP_DATA_ACK);
+    val_inflight_packet_t *lowest = NULL;
+    int sent = 0, sack_loss = 0;
+    for (uint32_t i = 0; i < s->max_tracking_slots; ++i)
+    {
+        val_inflight_packet_t *slot = &s->tracking_slots[i];
+        if (slot->state == VAL_SLOT_FREE)
+            continue;
+        if (!lowest || slot->file_offset < lowest->file_offset)
+            lowest = slot;
+        if (slot->state != VAL_SLOT_SENT)
+            continue;
+        int due = all || (slot->file_offset + slot->payload_length <= sack_high &&
+                          (slot->retransmit_count == 0 || (uint32_t)(now - slot->send_timestamp) >= rto));
+        if (!due)
+            continue;
+        if (!all && slot->retransmit_count == 0)
+            sack_loss = 1;
+        val_status_t st = sr_resend_slot(io_ctx, slot);
+        if (st != VAL_OK)
+            return st;
+        sent = 1;
+    }
+    // A hole newly reported below SACKed data is a loss event for the congestion controller (the
+    // timeout and NAK callers record their own)
+    if (sack_loss)
+        val_internal_record_transmission_error(s);
+    if (all && !sent && lowest)
+        return sr_resend_slot(io_ctx, lowest);
+    return VAL_OK;
+}
+
 static val_status_t send_data_packet(val_sender_io_ctx_t *io_ctx, uint64_t *next_to_send, uint32_t *inflight, int include_offset)
 {
     if (!io_ctx || !io_ctx->session || !io_ctx->file_handle || !io_ctx->payload_area || !next_to_send || !inflight)
         return VAL_ERR_INVALID_ARG;
     val_session_t *s = io_ctx->session;
-    if (!s->config || !s->config->filesystem.fread)
+    if (!s->config || (!s->config->filesystem.fread && !s->config->filesystem.pread))
         return VAL_ERR_INVALID_ARG;
     if (io_ctx->max_payload == 0)
         return VAL_ERR_INVALID_ARG;
     if (*next_to_send >= io_ctx->file_size)
         return VAL_OK;
+    if (io_ctx->selective)
+        include_offset = 1;
 
     uint64_t remaining = io_ctx->file_size - *next_to_send;
     size_t max_payload_this_pkt = io_ctx->max_payload;
@@ -279,27 +901,7 @@ static val_status_t send_data_packet(val_sender_io_ctx_t *io_ctx, uint64_t *next
     if (to_read == 0)
         return VAL_OK;
 
-    // Assume sequential IO; only seek if our tracked position differs
-    // Use tracked cursor to avoid redundant ftell/fseek; only seek if needed
-    if (io_ctx->file_cursor != *next_to_send)
-    {
-        (void)s->config->filesystem.fseek(s->config->filesystem.fs_context, io_ctx->file_handle, (int64_t)(*next_to_send), SEEK_SET);
-        io_ctx->file_cursor = *next_to_send;
-    }
-
-    size_t have = 0;
-    while (have < to_read)
-    {
-        size_t r = s->config->filesystem.fread(s->config->filesystem.fs_context, io_ctx->payload_area + have, 1,
-                                               to_read - have, io_ctx->file_handle);
-        if (r == 0)
-            break;
-        have += r;
-    }
-    if (have != to_read)
-        return VAL_ERR_IO;
-
-    val_status_t st = val_internal_send_packet_ex(s, VAL_PKT_DATA, io_ctx->payload_area, (uint32_t)to_read, *next_to_send, include_offset);
+    val_status_t st = send_data_frame(io_ctx, *next_to_send, (uint32_t)to_read, include_offset);
     if (st != VAL_OK)
         return st;
 
@@ -307,13 +909,57 @@ static val_status_t send_data_packet(val_sender_io_ctx_t *io_ctx, uint64_t *next
                    (unsigned long long)*next_to_send,
                    include_offset ? "(explicit off)" : "(implied)");
 
+    track_sent(s, *next_to_send, (uint32_t)to_read);
     *next_to_send += to_read;
-    io_ctx->file_cursor += to_read;
     ++(*inflight);
     // Wire audit removed
     return VAL_OK;
 }
 
+// Batched window fill: frame up to 'budget' DATA packets back to back in buffers.tx_batch_buffer, reading each
+// payload straight into its frame slot, and hand them to the transport in one call. Only the first frame
+// may carry an explicit offset (restart point); the rest use implied offsets as on the per-packet path,
+// except under selective repeat where every frame names its offset.
+static val_status_t send_data_batch(val_sender_io_ctx_t *io_ctx, uint64_t *next_to_send, uint32_t *inflight,
+                                    uint32_t budget, int first_include_offset, int fills_window)
+{
+    val_session_t *s = io_ctx->session;
+    uint8_t *batch = (uint8_t *)s->config->buffers.tx_batch_buffer;
+    size_t cap = s->config->buffers.tx_batch_size;
+    size_t used = 0;
+    uint32_t count = 0;
+    uint64_t next = *next_to_send;
+    while (count < budget && next < io_ctx->file_size)
+    {
+        int include_offset = io_ctx->selective ? 1 : ((count == 0) ? first_include_offset : 0);
+        size_t max_payload_this_pkt = io_ctx->max_payload - (include_offset ? 8u : 0u);
+        uint64_t remaining = io_ctx->file_size - next;
+        size_t to_read = (size_t)((remaining < (uint64_t)max_payload_this_pkt) ? remaining : (uint64_t)max_payload_this_pkt);
+        size_t prefix = val_internal_data_frame_prefix(s, (uint32_t)to_read, include_offset);
+        if (used + prefix + to_read + VAL_WIRE_TRAILER_SIZE > cap)
+            break;
+        if (read_payload(io_ctx, next, batch + used + prefix, to_read) != VAL_OK)
+            return VAL_ERR_IO;
+        // The frame that fills the window is followed by an ACK wait
+        s->tx_data_flags = (fills_window && count + 1u == budget) ? VAL_DATA_ACK_NOW : 0u;
+        used += val_internal_seal_data_frame(s, batch + used, (uint32_t)to_read, next, include_offset);
+        s->tx_data_flags = 0;
+        track_sent(s, next, (uint32_t)to_read);
+        next += to_read;
+        ++count;
+    }
+    if (count == 0)
+        return send_data_packet(io_ctx, next_to_send, inflight, first_include_offset);
+    val_status_t st = val_internal_send_data_batch(s, batch, used, count, *next_to_send);
+    if (st != VAL_OK)
+        return st;
+    VAL_LOG_DEBUGF(s, "data(win): sent %u DATA frames (%zu bytes) in one batch from off=%llu", (unsigned)count, used,
+                   (unsigned long long)*next_to_send);
+    *next_to_send = next;
+    *inflight += count;
+    return VAL_OK;
+}
+
 static int handle_nak_retransmit(val_session_t *s, void *file_handle, uint64_t file_size, uint64_t *last_acked,
                                  uint64_t *next_to_send, uint32_t *inflight, const uint8_t *payload,
                                  uint32_t payload_len)
@@ -336,16 +982,36 @@ static int handle_nak_retransmit(val_session_t *s, void *file_handle, uint64_t f
     val_metrics_inc_timeout(s); // Ensure timeout metric is incremented for every retransmit
     s->timing.in_retransmit = 1;
 
-    long target_l = (long)(*last_acked);
-    int64_t curpos = s->config->filesystem.ftell(s->config->filesystem.fs_context, file_handle);
-    if (curpos < 0 || (uint64_t)curpos != *last_acked)
-        (void)s->config->filesystem.fseek(s->config->filesystem.fs_context, file_handle, (int64_t)target_l, SEEK_SET);
+    if (!s->config->filesystem.pread)
+    {
+        long target_l = (long)(*last_acked);
+        int64_t curpos = s->config->filesystem.ftell(s->config->filesystem.fs_context, file_handle);
+        if (curpos < 0 || (uint64_t)curpos != *last_acked)
+            (void)s->config->filesystem.fseek(s->config->filesystem.fs_context, file_handle, (int64_t)target_l, SEEK_SET);
+    }
 
     *inflight = 0;
     *next_to_send = *last_acked;
     return 1;
 }
 
+// Duplicate DATA_ACKs at the cumulative offset that trigger a fast retransmit (RFC 5681)
+#define VAL_DUPACK_THRESHOLD 3u
+
+// A NAK or duplicate-ACK rewind to 'at' is due unless the window was already rewound there within about a
+// round trip: the rest of the old window is still arriving behind the loss and reports the same gap
+static int fast_rewind_due(val_session_t *s, uint64_t at)
+{
+    uint32_t now = s->config->system.get_ticks_ms();
+    uint32_t hold = s->timing.srtt_ms ? 2u * s->timing.srtt_ms : s->config->timeouts.min_timeout_ms / 2u;
+    if (s->fast_rexmit.rewind_at == at && (uint32_t)(now - s->fast_rexmit.rewind_ms) < hold)
+        return 0;
+    s->fast_rexmit.rewind_at = at;
+    s->fast_rexmit.rewind_ms = now;
+    s->fast_rexmit.dupacks = 0;
+    return 1;
+}
+
 static void val_emit_progress_sender(val_session_t *s, val_send_progress_ctx_t *ctx, const char *filename,
                                      uint64_t bytes_sent, int force_emit)
 {
@@ -411,7 +1077,8 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
     val_packet_type_t t = 0;
     uint32_t len = 0;
     uint64_t off = 0;
-    uint8_t ctrl_buf[32];
+    uint8_t ctrl_buf[64]; // high32 + up to VAL_SACK_MAX_BLOCKS SACK blocks
+    int selective = (ack_ctx->io && ack_ctx->io->selective) ? 1 : 0;
 
     *restart_window = 0;
 
@@ -429,6 +1096,24 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
             if (t == VAL_PKT_CANCEL)
                 return VAL_ERR_ABORTED;
 
+            if (t == VAL_PKT_DATA_NAK && selective)
+            {
+                // Selective repeat never rewinds: resend what is still unSACKed and keep next_to_send
+                if (off > *ack_ctx->last_acked && off <= ack_ctx->file_size)
+                {
+                    *ack_ctx->last_acked = off;
+                    (void)track_on_ack(s, off, NULL, 0);
+                }
+                val_internal_record_transmission_error(s);
+                val_status_t rst = sr_retransmit(ack_ctx->io, 0, 1);
+                if (rst != VAL_OK)
+                    return rst;
+                *ack_ctx->inflight = track_outstanding(s);
+                *ack_ctx->window_size = val_internal_cc_cwnd(s);
+                *restart_window = 1;
+                return VAL_OK;
+            }
+
             if (t == VAL_PKT_DATA_NAK)
             {
                 // Core reconstructs next_expected into 'off' for NAK; adopt it if it advances our high-water
@@ -439,13 +1124,19 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
                     VAL_LOG_DEBUGF(s, "data(win): advance on NAK prev=%llu -> last_acked=%llu",
                                    (unsigned long long)prev, (unsigned long long)(*ack_ctx->last_acked));
                 }
+                if (!fast_rewind_due(s, *ack_ctx->last_acked))
+                {
+                    VAL_LOG_DEBUGF(s, "data(win): NAK at %llu already being repaired",
+                                   (unsigned long long)(*ack_ctx->last_acked));
+                    continue;
+                }
                 if (handle_nak_retransmit(s, ack_ctx->file_handle, ack_ctx->file_size, ack_ctx->last_acked,
                                           ack_ctx->next_to_send, ack_ctx->inflight, ctrl_buf, len))
                 {
                     if (ack_ctx->file_cursor_ptr)
                         *ack_ctx->file_cursor_ptr = *ack_ctx->last_acked;
                     // Update window size from session's current setting
-                    *ack_ctx->window_size = s->current_window_packets ? s->current_window_packets : 1u;
+                    *ack_ctx->window_size = val_internal_cc_cwnd(s);
                     if (*ack_ctx->window_size == 0u)
                         *ack_ctx->window_size = 1u;
                     *restart_window = 1;
@@ -459,25 +1150,80 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
                 // Treat any DATA_ACK (even stale) as a keepalive to extend streaming deadlines
                 if (s->config->system.get_ticks_ms)
                     s->last_keepalive_recv_time = s->config->system.get_ticks_ms();
-                if (ack_ctx->t0 && !s->timing.in_retransmit)
-                {
-                    uint32_t now = s->config->system.get_ticks_ms();
-                    val_internal_record_rtt(s, now - ack_ctx->t0);
-                }
                 if (ack_ctx->first_ack_grace_flag && *ack_ctx->first_ack_grace_flag)
                     *ack_ctx->first_ack_grace_flag = 0;
 
+                if (selective)
+                {
+                    // SACK blocks matter even when the cumulative offset did not move
+                    uint32_t nblocks = (len > 4u) ? (len - 4u) / 8u : 0u;
+                    if (nblocks > VAL_SACK_MAX_BLOCKS)
+                        nblocks = VAL_SACK_MAX_BLOCKS;
+                    uint64_t cum = (off > *ack_ctx->last_acked && off <= ack_ctx->file_size) ? off : *ack_ctx->last_acked;
+                    uint64_t sack_high = track_on_ack(s, cum, ctrl_buf + 4, nblocks);
+                    if (cum > *ack_ctx->last_acked)
+                    {
+                        if (!s->timing.in_retransmit)
+                            val_internal_cc_on_ack(s, (uint32_t)((cum - *ack_ctx->last_acked + ack_ctx->max_payload - 1u) /
+                                                                 ack_ctx->max_payload));
+                        *ack_ctx->last_acked = cum;
+                        ra_fill(ack_ctx->io);
+                        s->health.soft_trips = 0;
+                        val_emit_progress_sender(s, ack_ctx->progress_ctx, ack_ctx->filename, cum, 1);
+                        ack_ctx->tries = ack_ctx->tries_initial;
+                        ack_ctx->backoff = ack_ctx->backoff_initial;
+                        s->timing.in_retransmit = 0;
+                    }
+                    val_status_t rst = sr_retransmit(ack_ctx->io, sack_high, 0);
+                    if (rst != VAL_OK)
+                        return rst;
+                    if (val_check_for_cancel(s))
+                        return VAL_ERR_ABORTED;
+                    *ack_ctx->inflight = track_outstanding(s);
+                    if (*ack_ctx->last_acked >= ack_ctx->target_ack)
+                        return VAL_OK;
+                    if (*ack_ctx->next_to_send < ack_ctx->file_size && *ack_ctx->inflight < *ack_ctx->window_size &&
+                        *ack_ctx->inflight < s->max_tracking_slots)
+                    {
+                        *restart_window = 1;
+                        return VAL_OK;
+                    }
+                    continue;
+                }
+
                 if (off <= *ack_ctx->last_acked)
                 {
+                    // Duplicate ACKs at last_acked with data outstanding: the receiver is getting frames past
+                    // a loss. Rewind after VAL_DUPACK_THRESHOLD of them instead of waiting for the ACK timeout.
+                    if (off == *ack_ctx->last_acked && *ack_ctx->next_to_send > off &&
+                        ++s->fast_rexmit.dupacks >= VAL_DUPACK_THRESHOLD && fast_rewind_due(s, off))
+                    {
+                        VAL_LOG_DEBUGF(s, "data(win): fast retransmit from %llu after duplicate ACKs",
+                                       (unsigned long long)off);
+                        (void)handle_nak_retransmit(s, ack_ctx->file_handle, ack_ctx->file_size, ack_ctx->last_acked,
+                                                    ack_ctx->next_to_send, ack_ctx->inflight, NULL, 0);
+                        if (ack_ctx->file_cursor_ptr)
+                            *ack_ctx->file_cursor_ptr = *ack_ctx->last_acked;
+                        *ack_ctx->window_size = val_internal_cc_cwnd(s);
+                        *restart_window = 1;
+                        return VAL_OK;
+                    }
                     VAL_LOG_DEBUGF(s, "data(win): ignoring stale DATA_ACK off=%llu (<= last_acked=%llu)",
                                    (unsigned long long)off, (unsigned long long)(*ack_ctx->last_acked));
                     continue;
                 }
+                s->fast_rexmit.dupacks = 0;
 
+                // RTT sample from the newest packet this ACK covers (per-slot Karn's rule)
+                (void)track_on_ack(s, off, NULL, 0);
                 // Record success only when ACK advances our high-water mark (off > last_acked)
                 if (!s->timing.in_retransmit)
-                    val_internal_record_transmission_success(s);
+                    val_internal_cc_on_ack(s, (uint32_t)((off - *ack_ctx->last_acked + ack_ctx->max_payload - 1u) /
+                                                         ack_ctx->max_payload));
                 *ack_ctx->last_acked = off;
+                // Freed read-ahead chunks start their next reads now, while the window refills
+                if (ack_ctx->io)
+                    ra_fill(ack_ctx->io);
                 // Reset soft trip counter on real forward progress
                 s->health.soft_trips = 0;
                 if (ack_ctx->progress_ctx)
@@ -546,12 +1292,29 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
             val_metrics_inc_crcerr(s);
         if (st == VAL_ERR_TIMEOUT)
             val_metrics_inc_timeout(s);
+        if (selective)
+        {
+            // Selective repeat: resend outstanding unSACKed packets instead of rewinding the window
+            val_internal_record_transmission_error(s);
+            s->timing.in_retransmit = 1;
+            val_status_t rst = sr_retransmit(ack_ctx->io, 0, 1);
+            if (rst != VAL_OK)
+                return rst;
+            *ack_ctx->inflight = track_outstanding(s);
+            *ack_ctx->window_size = val_internal_cc_cwnd(s);
+            if (ack_ctx->tries)
+                --ack_ctx->tries;
+            ack_ctx->backoff = 0;
+            *restart_window = 1;
+            return VAL_OK;
+        }
         // Mark retransmit path and rewind sender state to last_acked
         val_internal_record_transmission_error(s);
         val_metrics_inc_retrans(s);
         s->timing.in_retransmit = 1;
         // Ensure underlying file position is rewound to last_acked so resend reads correct bytes
-        if (ack_ctx->file_handle && s->config && s->config->filesystem.ftell && s->config->filesystem.fseek)
+        if (ack_ctx->file_handle && s->config && !s->config->filesystem.pread && s->config->filesystem.ftell &&
+            s->config->filesystem.fseek)
         {
             int64_t pos = s->config->filesystem.ftell(s->config->filesystem.fs_context, ack_ctx->file_handle);
             if (pos < 0 || (uint64_t)pos != *ack_ctx->last_acked)
@@ -564,8 +1327,12 @@ static val_status_t wait_for_window_ack(val_sender_ack_ctx_t *ack_ctx, int *rest
             *ack_ctx->file_cursor_ptr = *ack_ctx->last_acked;
         *ack_ctx->inflight = 0;
         *ack_ctx->next_to_send = *ack_ctx->last_acked;
+        // Late NAKs and duplicate ACKs for this loss must not rewind again
+        s->fast_rexmit.rewind_at = *ack_ctx->last_acked;
+        s->fast_rexmit.rewind_ms = s->config->system.get_ticks_ms();
+        s->fast_rexmit.dupacks = 0;
         // Update window size from session (may have been adapted)
-        *ack_ctx->window_size = s->current_window_packets ? s->current_window_packets : 1u;
+        *ack_ctx->window_size = val_internal_cc_cwnd(s);
         if (*ack_ctx->window_size == 0u)
             *ack_ctx->window_size = 1u;
         // One try consumed; reset backoff boundedly and request restart
@@ -652,39 +1419,72 @@ static val_status_t await_resume_ack(val_session_t *s, uint64_t file_size,
     }
 }
 
-// Adaptive controller entrypoint - routes to appropriate sender based on negotiated mode
-static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepath, const char *sender_path, void *progress_ctx)
+// DONE once every byte is acknowledged, then DONE_ACK. Pipelined, the next file is announced (or EOT sent)
+// before the wait so its resume round trip overlaps it; the receiver answers those only after finishing this
+// file, so a RESUME_RESP or EOT_ACK arriving first acknowledges the DONE as well.
+static val_status_t send_done(val_session_t *s, uint64_t size, val_tx_pipeline_t *pipe)
 {
-    // Start with current bounded window; fallback to negotiated or 1
-    int mode_used_dummy = 0; // legacy placeholder removed
-    uint32_t win = s->current_window_packets ? s->current_window_packets : (s->negotiated_window_packets ? s->negotiated_window_packets : 1u);
-    // Use a simplified Go-Back-N cumulative ACK approach
-    // Gather meta
-    uint64_t size = 0;
-    char filename[VAL_MAX_FILENAME + 1];
-    VAL_LOG_INFOF(s, "send_file(win=%u): begin filepath='%s'", (unsigned)win, filepath ? filepath : "<null>");
-    val_status_t st = get_file_size_and_name(s, filepath, &size, filename);
+    val_status_t st = val_internal_send_packet(s, VAL_PKT_DONE, NULL, 0, size);
     if (st != VAL_OK)
         return st;
-    const char *reported_path = (sender_path && sender_path[0]) ? sender_path : filepath;
-    // Send metadata
-    st = send_metadata(s, reported_path, size, filename);
+    if (!pipe)
+        return val_internal_wait_done_ack(s, size);
+    if (pipe->next_path)
+        pipe->status = announce_file(s, pipe->next_path, pipe->sender_path, pipe->next);
+    else
+        pipe->status = val_internal_send_packet(s, VAL_PKT_EOT, NULL, 0, 0);
+    pipe->announced = (pipe->status == VAL_OK) ? 1 : 0;
+    if (!pipe->announced)
+        return val_internal_wait_done_ack(s, size);
+    val_packet_type_t t = 0;
+    uint8_t resp[VAL_WIRE_RESUME_RESP_SIZE];
+    uint32_t len = 0;
+    st = val_internal_wait_done_ack_pipelined(s, size, &t, resp, &len);
     if (st != VAL_OK)
         return st;
+    if (t == VAL_PKT_RESUME_RESP && pipe->next_path)
+    {
+        memcpy(pipe->next->resume_resp, resp, sizeof(resp));
+        pipe->next->resume_resp_len = len;
+    }
+    else if (t == VAL_PKT_EOT_ACK)
+    {
+        pipe->eot_acked = 1;
+    }
+    return VAL_OK;
+}
+
+// Adaptive controller entrypoint - routes to appropriate sender based on negotiated mode. tf was announced by
+// announce_file; pipe is NULL unless VAL_FEAT_PIPELINE is active. Closes tf's file.
+static val_status_t send_file_data_adaptive(val_session_t *s, val_tx_file_t *tf, val_tx_pipeline_t *pipe,
+                                            void *progress_ctx)
+{
+    // Start with current bounded window; fallback to negotiated or 1
+    int mode_used_dummy = 0; // legacy placeholder removed
+    uint32_t win = val_internal_cc_cwnd(s);
+    // Use a simplified Go-Back-N cumulative ACK approach
+    void *f = tf->file;
+    uint64_t size = tf->size;
+    const char *filename = tf->filename;
+    const char *reported_path = tf->reported_path;
+    VAL_LOG_INFOF(s, "send_file(win=%u): begin '%s'", (unsigned)win, filename);
     // Resume negotiation
     uint64_t resume_off = 0;
-    val_status_t rs = handle_resume_negotiation(s, size, filepath, &resume_off);
-    if (rs != VAL_OK) return rs;
+    val_status_t st = VAL_OK;
+    val_status_t rs = handle_resume_negotiation(s, tf, &resume_off);
+    if (rs != VAL_OK)
+    {
+        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+        return rs;
+    }
     // If receiver requested to skip this file entirely, resume_off is a sentinel (UINT64_MAX)
     if (resume_off == UINT64_MAX)
     {
+        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         if (s->config->callbacks.on_file_start)
             s->config->callbacks.on_file_start(filename, reported_path ? reported_path : "", size, size);
         // Send DONE and wait for DONE_ACK without sending any data
-        st = val_internal_send_packet(s, VAL_PKT_DONE, NULL, 0, size);
-        if (st != VAL_OK)
-            return st;
-        st = val_internal_wait_done_ack(s, size);
+        st = send_done(s, size, pipe);
         if (st != VAL_OK)
         {
             if (s->config->callbacks.on_file_complete)
@@ -696,15 +1496,6 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
         val_metrics_inc_files_sent(s);
         return VAL_OK;
     }
-    // Open file
-    void *f = s->config->filesystem.fopen(s->config->filesystem.fs_context, filepath, "rb");
-    if (!f)
-        return VAL_ERR_IO;
-    if (resume_off && s->config->filesystem.fseek(s->config->filesystem.fs_context, f, (int64_t)resume_off, SEEK_SET) != 0)
-    {
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
-        return VAL_ERR_IO;
-    }
     if (s->config->callbacks.on_file_start)
         s->config->callbacks.on_file_start(filename, reported_path ? reported_path : "", size, resume_off);
     if (progress_ctx)
@@ -725,9 +1516,11 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
         s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         return VAL_ERR_INVALID_ARG;
     }
+    // Read payloads straight into the frame's content area (after an extended header on jumbo MTUs)
+    size_t hdr_len = val_internal_frame_header_size(s, mtu_bytes - VAL_WIRE_HEADER_SIZE - VAL_WIRE_TRAILER_SIZE);
     uint8_t *send_buf_bytes = (uint8_t *)s->config->buffers.send_buffer;
-    uint8_t *payload_area = send_buf_bytes ? (send_buf_bytes + VAL_WIRE_HEADER_SIZE) : NULL;
-    size_t max_payload = (size_t)(mtu_bytes - VAL_WIRE_HEADER_SIZE - VAL_WIRE_TRAILER_SIZE);
+    uint8_t *payload_area = send_buf_bytes ? (send_buf_bytes + hdr_len) : NULL;
+    size_t max_payload = (size_t)(mtu_bytes - hdr_len - VAL_WIRE_TRAILER_SIZE);
     if (max_payload == 0)
     {
         s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
@@ -753,12 +1546,28 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
         s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         return VAL_ERR_INVALID_ARG;
     }
-    val_sender_io_ctx_t io_ctx = {s, f, payload_area, max_payload, size, resume_off};
+    val_sender_io_ctx_t io_ctx = {s, f, payload_area, max_payload, size, tf->file_cursor,
+                                  (s->negotiated_features & VAL_FEAT_SACK) ? 1 : 0, &last_acked, {0}, {0}};
+    ra_init(&io_ctx, resume_off);
+    // Per-file packet tracking starts empty
+    memset(s->tracking_slots, 0, sizeof(val_inflight_packet_t) * s->max_tracking_slots);
+    s->tracking_next = 0;
+    s->tracking_high = 0;
+    s->pacing.tokens = 0;
+    s->pacing.last_us = pacing_now_us(s);
+    s->fast_rexmit.rewind_at = UINT64_MAX;
+    s->fast_rexmit.dupacks = 0;
+    // Batch the window fill when the caller provided staging for at least two full frames
+    // Kernel file-to-socket sends go frame by frame
+    int use_batch = (s->config->buffers.tx_batch_buffer && s->config->buffers.tx_batch_size >= 2u * mtu_bytes &&
+                     !(s->config->transport.send_file && s->config->filesystem.map))
+                        ? 1
+                        : 0;
     while (last_acked < size)
     {
         if (val_check_for_cancel(s))
         {
-            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+            close_source(&io_ctx);
             if (s->config->callbacks.on_file_complete)
                 s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", VAL_ERR_ABORTED);
             VAL_LOG_WARN(s, "data(win): local cancel detected at loop top");
@@ -781,7 +1590,7 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
                 if (s->health.soft_trips >= 2)
                 {
                     VAL_LOG_CRIT(s, "health: repeated soft performance trips -> escalating to hard failure");
-                    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                    close_source(&io_ctx);
                     if (s->config->callbacks.on_file_complete)
                         s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", VAL_ERR_PERFORMANCE);
                     VAL_SET_PERFORMANCE_ERROR(s, VAL_ERROR_DETAIL_EXCESSIVE_RETRIES);
@@ -791,7 +1600,7 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
             }
             else
             {
-                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                close_source(&io_ctx);
                 if (s->config->callbacks.on_file_complete)
                     s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", health);
                 return health;
@@ -819,11 +1628,15 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
         {
             // Absolute and no-progress watchdogs inside inner loop as well
             // Fill window bounded by current window size
-            while (inflight < win && next_to_send < size)
+            // Selective repeat tracks every outstanding packet, so the slot table bounds the window too
+            uint32_t fill_cap = win;
+            if (io_ctx.selective && track_reserve(s, win) < fill_cap)
+                fill_cap = s->max_tracking_slots;
+            while (inflight < fill_cap && next_to_send < size)
             {
                 if (val_check_for_cancel(s))
                 {
-                    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                    close_source(&io_ctx);
                     if (s->config->callbacks.on_file_complete)
                         s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", VAL_ERR_ABORTED);
                     VAL_LOG_WARN(s, "data(win): local cancel during fill-window");
@@ -832,10 +1645,18 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
                 // Include explicit offset on first packet after resume or after a window restart due to NAK/timeout
                 int include_offset = (next_to_send == last_acked) ? 1 : 0;
                 // Ensure that when including offset, we don't exceed max wire size by reducing read size inside send function
-                val_status_t send_status = send_data_packet(&io_ctx, &next_to_send, &inflight, include_offset);
+                // Flag the frame that fills the window so the receiver ACKs it without its delayed-ACK wait
+                s->tx_data_flags = (inflight + 1u >= fill_cap) ? VAL_DATA_ACK_NOW : 0u;
+                // Pacing may let only part of the window go out now
+                uint32_t budget = pace_frames(s, (uint32_t)mtu_bytes, use_batch ? fill_cap - inflight : 1u);
+                val_status_t send_status =
+                    use_batch ? send_data_batch(&io_ctx, &next_to_send, &inflight, budget, include_offset,
+                                                inflight + budget >= fill_cap)
+                              : send_data_packet(&io_ctx, &next_to_send, &inflight, include_offset);
+                s->tx_data_flags = 0;
                 if (send_status != VAL_OK)
                 {
-                    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                    close_source(&io_ctx);
                     return send_status;
                 }
             }
@@ -843,7 +1664,6 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
             // No streaming fast-path; always proceed to ACK wait
 
             const uint64_t target_ack = next_to_send;
-            uint32_t t0 = s->config->system.get_ticks_ms();
             uint32_t wait_deadline = s->config->system.get_ticks_ms() + ack_timeout_ms;
             s->timing.in_retransmit = 0;
 
@@ -868,8 +1688,8 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
                 .backoff = backoff_ms,
                 .backoff_initial = (s->config->retries.backoff_ms_base ? s->config->retries.backoff_ms_base : 0),
                 .wait_deadline = wait_deadline,
-                .t0 = t0,
-                .file_cursor_ptr = &io_ctx.file_cursor
+                .file_cursor_ptr = &io_ctx.file_cursor,
+                .io = &io_ctx
             };
 
             int restart_window = 0;
@@ -878,7 +1698,7 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
             val_status_t ack_status = wait_for_window_ack(&ack_ctx, &restart_window);
             if (ack_status != VAL_OK)
             {
-                s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
+                close_source(&io_ctx);
                 if (ack_status == VAL_ERR_ABORTED)
                 {
                     if (s->config->callbacks.on_file_complete)
@@ -901,7 +1721,7 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
             if (restart_window)
             {
                 // Refresh win from session and continue
-                win = s->current_window_packets ? s->current_window_packets : 1u;
+                win = val_internal_cc_cwnd(s);
                 // Refill and continue waiting within this window using remaining tries
                 continue;
             }
@@ -909,27 +1729,15 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
             break;
         }
     }
-    // DONE/DONE_ACK
-    st = val_internal_send_packet(s, VAL_PKT_DONE, NULL, 0, size);
+    // DONE/DONE_ACK; every byte is acknowledged, so the source can go before the wait
+    close_source(&io_ctx);
+    st = send_done(s, size, pipe);
     if (st != VAL_OK)
     {
-        s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
         if (s->config->callbacks.on_file_complete)
             s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", st);
         return st;
     }
-    {
-        // Use centralized DONE_ACK wait helper
-        st = val_internal_wait_done_ack(s, size);
-        if (st != VAL_OK)
-        {
-            s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
-            if (s->config->callbacks.on_file_complete)
-                s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", st);
-            return st;
-        }
-    }
-    s->config->filesystem.fclose(s->config->filesystem.fs_context, f);
     if (s->config->callbacks.on_file_complete)
         s->config->callbacks.on_file_complete(filename, reported_path ? reported_path : "", VAL_OK);
     val_metrics_inc_files_sent(s);
@@ -941,7 +1749,11 @@ static val_status_t send_file_data_adaptive(val_session_t *s, const char *filepa
 val_status_t val_internal_send_file(val_session_t *s, const char *filepath, const char *sender_path, void *progress_ctx)
 {
     // Delegate to adaptive controller (which currently uses stop-and-wait path)
-    return send_file_data_adaptive(s, filepath, sender_path, progress_ctx);
+    val_tx_file_t tf;
+    val_status_t st = announce_file(s, filepath, sender_path, &tf);
+    if (st != VAL_OK)
+        return st;
+    return send_file_data_adaptive(s, &tf, NULL, progress_ctx);
 }
 
 // --- Legacy stop-and-wait implementation moved behind a helper ---
@@ -967,30 +1779,52 @@ val_status_t val_send_files(val_session_t *s, const char *const *filepaths, size
     val_send_progress_ctx_t prog;
     memset(&prog, 0, sizeof(prog));
     prog.total_files = (uint32_t)file_count;
-    // Pre-scan sizes to compute total_bytes; if any file missing size, we best-effort compute
-    for (size_t i = 0; i < file_count; ++i)
+    // Pre-scan sizes to compute total_bytes; if any file missing size, we best-effort compute. Only progress
+    // reports use the total, so there is no scan without on_progress or when the caller opted out of it.
+    if (s->config->callbacks.on_progress && !s->config->callbacks.progress_skip_prescan)
     {
-        uint64_t sz = 0;
-        char tmpname[VAL_MAX_FILENAME + 1];
-        if (get_file_size_and_name(s, filepaths[i], &sz, tmpname) == VAL_OK)
-            prog.batch_total_bytes += sz;
+        for (size_t i = 0; i < file_count; ++i)
+        {
+            uint64_t sz = 0;
+            if (get_file_size(s, filepaths[i], NULL, &sz) == VAL_OK)
+                prog.batch_total_bytes += sz;
+        }
     }
     prog.start_ms = s->config->system.get_ticks_ms();
+    // Pipelined (VAL_FEAT_PIPELINE): each DONE is followed by the next file's SEND_META + RESUME_REQ, or by EOT
+    // after the last file, so one file's announcement is in flight while the previous one is acknowledged
+    int pipelined = (s->negotiated_features & VAL_FEAT_PIPELINE) ? 1 : 0;
+    val_tx_file_t tf[2];
+    unsigned cur = 0;
+    int announced = 0, eot_sent = 0, eot_acked = 0;
     for (size_t i = 0; i < file_count; ++i)
     {
         VAL_LOG_INFOF(s, "send_files: sending [%u/%u] '%s'", (unsigned)(i + 1), (unsigned)file_count,
                       filepaths[i] ? filepaths[i] : "<null>");
-        val_status_t st = val_internal_send_file(s, filepaths[i], sender_path, &prog);
+        val_tx_pipeline_t pipe = {(i + 1 < file_count) ? filepaths[i + 1] : NULL, sender_path, &tf[cur ^ 1u], 0, 0,
+                                  VAL_OK};
+        val_status_t st = announced ? VAL_OK : announce_file(s, filepaths[i], sender_path, &tf[cur]);
+        if (st == VAL_OK)
+            st = send_file_data_adaptive(s, &tf[cur], pipelined ? &pipe : NULL, &prog);
         VAL_LOG_INFOF(s, "send_files: result for '%s' = %d", filepaths[i] ? filepaths[i] : "<null>", (int)st);
+        if (st != VAL_OK && pipe.announced && pipe.next_path)
+            s->config->filesystem.fclose(s->config->filesystem.fs_context, tf[cur ^ 1u].file);
+        // The next file could not be announced behind the DONE: it fails as it would have on its own turn
+        if (st == VAL_OK && pipelined && pipe.next_path && !pipe.announced)
+            st = pipe.status;
         if (st != VAL_OK)
         {
             VAL_LOG_ERRORF(s, "send_file failed %d", (int)st);
             val_internal_unlock(s);
             return st;
         }
+        announced = (pipe.announced && pipe.next_path) ? 1 : 0;
+        eot_sent = (pipe.announced && !pipe.next_path) ? 1 : 0;
+        eot_acked = pipe.eot_acked;
+        cur ^= 1u;
     }
     // Send EOT and wait for ACK automatically
-    val_status_t st = val_internal_send_packet(s, VAL_PKT_EOT, NULL, 0, 0);
+    val_status_t st = eot_sent ? VAL_OK : val_internal_send_packet(s, VAL_PKT_EOT, NULL, 0, 0);
     if (st != VAL_OK)
     {
         VAL_LOG_ERRORF(s, "send EOT failed %d", (int)st);
@@ -998,7 +1832,8 @@ val_status_t val_send_files(val_session_t *s, const char *const *filepaths, size
         return st;
     }
     // Use centralized EOT_ACK wait helper
-    st = val_internal_wait_eot_ack(s);
+    if (!eot_acked)
+        st = val_internal_wait_eot_ack(s);
     if (st != VAL_OK)
     {
         val_internal_unlock(s);
@@ -44,6 +44,22 @@ void val_deserialize_frame_header(const uint8_t *wiredata, uint8_t *type, uint8_
     if (type_data) *type_data = VAL_GET_LE32(wiredata + 4);
 }
 
+void val_serialize_frame_header_ext(uint8_t type, uint8_t flags, uint32_t content_len, uint32_t type_data, uint8_t *wiredata)
+{
+    if (!wiredata)
+        return;
+    val_serialize_frame_header(type, (uint8_t)(flags | VAL_FRAME_EXT_LEN), (uint16_t)VAL_WIRE_STD_MAX_CONTENT, type_data,
+                               wiredata);
+    VAL_PUT_LE32(wiredata + VAL_WIRE_HEADER_SIZE, content_len);
+}
+
+uint32_t val_deserialize_frame_ext_len(const uint8_t *wiredata)
+{
+    if (!wiredata)
+        return 0;
+    return VAL_GET_LE32(wiredata + VAL_WIRE_HEADER_SIZE);
+}
+
 void val_serialize_handshake(const val_handshake_t *hs, uint8_t *wire_data)
 {
     if (!hs || !wire_data)
@@ -67,9 +83,9 @@ void val_serialize_handshake(const val_handshake_t *hs, uint8_t *wire_data)
     VAL_PUT_LE16(wire_data + 32, hs->supported_features16);
     VAL_PUT_LE16(wire_data + 34, hs->required_features16);
     VAL_PUT_LE16(wire_data + 36, hs->requested_features16);
-    wire_data[38] = 0;
-    wire_data[39] = 0;
-    VAL_PUT_LE32(wire_data + 40, hs->reserved2);
+    wire_data[38] = hs->window_shift;
+    wire_data[39] = hs->reserved3;
+    VAL_PUT_LE32(wire_data + 40, hs->rx_max_window_bytes);
 }
 
 void val_deserialize_handshake(const uint8_t *wire_data, val_handshake_t *hs)
@@ -94,7 +110,9 @@ void val_deserialize_handshake(const uint8_t *wire_data, val_handshake_t *hs)
     hs->supported_features16 = VAL_GET_LE16(wire_data + 32);
     hs->required_features16 = VAL_GET_LE16(wire_data + 34);
     hs->requested_features16 = VAL_GET_LE16(wire_data + 36);
-    hs->reserved2 = VAL_GET_LE32(wire_data + 40);
+    hs->window_shift = wire_data[38];
+    hs->reserved3 = wire_data[39];
+    hs->rx_max_window_bytes = VAL_GET_LE32(wire_data + 40);
 }
 
 void val_serialize_meta(const val_meta_payload_t *meta, uint8_t *wire_data)
@@ -0,0 +1,143 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies batched DATA transmission via buffers.tx_batch_buffer: the window fill hands several DATA
+// frames to one transport.send call, every frame in a batch is well formed (header length + trailer
+// CRC line up back to back), capture still sees one record per frame, and the file arrives intact.
+
+static unsigned g_data_sends = 0;
+static unsigned g_data_frames = 0;
+static unsigned g_max_batch = 0;
+static unsigned g_bad_batches = 0;
+static unsigned g_captured_data = 0;
+
+static int batch_inspect(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        unsigned frames = 0;
+        size_t at = 0;
+        while (at + VAL_WIRE_HEADER_SIZE <= len)
+        {
+            uint8_t t = 0, flags = 0;
+            uint16_t clen = 0;
+            uint32_t td = 0;
+            val_deserialize_frame_header(p + at, &t, &flags, &clen, &td);
+            size_t frame_len = VAL_WIRE_HEADER_SIZE + clen + VAL_WIRE_TRAILER_SIZE;
+            if (t != VAL_PKT_DATA || at + frame_len > len)
+                break;
+            at += frame_len;
+            frames++;
+        }
+        if (at != len)
+            g_bad_batches++;
+        g_data_sends++;
+        g_data_frames += frames;
+        if (frames > g_max_batch)
+            g_max_batch = frames;
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static void on_capture(void *ctx, const val_packet_record_t *rec)
+{
+    (void)ctx;
+    if (rec->direction == VAL_DIR_TX && rec->type == VAL_PKT_DATA)
+        g_captured_data++;
+}
+
+static int run_case(const char *name, uint32_t requested)
+{
+    const size_t packet = 2048, depth = 64;
+    const size_t file_size = 200 * 1024 + 99;
+    const size_t batch_size = 16 * packet;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    uint8_t *batch = (uint8_t *)calloc(1, batch_size);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = batch_inspect;
+    cfg_tx.buffers.tx_batch_buffer = batch;
+    cfg_tx.buffers.tx_batch_size = batch_size;
+    cfg_tx.features.requested = requested;
+    cfg_tx.capture.on_packet = on_capture;
+    cfg_tx.tx_flow.window_cap_packets = 16;
+    cfg_rx.tx_flow.window_cap_packets = 16;
+
+    g_data_sends = g_data_frames = g_max_batch = g_bad_batches = g_captured_data = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    if (g_max_batch < 2 || g_data_sends >= g_data_frames || g_bad_batches != 0 || g_captured_data != g_data_frames)
+    {
+        fprintf(stderr, "%s: sends=%u frames=%u max_batch=%u bad=%u captured=%u\n", name, g_data_sends, g_data_frames,
+                g_max_batch, g_bad_batches, g_captured_data);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(batch);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "batch_send");
+
+    int fails = 0;
+    fails += run_case("batch_send_ieee", 0u);
+    fails += run_case("batch_send_crc32c", VAL_FEAT_CRC32C);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("batch_send: PASS\n");
+        return 0;
+    }
+    printf("batch_send: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,185 @@
+#include "test_support.h"
+#include "val_internal.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies the pluggable sender congestion controller (tx_flow.congestion_control): on a clean link
+// CUBIC's slow start reaches the negotiated cap within one file while AIMD is still creeping up, CUBIC
+// backs off on loss (selective repeat keeps the output intact) and regrows, and an unknown controller
+// is rejected at session create.
+
+#define WINDOW 64u
+
+static val_session_t *g_tx = NULL;
+static unsigned g_data_frames = 0;
+static unsigned g_drop_every = 0;
+static uint64_t g_high_sent = 0;
+static unsigned g_drops = 0;
+static uint32_t g_max_cwnd = 0;
+static uint32_t g_regrow_from = 0; // lowest window seen after the first reduction (0 = none yet)
+static uint32_t g_regrow_max = 0;  // highest window seen after that low point
+
+static int cwnd_probe_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (g_tx && len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        uint32_t w = val_internal_cc_cwnd(g_tx);
+        if (w < g_max_cwnd && (g_regrow_from == 0 || w < g_regrow_from))
+            g_regrow_from = g_regrow_max = w;
+        if (g_regrow_from && w > g_regrow_max)
+            g_regrow_max = w;
+        if (w > g_max_cwnd)
+            g_max_cwnd = w;
+
+        g_data_frames++;
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        // Drop only first transmissions: an offset below the high-water mark is a resend
+        uint64_t off = (flags & VAL_DATA_OFFSET_PRESENT) ? VAL_GET_LE64(p + VAL_WIRE_HEADER_SIZE) : 0u;
+        int fresh = (off >= g_high_sent);
+        if (fresh)
+            g_high_sent = off + 1u;
+        if (fresh && g_drop_every && (g_data_frames % g_drop_every) == 0u)
+        {
+            g_drops++;
+            return (int)len;
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, uint8_t cc, unsigned drop_every, uint32_t min_peak, uint32_t max_peak)
+{
+    const size_t packet = 2048, depth = 128;
+    const size_t file_size = 768 * 1024 + 5;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    uint8_t *reorder = (uint8_t *)calloc(WINDOW, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = cwnd_probe_send;
+    cfg_tx.tx_flow.congestion_control = cc;
+    cfg_tx.tx_flow.window_cap_packets = WINDOW;
+    cfg_rx.tx_flow.window_cap_packets = WINDOW;
+    if (drop_every)
+    {
+        cfg_tx.features.requested = VAL_FEAT_SACK;
+        cfg_rx.buffers.rx_reorder_buffer = reorder;
+        cfg_rx.buffers.rx_reorder_size = WINDOW * packet;
+    }
+
+    g_data_frames = g_drops = 0;
+    g_high_sent = 0;
+    g_drop_every = drop_every;
+    g_max_cwnd = g_regrow_from = g_regrow_max = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    g_tx = tx;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+    g_tx = NULL;
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    int ok = g_max_cwnd >= min_peak && g_max_cwnd <= max_peak;
+    // Under loss the window must come down and then climb back above its low point
+    if (drop_every)
+        ok = ok && g_drops > 0 && g_regrow_from > 0 && g_regrow_max > g_regrow_from;
+    if (!ok)
+    {
+        fprintf(stderr, "%s: peak=%u low=%u regrow=%u drops=%u frames=%u\n", name, (unsigned)g_max_cwnd,
+                (unsigned)g_regrow_from, (unsigned)g_regrow_max, g_drops, g_data_frames);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(reorder);
+    test_duplex_free(&d);
+    return fails;
+}
+
+static int test_unknown_controller(void)
+{
+    const size_t packet = 2048;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, 4);
+    uint8_t *sb = (uint8_t *)calloc(1, packet), *rb = (uint8_t *)calloc(1, packet);
+    val_config_t cfg;
+    ts_make_config(&cfg, sb, rb, packet, &d, VAL_RESUME_NEVER, 0);
+    cfg.tx_flow.congestion_control = 0xEE;
+    val_session_t *s = NULL;
+    val_status_t st = val_session_create(&cfg, &s, NULL);
+    int fails = 0;
+    if (st != VAL_ERR_INVALID_ARG || s != NULL)
+    {
+        fprintf(stderr, "unknown controller: create returned %d\n", (int)st);
+        fails++;
+        if (s)
+            val_session_destroy(s);
+    }
+    free(sb);
+    free(rb);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "congestion_control");
+
+    int fails = 0;
+    // AIMD adds one packet per recovery_success_threshold ACKs: far from the cap after ~400 packets
+    fails += run_case("cc_aimd_clean", VAL_CC_AIMD, 0u, 1u, WINDOW / 2u);
+    fails += run_case("cc_cubic_clean", VAL_CC_CUBIC, 0u, WINDOW, WINDOW);
+    fails += run_case("cc_cubic_loss", VAL_CC_CUBIC, 97u, WINDOW / 4u, WINDOW);
+    fails += test_unknown_controller();
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("congestion_control: PASS\n");
+        return 0;
+    }
+    printf("congestion_control: FAIL (%d)\n", fails);
+    return 1;
+}
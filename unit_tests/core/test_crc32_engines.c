@@ -0,0 +1,181 @@
+#include "val_protocol.h"
+#include "val_internal.h"
+#include "test_support.h"
+#include <stdio.h>
+#include <string.h>
+
+// Bit-at-a-time reference, independent of the table-driven engines under test.
+static uint32_t ref_crc32(const uint8_t *p, size_t len)
+{
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i)
+    {
+        c ^= p[i];
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+static uint32_t ref_crc32c(const uint8_t *p, size_t len)
+{
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i)
+    {
+        c ^= p[i];
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1u) ? (0x82F63B78u ^ (c >> 1)) : (c >> 1);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+static int check_engine(val_crc32_impl_t impl, const uint8_t *buf, size_t buf_len)
+{
+    if (val_crc32_set_impl(impl) != VAL_OK)
+    {
+        printf("crc32_engines: impl %d not available\n", (int)impl);
+        return 1;
+    }
+    if (val_crc32_get_impl() != impl)
+        return 1;
+    if (val_crc32("123456789", 9) != 0xCBF43926u || val_crc32c("123456789", 9) != 0xE3069283u)
+    {
+        printf("crc32_engines: impl %d check value mismatch\n", (int)impl);
+        return 1;
+    }
+    // All alignments and lengths around the 8/16-byte strides, plus a large block
+    for (size_t off = 0; off < 16; ++off)
+    {
+        for (size_t len = 0; len <= 300; ++len)
+        {
+            if (val_crc32(buf + off, len) != ref_crc32(buf + off, len) ||
+                val_crc32c(buf + off, len) != ref_crc32c(buf + off, len))
+            {
+                printf("crc32_engines: impl %d mismatch off=%zu len=%zu\n", (int)impl, off, len);
+                return 1;
+            }
+        }
+    }
+    if (val_crc32(buf + 3, buf_len - 3) != ref_crc32(buf + 3, buf_len - 3) ||
+        val_crc32c(buf + 3, buf_len - 3) != ref_crc32c(buf + 3, buf_len - 3))
+        return 1;
+    // Incremental API must match one-shot across arbitrary split points
+    uint32_t st = val_crc32_init_state();
+    st = val_crc32_update_state(st, buf, 5);
+    st = val_crc32_update_state(st, buf + 5, 1000);
+    st = val_crc32_update_state(st, buf + 1005, buf_len - 1005);
+    if (val_crc32_finalize_state(st) != ref_crc32(buf, buf_len))
+    {
+        printf("crc32_engines: impl %d incremental mismatch\n", (int)impl);
+        return 1;
+    }
+    return 0;
+}
+
+// crc(A||B) from crc(A), crc(B) and |B|, across split points including empty halves
+static int check_combine(const uint8_t *buf, size_t buf_len)
+{
+    static const size_t splits[] = {0, 1, 7, 16, 255, 1000, 4096};
+    for (size_t i = 0; i < sizeof(splits) / sizeof(splits[0]); ++i)
+    {
+        size_t a = splits[i] < buf_len ? splits[i] : buf_len;
+        size_t b = buf_len - a;
+        if (val_crc32_combine(ref_crc32(buf, a), ref_crc32(buf + a, b), b) != ref_crc32(buf, buf_len) ||
+            val_crc32c_combine(ref_crc32c(buf, a), ref_crc32c(buf + a, b), b) != ref_crc32c(buf, buf_len))
+        {
+            printf("crc32_engines: combine mismatch split=%zu\n", a);
+            return 1;
+        }
+        // Combining the prefix CRC with the whole-buffer CRC strips the prefix
+        if (val_crc32_combine(ref_crc32(buf, a), ref_crc32(buf, buf_len), b) != ref_crc32(buf + a, b))
+        {
+            printf("crc32_engines: prefix strip mismatch split=%zu\n", a);
+            return 1;
+        }
+    }
+    // Long B (64 KiB of zeros) exercises the higher x^(2^k) operators
+    static const uint8_t zeros[64] = {0};
+    uint32_t zc = 0, st = val_crc32_init_state();
+    st = val_crc32_update_state(st, buf, 10);
+    for (int i = 0; i < 1024; ++i)
+    {
+        zc = val_crc32_combine(zc, val_crc32(zeros, sizeof(zeros)), sizeof(zeros));
+        st = val_crc32_update_state(st, zeros, sizeof(zeros));
+    }
+    if (val_crc32_combine(val_crc32(buf, 10), zc, 65536) != val_crc32_finalize_state(st))
+    {
+        printf("crc32_engines: long combine mismatch\n");
+        return 1;
+    }
+    return 0;
+}
+
+// |B| >= 2^29 bytes needs the x^(8*2^k) operators for k >= 29: B is 512 MiB of zeros followed by buf,
+// checked against CRCs computed straight over the data for both polynomials
+static int check_combine_huge(const uint8_t *buf, size_t buf_len)
+{
+    static const uint8_t zeros[65536] = {0};
+    const uint64_t zero_len = (uint64_t)1u << 29;
+    const uint64_t len_b = zero_len + buf_len;
+    uint32_t all = val_crc32_update_state(val_crc32_init_state(), buf, 10);
+    uint32_t all_c = val_crc32c_update_state(val_crc32_init_state(), buf, 10);
+    uint32_t b = val_crc32_init_state(), b_c = val_crc32_init_state();
+    for (uint64_t done = 0; done < zero_len; done += sizeof(zeros))
+    {
+        all = val_crc32_update_state(all, zeros, sizeof(zeros));
+        all_c = val_crc32c_update_state(all_c, zeros, sizeof(zeros));
+        b = val_crc32_update_state(b, zeros, sizeof(zeros));
+        b_c = val_crc32c_update_state(b_c, zeros, sizeof(zeros));
+    }
+    all = val_crc32_finalize_state(val_crc32_update_state(all, buf, buf_len));
+    all_c = val_crc32_finalize_state(val_crc32c_update_state(all_c, buf, buf_len));
+    b = val_crc32_finalize_state(val_crc32_update_state(b, buf, buf_len));
+    b_c = val_crc32_finalize_state(val_crc32c_update_state(b_c, buf, buf_len));
+    if (val_crc32_combine(val_crc32(buf, 10), b, len_b) != all ||
+        val_crc32c_combine(val_crc32c(buf, 10), b_c, len_b) != all_c)
+    {
+        printf("crc32_engines: huge combine mismatch crc32=%08x/%08x crc32c=%08x/%08x\n",
+               (unsigned)val_crc32_combine(val_crc32(buf, 10), b, len_b), (unsigned)all,
+               (unsigned)val_crc32c_combine(val_crc32c(buf, 10), b_c, len_b), (unsigned)all_c);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "crc32_engines");
+
+    static uint8_t buf[4099];
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < sizeof(buf); ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+
+    int fails = 0;
+    fails += check_engine(VAL_CRC32_IMPL_BYTEWISE, buf, sizeof(buf));
+    fails += check_engine(VAL_CRC32_IMPL_SLICE8, buf, sizeof(buf));
+    fails += check_engine(VAL_CRC32_IMPL_SLICE16, buf, sizeof(buf));
+    fails += check_combine(buf, sizeof(buf));
+    fails += check_combine_huge(buf, sizeof(buf));
+    // Hardware engine is optional: only exercised when the running CPU supports it
+    if (val_crc32_set_impl(VAL_CRC32_IMPL_HW) == VAL_OK)
+        fails += check_engine(VAL_CRC32_IMPL_HW, buf, sizeof(buf));
+    else
+        printf("crc32_engines: HW engine not available on this host\n");
+    // AUTO resolves to a concrete engine
+    fails += (val_crc32_set_impl(VAL_CRC32_IMPL_AUTO) == VAL_OK && val_crc32_get_impl() != VAL_CRC32_IMPL_AUTO) ? 0 : 1;
+    fails += (val_crc32_set_impl((val_crc32_impl_t)99) == VAL_ERR_INVALID_ARG) ? 0 : 1;
+
+    ts_cancel_timeout_guard(wd);
+
+    if (fails == 0)
+    {
+        printf("crc32_engines: PASS\n");
+        return 0;
+    }
+    printf("crc32_engines: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,133 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies VAL_FEAT_CRC32C negotiation: the feature activates when both sides support it and either
+// side asks for it, DATA trailers on the wire then carry CRC32C, and tail-verify resume still agrees.
+
+static int g_expect_crc32c = 0;
+static unsigned g_data_frames = 0;
+static unsigned g_bad_trailers = 0;
+
+static int send_check_trailer(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len > VAL_WIRE_HEADER_SIZE + VAL_WIRE_TRAILER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        uint32_t trailer = VAL_GET_LE32(p + len - VAL_WIRE_TRAILER_SIZE);
+        uint32_t want = g_expect_crc32c ? val_crc32c(p, len - VAL_WIRE_TRAILER_SIZE) : val_crc32(p, len - VAL_WIRE_TRAILER_SIZE);
+        g_data_frames++;
+        if (trailer != want)
+            g_bad_trailers++;
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, uint32_t tx_requested, uint32_t rx_required, uint32_t expect_mask, size_t partial_bytes)
+{
+    const size_t packet = 1024, depth = 32;
+    const size_t file_size = 64 * 1024 + 77;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+    if (partial_bytes)
+    {
+        // Pre-seed a correct prefix so the receiver resumes via tail verification
+        if (ts_write_pattern_file(outpath, partial_bytes) != 0)
+            return 1;
+    }
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_TAIL, 4096);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_TAIL, 4096);
+    cfg_tx.transport.send = send_check_trailer;
+    cfg_tx.features.requested = tx_requested;
+    cfg_rx.features.required = rx_required;
+
+    g_expect_crc32c = (expect_mask & VAL_FEAT_CRC32C) ? 1 : 0;
+    g_data_frames = 0;
+    g_bad_trailers = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    uint32_t neg_tx = 0xFFFFFFFFu, neg_rx = 0xFFFFFFFFu;
+    (void)val_get_negotiated_features(tx, &neg_tx);
+    (void)val_get_negotiated_features(rx, &neg_rx);
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    if (neg_tx != expect_mask || neg_rx != expect_mask)
+    {
+        fprintf(stderr, "%s: negotiated tx=0x%08X rx=0x%08X expected 0x%08X\n", name, (unsigned)neg_tx, (unsigned)neg_rx,
+                (unsigned)expect_mask);
+        fails++;
+    }
+    if (g_data_frames == 0 || g_bad_trailers != 0)
+    {
+        fprintf(stderr, "%s: data frames=%u bad trailers=%u\n", name, g_data_frames, g_bad_trailers);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "crc32c_negotiation");
+
+    int fails = 0;
+    if ((val_get_builtin_features() & VAL_FEAT_CRC32C) == 0 || val_crc32c("123456789", 9) != 0xE3069283u)
+        fails++;
+    // Nobody asks: baseline IEEE
+    fails += run_case("crc32c_off", 0u, 0u, 0u, 0);
+    // Sender requests, receiver merely supports
+    fails += run_case("crc32c_tx_req", VAL_FEAT_CRC32C, 0u, VAL_FEAT_CRC32C, 0);
+    // Receiver requires; resume with tail verification must use the same algorithm on both sides
+    fails += run_case("crc32c_rx_resume", 0u, VAL_FEAT_CRC32C, VAL_FEAT_CRC32C, 20000);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("crc32c_negotiation: PASS\n");
+        return 0;
+    }
+    printf("crc32c_negotiation: FAIL (%d)\n", fails);
+    return 1;
+}
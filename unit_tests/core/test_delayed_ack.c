@@ -0,0 +1,126 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies negotiated delayed ACKs: with the default stride the receiver covers several in-order DATA
+// packets per DATA_ACK (at most half as many ACKs as DATA frames), a peer advertising stride 1 keeps
+// per-packet ACKs, and a small sender window never stalls on the delayed-ACK timer (VAL_DATA_ACK_NOW).
+
+enum
+{
+    EXPECT_PER_PACKET,
+    EXPECT_COALESCED,
+    EXPECT_NO_STALL
+};
+
+static unsigned g_data_frames = 0;
+static unsigned g_data_acks = 0;
+
+static int counting_send_tx(void *ctx, const void *data, size_t len)
+{
+    if (len >= 1 && ((const uint8_t *)data)[0] == VAL_PKT_DATA)
+        g_data_frames++;
+    return test_tp_send(ctx, data, len);
+}
+
+static int counting_send_rx(void *ctx, const void *data, size_t len)
+{
+    if (len >= 1 && ((const uint8_t *)data)[0] == VAL_PKT_DATA_ACK)
+        g_data_acks++;
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, uint8_t tx_stride, uint16_t window, int expect)
+{
+    const size_t packet = 2048, depth = 64;
+    const size_t file_size = 400 * 1024 + 31;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = counting_send_tx;
+    cfg_rx.transport.send = counting_send_rx;
+    cfg_tx.tx_flow.ack_stride_packets = tx_stride;
+    cfg_tx.tx_flow.window_cap_packets = window;
+    cfg_tx.tx_flow.initial_cwnd_packets = window;
+    cfg_rx.tx_flow.window_cap_packets = window;
+
+    g_data_frames = g_data_acks = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    int ok = (expect == EXPECT_PER_PACKET) ? (g_data_acks >= g_data_frames)
+             : (expect == EXPECT_COALESCED) ? (g_data_acks * 2u <= g_data_frames)
+                                            : (elapsed < 1000u); // ~100 windows: a timer stall each would exceed this
+    if (g_data_frames == 0 || !ok)
+    {
+        fprintf(stderr, "%s: data=%u acks=%u elapsed=%ums\n", name, g_data_frames, g_data_acks, (unsigned)elapsed);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "delayed_ack");
+
+    int fails = 0;
+    fails += run_case("delayed_ack_default", 0u, 16u, EXPECT_COALESCED);
+    fails += run_case("delayed_ack_peer_stride1", 1u, 16u, EXPECT_PER_PACKET);
+    fails += run_case("delayed_ack_small_window", 0u, 2u, EXPECT_NO_STALL);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("delayed_ack: PASS\n");
+        return 0;
+    }
+    printf("delayed_ack: FAIL (%d)\n", fails);
+    return 1;
+}
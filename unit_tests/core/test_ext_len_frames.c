@@ -0,0 +1,131 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies VAL_FEAT_EXT_LEN: with a 1 MiB packet size on both sides DATA frames above 64 KiB use the
+// extended 12-byte header; when a peer does not advertise the feature (simulated by stripping it
+// from the HELLOs) the packet size is capped so content fits the 16-bit length field.
+
+static int g_strip_ext = 0;
+static unsigned g_ext_frames = 0;
+static size_t g_max_frame = 0;
+
+static int send_inspect(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len > g_max_frame)
+        g_max_frame = len;
+    if (len >= VAL_WIRE_HEADER_SIZE && (p[1] & VAL_FRAME_EXT_LEN))
+        g_ext_frames++;
+    if (g_strip_ext && p[0] == VAL_PKT_HELLO && len == VAL_WIRE_HEADER_SIZE + VAL_WIRE_HANDSHAKE_SIZE + VAL_WIRE_TRAILER_SIZE)
+    {
+        // Pretend this peer predates the feature: clear it from the advertised mask, re-seal the frame
+        uint8_t hello[VAL_WIRE_HEADER_SIZE + VAL_WIRE_HANDSHAKE_SIZE + VAL_WIRE_TRAILER_SIZE];
+        memcpy(hello, p, len);
+        uint8_t *features = hello + VAL_WIRE_HEADER_SIZE + 12;
+        VAL_PUT_LE32(features, VAL_GET_LE32(features) & ~VAL_FEAT_EXT_LEN);
+        VAL_PUT_LE32(hello + len - VAL_WIRE_TRAILER_SIZE, val_crc32(hello, len - VAL_WIRE_TRAILER_SIZE));
+        return test_tp_send(ctx, hello, len) == (int)len ? (int)len : -1;
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, int strip_ext, uint32_t expect_mask, size_t expect_packet)
+{
+    const size_t packet = 1024 * 1024, depth = 8;
+    const size_t file_size = 3 * 1024 * 1024 + 77;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = send_inspect;
+    cfg_rx.transport.send = send_inspect;
+
+    g_strip_ext = strip_ext;
+    g_ext_frames = 0;
+    g_max_frame = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    uint32_t neg = 0;
+    size_t eff = 0;
+    (void)val_get_negotiated_features(tx, &neg);
+    (void)val_get_effective_packet_size(tx, &eff);
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    if ((neg & VAL_FEAT_EXT_LEN) != expect_mask || eff != expect_packet)
+    {
+        fprintf(stderr, "%s: negotiated=0x%08X packet=%zu, expected ext=0x%08X packet=%zu\n", name, (unsigned)neg, eff,
+                (unsigned)expect_mask, expect_packet);
+        fails++;
+    }
+    // Extended headers appear exactly when the feature is active, and no frame exceeds the packet size
+    if ((expect_mask ? (g_ext_frames == 0) : (g_ext_frames != 0)) || g_max_frame > expect_packet)
+    {
+        fprintf(stderr, "%s: ext frames=%u max frame=%zu\n", name, g_ext_frames, g_max_frame);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "ext_len_frames");
+
+    int fails = 0;
+    if ((val_get_builtin_features() & VAL_FEAT_EXT_LEN) == 0)
+        fails++;
+    fails += run_case("ext_len_jumbo", 0, VAL_FEAT_EXT_LEN, 1024 * 1024);
+    fails += run_case("ext_len_legacy_peer", 1, 0u, VAL_WIRE_STD_MAX_PACKET);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("ext_len_frames: PASS\n");
+        return 0;
+    }
+    printf("ext_len_frames: FAIL (%d)\n", fails);
+    return 1;
+}
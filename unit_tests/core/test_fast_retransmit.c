@@ -0,0 +1,147 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies Go-Back-N loss recovery without waiting for the ACK timeout: with every 23rd fresh DATA frame
+// lost and a retransmission timeout of a second, the receiver places implied-offset frames by their offset
+// hint (no silent misplacement behind a loss), NAKs each gap once rather than once per frame, and the
+// sender rewinds on that NAK, or after three duplicate ACKs when the NAKs are lost too.
+
+#define DROP_EVERY 23u
+
+static unsigned g_fresh = 0;
+static unsigned g_drops = 0;
+static uint64_t g_high_sent = 0;
+static unsigned g_naks = 0;
+static int g_drop_naks = 0;
+
+static int lossy_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        // Offsets stay below 4 GiB here, so the hint is the whole implied offset
+        uint64_t off = (flags & VAL_DATA_OFFSET_PRESENT) ? VAL_GET_LE64(p + VAL_WIRE_HEADER_SIZE) : (uint64_t)td;
+        if (off >= g_high_sent)
+        {
+            g_high_sent = off + 1u;
+            if ((++g_fresh % DROP_EVERY) == 0u)
+            {
+                g_drops++;
+                return (int)len; // lost on the wire
+            }
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int nak_send(void *ctx, const void *data, size_t len)
+{
+    if (len >= 1 && ((const uint8_t *)data)[0] == VAL_PKT_DATA_NAK)
+    {
+        g_naks++;
+        if (g_drop_naks)
+            return (int)len;
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, int drop_naks)
+{
+    const size_t packet = 2048, depth = 64;
+    const size_t file_size = 300 * 1024 + 5;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = lossy_send;
+    cfg_rx.transport.send = nak_send;
+    cfg_tx.tx_flow.window_cap_packets = 16;
+    cfg_tx.tx_flow.initial_cwnd_packets = 16;
+    cfg_rx.tx_flow.window_cap_packets = 16;
+    // A timeout-driven recovery would cost a second per loss
+    cfg_tx.timeouts.min_timeout_ms = 1000;
+    cfg_tx.timeouts.max_timeout_ms = 2000;
+
+    g_fresh = g_drops = g_naks = 0;
+    g_high_sent = 0;
+    g_drop_naks = drop_naks;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    // One NAK per gap (a late frame may re-open one after the hold-off), never one per frame behind it
+    if (g_drops < 4u || elapsed >= 1000u * g_drops / 2u || g_naks > 2u * g_drops)
+    {
+        fprintf(stderr, "%s: drops=%u naks=%u elapsed=%ums\n", name, g_drops, g_naks, (unsigned)elapsed);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "fast_retransmit");
+
+    int fails = 0;
+    fails += run_case("fast_retransmit_nak", 0);
+    fails += run_case("fast_retransmit_dupack", 1);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("fast_retransmit: PASS\n");
+        return 0;
+    }
+    printf("fast_retransmit: FAIL (%d)\n", fails);
+    return 1;
+}
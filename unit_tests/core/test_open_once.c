@@ -0,0 +1,153 @@
+#include "test_support.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies that the sender opens each source file once: the size probe, the resume tail CRC and the data
+// share one handle, with one seek to the end and one back per file. The batch-size pre-scan in val_send_files
+// runs only for on_progress (adding one probe per file), and not at all with callbacks.progress_skip_prescan.
+
+#define NFILES 24
+#define PACKET 2048u
+
+static unsigned g_opens = 0;
+static unsigned g_seeks = 0;
+static uint64_t g_total_bytes = 0;
+static unsigned g_progress = 0;
+
+static void *counting_fopen(void *ctx, const char *path, const char *mode)
+{
+    g_opens++;
+    return ts_fopen(ctx, path, mode);
+}
+
+static int counting_fseek(void *ctx, void *file, int64_t offset, int whence)
+{
+    g_seeks++;
+    return ts_fseek(ctx, file, offset, whence);
+}
+
+static void on_progress(const val_progress_info_t *info)
+{
+    g_progress++;
+    if (info->total_bytes > g_total_bytes)
+        g_total_bytes = info->total_bytes;
+}
+
+static size_t file_size_of(unsigned i)
+{
+    return 1000u + i * 517u;
+}
+
+static int run_case(const char *name, unsigned nfiles, size_t prefix, int progress, int skip_prescan)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, depth);
+
+    char basedir[2048], outdir[2048];
+    static char inpaths[NFILES][2048], outpaths[NFILES][2048];
+    const char *files[NFILES];
+    uint64_t batch_bytes = 0;
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    for (unsigned i = 0; i < nfiles; ++i)
+    {
+        char fname[32];
+        snprintf(fname, sizeof(fname), "in%02u.bin", i);
+        if (ts_path_join(inpaths[i], sizeof(inpaths[i]), basedir, fname) != 0 ||
+            ts_path_join(outpaths[i], sizeof(outpaths[i]), outdir, fname) != 0)
+            return 1;
+        ts_remove_file(outpaths[i]);
+        size_t size = prefix ? prefix * 4u : file_size_of(i);
+        if (ts_write_pattern_file(inpaths[i], size) != 0 || (prefix && ts_write_pattern_file(outpaths[i], prefix) != 0))
+            return 1;
+        files[i] = inpaths[i];
+        batch_bytes += size;
+    }
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    val_resume_mode_t mode = prefix ? VAL_RESUME_TAIL : VAL_RESUME_NEVER;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, mode, 1024);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, mode, 1024);
+    cfg_tx.filesystem.fopen = counting_fopen;
+    cfg_tx.filesystem.fseek = counting_fseek;
+    if (progress)
+        cfg_tx.callbacks.on_progress = on_progress;
+    cfg_tx.callbacks.progress_skip_prescan = skip_prescan ? true : false;
+
+    g_opens = g_seeks = g_progress = 0;
+    g_total_bytes = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    val_status_t st = val_send_files(tx, files, nfiles, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    for (unsigned i = 0; i < nfiles; ++i)
+    {
+        if (!ts_files_equal(inpaths[i], outpaths[i]))
+        {
+            fprintf(stderr, "%s: output %u mismatch\n", name, i);
+            fails++;
+        }
+    }
+    // One open per file, plus one per file for the pre-scan when it runs
+    int prescan = progress && !skip_prescan;
+    unsigned want_opens = prescan ? 2u * nfiles : nfiles;
+    // Per file: size probe (end) and the first read (start); the tail CRC adds one. The pre-scan probe adds one.
+    unsigned max_seeks = nfiles * (2u + (prefix ? 1u : 0u) + (prescan ? 1u : 0u));
+    if (g_opens != want_opens || g_seeks > max_seeks)
+    {
+        fprintf(stderr, "%s: opens=%u (want %u) seeks=%u (max %u)\n", name, g_opens, want_opens, g_seeks, max_seeks);
+        fails++;
+    }
+    if (progress && (g_progress == 0 || g_total_bytes != (prescan ? batch_bytes : 0u)))
+    {
+        fprintf(stderr, "%s: progress=%u total_bytes=%llu\n", name, g_progress, (unsigned long long)g_total_bytes);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "open_once");
+
+    int fails = 0;
+    fails += run_case("open_once_batch", NFILES, 0, 0, 0);
+    fails += run_case("open_once_progress", NFILES, 0, 1, 0);
+    fails += run_case("open_once_no_prescan", NFILES, 0, 1, 1);
+    // Tail-verified resume: the CRC window is read through the same handle as the data
+    fails += run_case("open_once_resume", 2, 16u * 1024u + 5u, 0, 0);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("open_once: PASS\n");
+        return 0;
+    }
+    printf("open_once: FAIL (%d)\n", fails);
+    return 1;
+}
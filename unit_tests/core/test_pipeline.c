@@ -0,0 +1,192 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies pipelined batches (VAL_FEAT_PIPELINE): the sender announces each next file (SEND_META + RESUME_REQ),
+// and sends EOT after the last one, before the previous DONE_ACK arrives; without the feature it waits for it.
+// Also covers tail resume with a skipped and a verified file, and a lost DONE that the receiver infers from
+// the next SEND_META (skipped file) or EOT (last file). A DONE retried after its DONE_ACK and the next
+// RESUME_RESP were both lost must not complete the file announced behind it.
+
+#define PACKET 2048u
+#define FILE_COUNT 6
+#define DONE_ACK_DELAY_MS 15u
+
+static volatile unsigned g_done_acks = 0; // DONE_ACKs the receiver has put on the wire
+static unsigned g_metas = 0;
+static unsigned g_early = 0;              // SEND_META/EOT sent while the previous DONE was still unacknowledged
+static unsigned g_dones = 0;
+static unsigned g_drop_done = 0;          // 1-based DONE to lose, 0 = none
+static unsigned g_drops = 0;
+static unsigned g_drop_reply = 0;         // 1-based file whose DONE_ACK and the next file's RESUME_RESP are lost
+static unsigned g_replies = 0;
+static unsigned g_resps = 0;
+static unsigned g_reply_drops = 0;
+
+static int tx_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE)
+    {
+        if (p[0] == VAL_PKT_DONE && ++g_dones == g_drop_done)
+        {
+            g_drops++;
+            return (int)len;
+        }
+        if (p[0] == VAL_PKT_SEND_META || p[0] == VAL_PKT_EOT)
+        {
+            if (g_metas > 0 && g_done_acks < g_metas)
+                g_early++;
+            if (p[0] == VAL_PKT_SEND_META)
+                g_metas++;
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+// Holds each DONE_ACK back so a sender that waits for it cannot have announced the next file yet
+static int rx_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && g_drop_reply &&
+        ((p[0] == VAL_PKT_DONE_ACK && ++g_replies == g_drop_reply) ||
+         (p[0] == VAL_PKT_RESUME_RESP && ++g_resps == g_drop_reply + 1u)))
+    {
+        g_reply_drops++;
+        return (int)len;
+    }
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DONE_ACK)
+    {
+        ts_delay(DONE_ACK_DELAY_MS);
+        g_done_acks++; // before the send: the sender may act on it before this thread runs again
+        return test_tp_send(ctx, data, len);
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, int pipelined, int resume, unsigned drop_done, unsigned drop_reply)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, depth);
+
+    char basedir[2048], outdir[2048];
+    char inpaths[FILE_COUNT][2048], outpaths[FILE_COUNT][2048];
+    const char *files[FILE_COUNT];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    for (int i = 0; i < FILE_COUNT; ++i)
+    {
+        char fname[32];
+        snprintf(fname, sizeof(fname), "f%d.bin", i);
+        if (ts_path_join(inpaths[i], sizeof(inpaths[i]), basedir, fname) != 0 ||
+            ts_path_join(outpaths[i], sizeof(outpaths[i]), outdir, fname) != 0)
+            return 1;
+        ts_remove_file(outpaths[i]);
+        size_t size = 3000u + (size_t)i * 7919u;
+        if (ts_write_pattern_file(inpaths[i], size) != 0)
+            return 1;
+        // Resume: the first output is already complete (skipped), the second holds a prefix (verified tail)
+        if (resume && i == 0 && ts_write_pattern_file(outpaths[i], size) != 0)
+            return 1;
+        if (resume && i == 1 && ts_write_pattern_file(outpaths[i], size / 2u) != 0)
+            return 1;
+        files[i] = inpaths[i];
+    }
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    val_resume_mode_t mode = resume ? VAL_RESUME_TAIL : VAL_RESUME_NEVER;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, mode, 1024);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, mode, 1024);
+    cfg_tx.transport.send = tx_send;
+    cfg_rx.transport.send = rx_send;
+    if (pipelined)
+        cfg_tx.features.requested = VAL_FEAT_PIPELINE;
+
+    g_done_acks = 0;
+    g_metas = g_early = g_dones = g_drops = 0;
+    g_drop_done = drop_done;
+    g_drop_reply = drop_reply;
+    g_replies = g_resps = g_reply_drops = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, FILE_COUNT, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    for (int i = 0; i < FILE_COUNT; ++i)
+    {
+        if (!ts_files_equal(inpaths[i], outpaths[i]))
+        {
+            fprintf(stderr, "%s: output %d mismatch\n", name, i);
+            fails++;
+        }
+    }
+    // Pipelined, every announcement after the first and the EOT go out ahead of the DONE_ACK they follow
+    // (a re-sent DONE_ACK throws the count off, so not checked when replies are lost)
+    unsigned want_early = pipelined ? (unsigned)FILE_COUNT : 0u;
+    if (g_metas != FILE_COUNT || (!drop_reply && g_early != want_early) || g_drops != (drop_done ? 1u : 0u) ||
+        g_reply_drops != (drop_reply ? 2u : 0u))
+    {
+        fprintf(stderr, "%s: metas=%u early=%u (want %u) drops=%u reply_drops=%u\n", name, g_metas, g_early,
+                want_early, g_drops, g_reply_drops);
+        fails++;
+    }
+    // A lost DONE is recovered from the next packet, not from the DONE_ACK timeout
+    if (drop_done && elapsed >= cfg_tx.timeouts.max_timeout_ms)
+    {
+        fprintf(stderr, "%s: lost DONE took %ums\n", name, (unsigned)elapsed);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "pipeline");
+
+    int fails = 0;
+    fails += run_case("pipeline_off", 0, 0, 0, 0);
+    fails += run_case("pipeline_on", 1, 0, 0, 0);
+    fails += run_case("pipeline_resume", 1, 1, 0, 0);
+    // DONE of the skipped first file lost: the second SEND_META completes it
+    fails += run_case("pipeline_lost_done_skip", 1, 1, 1, 0);
+    // DONE of the last file lost: the EOT completes it
+    fails += run_case("pipeline_lost_done_last", 1, 0, FILE_COUNT, 0);
+    // First DONE_ACK and the second RESUME_RESP lost: the retried DONE reaches the second file's data loop
+    fails += run_case("pipeline_lost_replies", 1, 0, 0, 1);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("pipeline: PASS\n");
+        return 0;
+    }
+    printf("pipeline: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,179 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies the positional filesystem hooks (filesystem.pread / pwrite / fsize): a tail-verified resume over
+// a Go-Back-N link that loses every 23rd fresh DATA frame needs seeks on both sides without them (size
+// probes, the verify window, rewinds), and none at all once they are provided.
+
+#define PACKET 2048u
+#define FILE_SIZE (300u * 1024u + 5u)
+#define PREFIX_SIZE (64u * 1024u)
+#define TAIL_CAP 4096u
+#define DROP_EVERY 23u
+
+static unsigned g_seeks = 0;
+static unsigned g_tells = 0;
+static unsigned g_preads = 0;
+static unsigned g_pwrites = 0;
+static unsigned g_fresh = 0;
+static unsigned g_drops = 0;
+static uint64_t g_high_sent = 0;
+
+static int counting_fseek(void *ctx, void *file, int64_t offset, int whence)
+{
+    g_seeks++;
+    return ts_fseek(ctx, file, offset, whence);
+}
+
+static int64_t counting_ftell(void *ctx, void *file)
+{
+    g_tells++;
+    return ts_ftell(ctx, file);
+}
+
+static size_t counting_pread(void *ctx, void *file, void *buffer, size_t len, uint64_t offset)
+{
+    g_preads++;
+    return ts_pread(ctx, file, buffer, len, offset);
+}
+
+static size_t counting_pwrite(void *ctx, void *file, const void *buffer, size_t len, uint64_t offset)
+{
+    g_pwrites++;
+    return ts_pwrite(ctx, file, buffer, len, offset);
+}
+
+static int lossy_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        uint64_t off = (flags & VAL_DATA_OFFSET_PRESENT) ? VAL_GET_LE64(p + VAL_WIRE_HEADER_SIZE) : (uint64_t)td;
+        if (off >= g_high_sent)
+        {
+            g_high_sent = off + 1u;
+            if ((++g_fresh % DROP_EVERY) == 0u)
+            {
+                g_drops++;
+                return (int)len;
+            }
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+static void use_positional(val_config_t *cfg)
+{
+    cfg->filesystem.pread = counting_pread;
+    cfg->filesystem.pwrite = counting_pwrite;
+    cfg->filesystem.fsize = ts_fsize;
+}
+
+static int run_case(const char *name, int positional)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, FILE_SIZE) != 0 || ts_write_pattern_file(outpath, PREFIX_SIZE) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, VAL_RESUME_TAIL, TAIL_CAP);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, VAL_RESUME_TAIL, TAIL_CAP);
+    cfg_tx.transport.send = lossy_send;
+    cfg_tx.filesystem.fseek = cfg_rx.filesystem.fseek = counting_fseek;
+    cfg_tx.filesystem.ftell = cfg_rx.filesystem.ftell = counting_ftell;
+    if (positional)
+    {
+        use_positional(&cfg_tx);
+        use_positional(&cfg_rx);
+    }
+    cfg_tx.tx_flow.window_cap_packets = 16;
+    cfg_tx.tx_flow.initial_cwnd_packets = 16;
+    cfg_rx.tx_flow.window_cap_packets = 16;
+
+    g_seeks = g_tells = g_preads = g_pwrites = 0;
+    g_fresh = g_drops = 0;
+    g_high_sent = 0;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+    if (g_drops == 0)
+    {
+        fprintf(stderr, "%s: no frames dropped\n", name);
+        fails++;
+    }
+    // With the hooks every access carries its own offset; without them resume and rewinds have to seek
+    int bad = positional ? (g_seeks != 0 || g_tells != 0 || g_preads == 0 || g_pwrites == 0)
+                         : (g_seeks == 0 || g_preads != 0 || g_pwrites != 0);
+    if (bad)
+    {
+        fprintf(stderr, "%s: fseek=%u ftell=%u pread=%u pwrite=%u drops=%u\n", name, g_seeks, g_tells, g_preads,
+                g_pwrites, g_drops);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "positional_io");
+
+    int fails = 0;
+    fails += run_case("positional_io_seek", 0);
+    fails += run_case("positional_io_hooks", 1);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("positional_io: PASS\n");
+        return 0;
+    }
+    printf("positional_io: FAIL (%d)\n", fails);
+    return 1;
+}
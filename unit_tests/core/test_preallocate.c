@@ -0,0 +1,142 @@
+#include "test_support.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies filesystem.preallocate: the receiver reserves the announced file size right after opening the
+// output, without changing the file's size (a resumed file is still appended at its end), and a refused
+// reservation fails the transfer with VAL_ERROR_DETAIL_DISK_FULL before any data is written.
+
+#define FILE_SIZE (512u * 1024u + 9u)
+#define PREFIX_SIZE (128u * 1024u + 3u)
+
+static unsigned g_calls = 0;
+static uint64_t g_size_arg = 0;
+static int64_t g_size_at_call = -1;
+static int g_refuse = 0;
+static const char *g_outpath = NULL;
+
+static int checking_preallocate(void *ctx, void *file, uint64_t size)
+{
+    g_calls++;
+    g_size_arg = size;
+    if (g_refuse)
+        return -1;
+    int rc = ts_preallocate(ctx, file, size);
+    g_size_at_call = ts_fsize(ctx, g_outpath);
+    return rc;
+}
+
+static int run_case(const char *name, size_t prefix, int refuse)
+{
+    const size_t packet = 4096, depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, FILE_SIZE) != 0 || (prefix && ts_write_pattern_file(outpath, prefix) != 0))
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    val_resume_mode_t mode = prefix ? VAL_RESUME_TAIL : VAL_RESUME_NEVER;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, mode, 4096);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, mode, 4096);
+    cfg_rx.filesystem.preallocate = checking_preallocate;
+
+    g_calls = 0;
+    g_size_arg = 0;
+    g_size_at_call = -1;
+    g_refuse = refuse;
+    g_outpath = outpath;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (g_calls != 1 || g_size_arg != FILE_SIZE)
+    {
+        fprintf(stderr, "%s: preallocate calls=%u size=%llu\n", name, g_calls, (unsigned long long)g_size_arg);
+        fails++;
+    }
+    if (refuse)
+    {
+        // The sender hears about it from the receiver's ERROR, not from an ACK timeout
+        val_status_t code = VAL_OK;
+        uint32_t detail = 0;
+        (void)val_get_last_error(rx, &code, &detail);
+        int64_t out_size = ts_fsize(NULL, outpath);
+        if (st == VAL_OK || code != VAL_ERR_IO || !(detail & VAL_ERROR_DETAIL_DISK_FULL) || out_size != 0 ||
+            elapsed >= 1000u)
+        {
+            fprintf(stderr, "%s: send %d rx %d detail 0x%08X size %lld after %ums\n", name, (int)st, (int)code,
+                    (unsigned)detail, (long long)out_size, (unsigned)elapsed);
+            fails++;
+        }
+    }
+    else
+    {
+        if (st != VAL_OK)
+        {
+            fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+            fails++;
+        }
+        // Reserving space must not grow the file: the data is appended at the old end
+        if (g_size_at_call != (int64_t)prefix)
+        {
+            fprintf(stderr, "%s: file size %lld after preallocate, want %llu\n", name, (long long)g_size_at_call,
+                    (unsigned long long)prefix);
+            fails++;
+        }
+        if (!ts_files_equal(inpath, outpath))
+        {
+            fprintf(stderr, "%s: output mismatch\n", name);
+            fails++;
+        }
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "preallocate");
+
+    int fails = 0;
+    fails += run_case("preallocate_new", 0, 0);
+    fails += run_case("preallocate_resume", PREFIX_SIZE, 0);
+    fails += run_case("preallocate_full", 0, 1);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("preallocate: PASS\n");
+        return 0;
+    }
+    printf("preallocate: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,181 @@
+#include "test_support.h"
+#include "val_internal.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies the transport.recv_some read-ahead: queued control frames are parsed out of one transport
+// call, a frame cut short by a timeout stays buffered until the rest arrives, large DATA payloads
+// still land intact in the caller's buffer, and a full transfer works with read-ahead on both ends.
+
+#define PACKET 4096u
+
+static unsigned g_recv_some_calls = 0;
+
+static int counting_recv_some(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms)
+{
+    g_recv_some_calls++;
+    return test_tp_recv_some(ctx, buffer, buffer_size, received, timeout_ms);
+}
+
+static int check_frames(void)
+{
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, 64);
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *payload = (uint8_t *)calloc(1, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_rx.transport.recv_some = counting_recv_some;
+
+    int fails = 0;
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+
+    // 1) Sixteen queued ACKs: one transport call serves them all
+    for (uint64_t i = 0; i < 16; ++i)
+        (void)val_internal_send_packet(tx, VAL_PKT_DATA_ACK, NULL, 0, 1000u * (i + 1u) + ((uint64_t)i << 32));
+    g_recv_some_calls = 0;
+    for (uint64_t i = 0; i < 16; ++i)
+    {
+        val_packet_type_t t = 0;
+        uint64_t off = 0;
+        if (val_internal_recv_packet(rx, &t, NULL, 0, NULL, &off, 200) != VAL_OK || t != VAL_PKT_DATA_ACK ||
+            off != 1000u * (i + 1u) + ((uint64_t)i << 32))
+        {
+            fprintf(stderr, "readahead: ack %u mismatch\n", (unsigned)i);
+            fails++;
+            break;
+        }
+    }
+    if (g_recv_some_calls != 1)
+    {
+        fprintf(stderr, "readahead: %u transport calls for 16 ACKs\n", g_recv_some_calls);
+        fails++;
+    }
+
+    // 2) A frame split across a timeout is not lost
+    uint8_t frame[VAL_WIRE_HEADER_SIZE + 4 + VAL_WIRE_TRAILER_SIZE];
+    val_serialize_frame_header((uint8_t)VAL_PKT_DATA_ACK, 0, 4, 777u, frame);
+    VAL_PUT_LE32(frame + VAL_WIRE_HEADER_SIZE, 5u);
+    VAL_PUT_LE32(frame + VAL_WIRE_HEADER_SIZE + 4, val_crc32(frame, VAL_WIRE_HEADER_SIZE + 4));
+    test_fifo_push(d.a2b, frame, 5);
+    val_packet_type_t t = 0;
+    uint64_t off = 0;
+    if (val_internal_recv_packet(rx, &t, NULL, 0, NULL, &off, 30) != VAL_ERR_TIMEOUT)
+    {
+        fprintf(stderr, "readahead: partial frame did not time out\n");
+        fails++;
+    }
+    test_fifo_push(d.a2b, frame + 5, sizeof(frame) - 5);
+    if (val_internal_recv_packet(rx, &t, NULL, 0, NULL, &off, 200) != VAL_OK || off != (((uint64_t)5u << 32) | 777u))
+    {
+        fprintf(stderr, "readahead: split frame not recovered\n");
+        fails++;
+    }
+
+    // 3) Large DATA payload followed by an ACK in the same burst
+    uint8_t *src = sb_rx; // scratch; rx never sends here
+    for (uint32_t i = 0; i < 3000u; ++i)
+        src[i] = (uint8_t)(i * 7u + 3u);
+    (void)val_internal_send_packet(tx, VAL_PKT_DATA, src, 3000u, 123456u);
+    (void)val_internal_send_packet(tx, VAL_PKT_DATA_ACK, NULL, 0, 42u);
+    uint32_t len = 0;
+    if (val_internal_recv_packet(rx, &t, payload, PACKET, &len, &off, 200) != VAL_OK || t != VAL_PKT_DATA ||
+        len != 3000u || off != 123456u || memcmp(payload, src, 3000u) != 0)
+    {
+        fprintf(stderr, "readahead: DATA payload mismatch\n");
+        fails++;
+    }
+    if (val_internal_recv_packet(rx, &t, NULL, 0, NULL, &off, 200) != VAL_OK || t != VAL_PKT_DATA_ACK || off != 42u)
+    {
+        fprintf(stderr, "readahead: frame after DATA mismatch\n");
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(payload);
+    test_duplex_free(&d);
+    return fails;
+}
+
+static int check_transfer(void)
+{
+    const size_t file_size = 300 * 1024 + 5;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, 32);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs("recv_readahead", basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.recv_some = test_tp_recv_some;
+    cfg_rx.transport.recv_some = test_tp_recv_some;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK || !ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "readahead: transfer failed st=%d\n", (int)st);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "recv_readahead");
+
+    int fails = 0;
+    fails += check_frames();
+    fails += check_transfer();
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("recv_readahead: PASS\n");
+        return 0;
+    }
+    printf("recv_readahead: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,277 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies the receiver write-behind (buffers.rx_writebehind_buffer): on storage with a fixed latency per
+// write, chunked writes cut the number of writes, the async hooks (filesystem.write_submit/write_wait)
+// overlap them with receiving, VAL_ACK_ON_WRITE never acknowledges bytes whose write has not completed,
+// and a full disk still fails the transfer with VAL_ERROR_DETAIL_DISK_FULL whichever path wrote the data.
+
+#define STORAGE_MS 20u
+#define SERIALIZE_MS 4u
+#define PACKET 4096u
+#define WINDOW 4u // one write-behind chunk: a write that blocks the receive loop stalls the sender
+
+static unsigned g_writes = 0;
+static uint64_t g_written = 0;   // bytes whose write has completed
+static uint64_t g_disk_cap = 0;  // 0 = unlimited
+static uint64_t g_max_ack = 0;   // highest cumulative DATA_ACK offset sent by the receiver
+static unsigned g_ack_ahead = 0; // DATA_ACKs past the completed writes
+
+static size_t disk_room(size_t want)
+{
+    if (!g_disk_cap)
+        return want;
+    uint64_t left = (g_written < g_disk_cap) ? g_disk_cap - g_written : 0u;
+    return (want < left) ? want : (size_t)left;
+}
+
+static size_t counting_fwrite(void *ctx, const void *buffer, size_t size, size_t count, void *file)
+{
+    g_writes++;
+    size_t n = disk_room(size * count);
+    size_t put = n ? ts_fwrite(ctx, buffer, 1, n, file) : 0u;
+    g_written += put;
+    return size ? put / size : 0u;
+}
+
+static int counting_write_submit(void *ctx, void *file, uint64_t offset, const void *buffer, size_t len)
+{
+    g_writes++;
+    return ts_write_submit(ctx, file, offset, buffer, len);
+}
+
+static int counting_write_wait(void *ctx, void *file, const void *buffer, size_t *written, bool block)
+{
+    int rc = ts_write_wait(ctx, file, buffer, written, block);
+    if (rc == 0)
+    {
+        *written = disk_room(*written);
+        g_written += *written;
+    }
+    return rc;
+}
+
+static int slow_link_send(void *ctx, const void *data, size_t len)
+{
+    if (len >= 1 && ((const uint8_t *)data)[0] == VAL_PKT_DATA)
+        ts_delay(SERIALIZE_MS);
+    return test_tp_send(ctx, data, len);
+}
+
+static int ack_watch_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA_ACK)
+    {
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        // Offsets stay below 4 GiB here, so the header field is the whole cumulative offset
+        if (td > g_max_ack)
+            g_max_ack = td;
+        if (td > g_written)
+            g_ack_ahead++;
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+typedef struct
+{
+    size_t ring;       // write-behind buffer bytes (0 = off)
+    int async;         // write_submit/write_wait
+    uint8_t policy;    // val_ack_policy_t
+    uint64_t disk_cap; // bytes the disk takes before writes come up short (0 = unlimited)
+} wb_case_t;
+
+// Returns elapsed ms, or 0 on failure
+static uint32_t run_case(const char *name, size_t file_size, const wb_case_t *c, unsigned *out_writes)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 0;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 0;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 0;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *ring = c->ring ? (uint8_t *)calloc(1, c->ring) : NULL;
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = slow_link_send;
+    cfg_rx.transport.send = ack_watch_send;
+    cfg_rx.filesystem.fwrite = counting_fwrite;
+    cfg_rx.buffers.rx_writebehind_buffer = ring;
+    cfg_rx.buffers.rx_writebehind_size = c->ring;
+    if (c->async)
+    {
+        cfg_rx.filesystem.write_submit = counting_write_submit;
+        cfg_rx.filesystem.write_wait = counting_write_wait;
+    }
+    cfg_rx.tx_flow.ack_policy = c->policy;
+    cfg_tx.tx_flow.window_cap_packets = WINDOW;
+    cfg_tx.tx_flow.initial_cwnd_packets = WINDOW;
+    cfg_rx.tx_flow.window_cap_packets = WINDOW;
+    if (c->disk_cap)
+    {
+        // The receiver stops answering; keep the sender's give-up short
+        cfg_tx.timeouts.max_timeout_ms = 200;
+        cfg_tx.retries.ack_retries = 2;
+    }
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 0;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    g_writes = 0;
+    g_written = 0;
+    g_disk_cap = c->disk_cap;
+    g_max_ack = 0;
+    g_ack_ahead = 0;
+    ts_fs_set_write_latency_ms(STORAGE_MS);
+    const char *files[1] = {inpath};
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_join_thread(th);
+    ts_fs_set_write_latency_ms(0);
+
+    int ok = 1;
+    if (c->disk_cap)
+    {
+        val_status_t code = VAL_OK;
+        uint32_t detail = 0;
+        (void)val_get_last_error(rx, &code, &detail);
+        if (st == VAL_OK || code != VAL_ERR_IO || !(detail & VAL_ERROR_DETAIL_DISK_FULL))
+        {
+            fprintf(stderr, "%s: disk full not reported (send %d, rx %d detail 0x%08X)\n", name, (int)st, (int)code,
+                    (unsigned)detail);
+            ok = 0;
+        }
+    }
+    else
+    {
+        if (st != VAL_OK)
+        {
+            fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+            ok = 0;
+        }
+        if (!ts_files_equal(inpath, outpath))
+        {
+            fprintf(stderr, "%s: output mismatch\n", name);
+            ok = 0;
+        }
+    }
+    if (c->policy == VAL_ACK_ON_WRITE && (g_ack_ahead || g_max_ack != file_size))
+    {
+        fprintf(stderr, "%s: %u DATA_ACKs ahead of the disk (highest %llu)\n", name, g_ack_ahead,
+                (unsigned long long)g_max_ack);
+        ok = 0;
+    }
+    *out_writes = g_writes;
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(ring);
+    test_duplex_free(&d);
+    return ok ? (elapsed ? elapsed : 1u) : 0u;
+}
+
+// A lone write hook or an unknown ACK policy is rejected at session create
+static int check_invalid_config(void)
+{
+    uint8_t sb[1024], rb[1024];
+    test_duplex_t d;
+    test_duplex_init(&d, sizeof(sb), 4);
+    val_config_t cfg;
+    ts_make_config(&cfg, sb, rb, sizeof(sb), &d, VAL_RESUME_NEVER, 0);
+    int fails = 0;
+    val_session_t *s = NULL;
+    cfg.filesystem.write_submit = ts_write_submit;
+    if (val_session_create(&cfg, &s, NULL) != VAL_ERR_INVALID_ARG)
+    {
+        fprintf(stderr, "invalid_config: write_submit without write_wait accepted\n");
+        fails++;
+    }
+    cfg.filesystem.write_submit = NULL;
+    cfg.tx_flow.ack_policy = 0x7F;
+    if (val_session_create(&cfg, &s, NULL) != VAL_ERR_INVALID_ARG)
+    {
+        fprintf(stderr, "invalid_config: unknown ack policy accepted\n");
+        fails++;
+    }
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "recv_writebehind");
+
+    int fails = 0;
+    const size_t file_size = 256u * 1024u + 7u;
+    const size_t ring = 128u * 1024u; // 8 chunks of 16 KiB
+    const wb_case_t plain = {0, 0, VAL_ACK_ON_RECEIPT, 0};
+    const wb_case_t sync = {ring, 0, VAL_ACK_ON_RECEIPT, 0};
+    const wb_case_t async = {ring, 1, VAL_ACK_ON_RECEIPT, 0};
+    const wb_case_t on_write = {ring, 1, VAL_ACK_ON_WRITE, 0};
+    unsigned w_plain = 0, w_sync = 0, w_async = 0, w_on_write = 0, w_full = 0;
+    uint32_t t_plain = run_case("recv_writebehind_off", file_size, &plain, &w_plain);
+    uint32_t t_sync = run_case("recv_writebehind_sync", file_size, &sync, &w_sync);
+    uint32_t t_async = run_case("recv_writebehind_async", file_size, &async, &w_async);
+    uint32_t t_on_write = run_case("recv_writebehind_on_write", file_size, &on_write, &w_on_write);
+    if (!t_plain || !t_sync || !t_async || !t_on_write)
+        fails++;
+    // One write per 16 KiB chunk instead of one per frame
+    const unsigned chunks = (unsigned)((file_size + ring / 8u - 1u) / (ring / 8u));
+    if (w_sync > chunks || w_async > chunks || w_on_write > chunks || w_plain < 3u * chunks)
+    {
+        fprintf(stderr, "writes: plain=%u sync=%u async=%u on_write=%u (chunks %u)\n", w_plain, w_sync, w_async,
+                w_on_write, chunks);
+        fails++;
+    }
+    // Async writes run while frames keep arriving; the synchronous chunk writes stall the receive loop
+    if (t_sync * 2u > t_plain || t_async * 10u > t_sync * 9u)
+    {
+        fprintf(stderr, "timing: plain=%ums sync=%ums async=%ums\n", (unsigned)t_plain, (unsigned)t_sync,
+                (unsigned)t_async);
+        fails++;
+    }
+    // A disk that fills after 100 KiB fails the file on every write path
+    const wb_case_t full_plain = {0, 0, VAL_ACK_ON_RECEIPT, 100u * 1024u};
+    const wb_case_t full_sync = {ring, 0, VAL_ACK_ON_RECEIPT, 100u * 1024u};
+    const wb_case_t full_async = {ring, 1, VAL_ACK_ON_RECEIPT, 100u * 1024u};
+    if (!run_case("recv_writebehind_full_off", file_size, &full_plain, &w_full) ||
+        !run_case("recv_writebehind_full_sync", file_size, &full_sync, &w_full) ||
+        !run_case("recv_writebehind_full_async", file_size, &full_async, &w_full))
+        fails++;
+    fails += check_invalid_config();
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("recv_writebehind: PASS\n");
+        return 0;
+    }
+    printf("recv_writebehind: FAIL (%d)\n", fails);
+    return 1;
+}
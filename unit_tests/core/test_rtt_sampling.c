@@ -0,0 +1,154 @@
+#include "test_support.h"
+#include "val_internal.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies per-packet RTT sampling: on a link that serializes each DATA frame for a few milliseconds the
+// sender's SRTT stays well below a window's serialization time, a slow ACK return path shows up in SRTT
+// (samples run from each packet's own send time, not from the end of the window fill), and with drops
+// recovered by selective repeat the ACKs of retransmitted packets are not sampled (Karn's rule per slot).
+
+#define SERIALIZE_MS 2u
+#define WINDOW 16u
+
+static unsigned g_data_frames = 0;
+static unsigned g_drop_every = 0;
+static uint64_t g_high_sent = 0;
+static unsigned g_drops = 0;
+static uint32_t g_ack_path_ms = 0;
+
+static int slow_link_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        ts_delay(SERIALIZE_MS);
+        g_data_frames++;
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        // Drop only first transmissions: an offset below the high-water mark is a resend
+        uint64_t off = (flags & VAL_DATA_OFFSET_PRESENT) ? VAL_GET_LE64(p + VAL_WIRE_HEADER_SIZE) : 0u;
+        int fresh = (off >= g_high_sent);
+        if (fresh)
+            g_high_sent = off + 1u;
+        if (fresh && g_drop_every && (g_data_frames % g_drop_every) == 0u)
+        {
+            g_drops++;
+            return (int)len;
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+// Return path: every DATA_ACK spends g_ack_path_ms on the way back, so no true RTT sample can be shorter
+static int slow_ack_send(void *ctx, const void *data, size_t len)
+{
+    if (g_ack_path_ms && len >= 1 && ((const uint8_t *)data)[0] == VAL_PKT_DATA_ACK)
+        ts_delay(g_ack_path_ms);
+    return test_tp_send(ctx, data, len);
+}
+
+static int run_case(const char *name, unsigned drop_every, uint32_t ack_path_ms, uint32_t min_srtt_ms, uint32_t max_srtt_ms)
+{
+    const size_t packet = 2048, depth = 64;
+    const size_t file_size = 256 * 1024 + 3;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    uint8_t *reorder = (uint8_t *)calloc(WINDOW, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = slow_link_send;
+    cfg_rx.transport.send = slow_ack_send;
+    cfg_tx.tx_flow.window_cap_packets = WINDOW;
+    cfg_tx.tx_flow.initial_cwnd_packets = WINDOW;
+    cfg_rx.tx_flow.window_cap_packets = WINDOW;
+    if (drop_every)
+    {
+        cfg_tx.features.requested = VAL_FEAT_SACK;
+        cfg_rx.buffers.rx_reorder_buffer = reorder;
+        cfg_rx.buffers.rx_reorder_size = WINDOW * packet;
+    }
+
+    g_data_frames = g_drops = 0;
+    g_high_sent = 0;
+    g_drop_every = drop_every;
+    g_ack_path_ms = ack_path_ms;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    // A whole window takes WINDOW * SERIALIZE_MS to serialize; per-packet samples stay well below that
+    if (tx->timing.samples_taken < 8 || tx->timing.srtt_ms < min_srtt_ms || tx->timing.srtt_ms > max_srtt_ms || (drop_every && g_drops == 0))
+    {
+        fprintf(stderr, "%s: samples=%u srtt=%ums rttvar=%ums drops=%u\n", name, (unsigned)tx->timing.samples_taken,
+                (unsigned)tx->timing.srtt_ms, (unsigned)tx->timing.rttvar_ms, g_drops);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(reorder);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "rtt_sampling");
+
+    int fails = 0;
+    fails += run_case("rtt_sampling_clean", 0u, 0u, 0u, WINDOW * SERIALIZE_MS / 2u);
+    // Handshake samples (no ACK path delay) seed SRTT low; data samples must still pull it up towards 10 ms
+    fails += run_case("rtt_sampling_ack_path", 0u, 10u, 5u, 40u);
+    fails += run_case("rtt_sampling_karn", 25u, 0u, 0u, WINDOW * SERIALIZE_MS / 2u);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("rtt_sampling: PASS\n");
+        return 0;
+    }
+    printf("rtt_sampling: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,195 @@
+#include "test_support.h"
+#include "val_wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies the sender read-ahead ring (buffers.tx_readahead_buffer): on storage with a fixed latency per
+// read and a link that takes a few milliseconds per frame, chunked read-ahead cuts the number of reads, the
+// async hooks (filesystem.read_submit/read_wait) overlap them with sending, and retransmissions after
+// losses are served from the ring instead of going back to storage.
+
+#define STORAGE_MS 20u
+#define SERIALIZE_MS 4u
+#define PACKET 4096u
+#define WINDOW 16u
+
+static unsigned g_reads = 0;
+static unsigned g_drop_every = 0;
+static unsigned g_fresh = 0;
+static uint64_t g_high_sent = 0;
+static unsigned g_drops = 0;
+
+static size_t counting_fread(void *ctx, void *buffer, size_t size, size_t count, void *file)
+{
+    g_reads++;
+    return ts_fread(ctx, buffer, size, count, file);
+}
+
+static int counting_read_submit(void *ctx, void *file, uint64_t offset, void *buffer, size_t len)
+{
+    g_reads++;
+    return ts_read_submit(ctx, file, offset, buffer, len);
+}
+
+static int slow_link_send(void *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    if (len >= VAL_WIRE_HEADER_SIZE && p[0] == VAL_PKT_DATA)
+    {
+        ts_delay(SERIALIZE_MS);
+        uint8_t t = 0, flags = 0;
+        uint16_t clen = 0;
+        uint32_t td = 0;
+        val_deserialize_frame_header(p, &t, &flags, &clen, &td);
+        uint64_t off = (flags & VAL_DATA_OFFSET_PRESENT) ? VAL_GET_LE64(p + VAL_WIRE_HEADER_SIZE) : (uint64_t)td;
+        if (off >= g_high_sent)
+        {
+            g_high_sent = off + 1u;
+            if (g_drop_every && (++g_fresh % g_drop_every) == 0u)
+            {
+                g_drops++;
+                return (int)len;
+            }
+        }
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+// Returns elapsed ms, or 0 on failure
+static uint32_t run_case(const char *name, size_t file_size, size_t readahead, int async, unsigned drop_every,
+                         unsigned *out_reads)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, PACKET, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 0;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 0;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, file_size) != 0)
+        return 0;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, PACKET), *rb_tx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, PACKET), *rb_rx = (uint8_t *)calloc(1, PACKET);
+    uint8_t *ring = readahead ? (uint8_t *)calloc(1, readahead) : NULL;
+    uint8_t *reorder = (uint8_t *)calloc(WINDOW, PACKET);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, PACKET, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, PACKET, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.transport.send = slow_link_send;
+    cfg_tx.filesystem.fread = counting_fread;
+    cfg_tx.buffers.tx_readahead_buffer = ring;
+    cfg_tx.buffers.tx_readahead_size = readahead;
+    if (async)
+    {
+        cfg_tx.filesystem.read_submit = counting_read_submit;
+        cfg_tx.filesystem.read_wait = ts_read_wait;
+    }
+    cfg_tx.tx_flow.window_cap_packets = WINDOW;
+    cfg_tx.tx_flow.initial_cwnd_packets = WINDOW;
+    cfg_rx.tx_flow.window_cap_packets = WINDOW;
+    if (drop_every)
+    {
+        cfg_tx.features.requested = VAL_FEAT_SACK;
+        cfg_rx.buffers.rx_reorder_buffer = reorder;
+        cfg_rx.buffers.rx_reorder_size = WINDOW * PACKET;
+    }
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 0;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    g_reads = 0;
+    g_drop_every = drop_every;
+    g_fresh = g_drops = 0;
+    g_high_sent = 0;
+    ts_fs_set_read_latency_ms(STORAGE_MS);
+    const char *files[1] = {inpath};
+    uint32_t t0 = ts_ticks();
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    uint32_t elapsed = ts_ticks() - t0;
+    ts_fs_set_read_latency_ms(0);
+    ts_join_thread(th);
+
+    int ok = 1;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        ok = 0;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        ok = 0;
+    }
+    if (drop_every && g_drops == 0)
+    {
+        fprintf(stderr, "%s: no frames dropped\n", name);
+        ok = 0;
+    }
+    *out_reads = g_reads;
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    free(ring);
+    free(reorder);
+    test_duplex_free(&d);
+    return ok ? (elapsed ? elapsed : 1u) : 0u;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "send_readahead");
+
+    int fails = 0;
+    const size_t file_size = 256u * 1024u + 7u;
+    const size_t ring = 128u * 1024u; // 8 chunks of 16 KiB
+    unsigned reads_plain = 0, reads_sync = 0, reads_async = 0, reads_lossy = 0;
+    uint32_t t_plain = run_case("send_readahead_off", file_size, 0, 0, 0, &reads_plain);
+    uint32_t t_sync = run_case("send_readahead_sync", file_size, ring, 0, 0, &reads_sync);
+    uint32_t t_async = run_case("send_readahead_async", file_size, ring, 1, 0, &reads_async);
+    uint32_t t_lossy = run_case("send_readahead_lossy", file_size, ring, 1, 20, &reads_lossy);
+    if (!t_plain || !t_sync || !t_async || !t_lossy)
+        fails++;
+    // One read per 16 KiB chunk instead of one per frame
+    const unsigned chunks = (unsigned)((file_size + ring / 8u - 1u) / (ring / 8u));
+    if (reads_sync > chunks + 1u || reads_async > chunks + 1u || reads_plain < 3u * chunks)
+    {
+        fprintf(stderr, "reads: plain=%u sync=%u async=%u (chunks %u)\n", reads_plain, reads_sync, reads_async, chunks);
+        fails++;
+    }
+    // Async reads run while frames are on the wire; the synchronous ring pays the storage latency in line
+    if (t_sync * 2u > t_plain || t_async * 10u > t_sync * 9u)
+    {
+        fprintf(stderr, "timing: plain=%ums sync=%ums async=%ums\n", (unsigned)t_plain, (unsigned)t_sync,
+                (unsigned)t_async);
+        fails++;
+    }
+    // Retransmissions come from the ring: no more reads than the clean transfer
+    if (reads_lossy > chunks + 1u)
+    {
+        fprintf(stderr, "lossy: %u reads for %u chunks\n", reads_lossy, chunks);
+        fails++;
+    }
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("send_readahead: PASS\n");
+        return 0;
+    }
+    printf("send_readahead: FAIL (%d)\n", fails);
+    return 1;
+}
@@ -0,0 +1,125 @@
+#include "test_support.h"
+#include "val_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Verifies 32-bit and byte-based window negotiation: packet caps above 65535 survive the HELLO (scaled by
+// window_shift), the tracking table starts small and grows as a large window is filled, and a byte cap
+// yields the same bytes in flight whatever the packet size, whichever side sets it.
+
+typedef struct
+{
+    size_t packet;
+    uint32_t tx_cap_packets, rx_cap_packets;
+    uint32_t tx_cap_bytes, rx_cap_bytes;
+    uint16_t initial_cwnd;
+    size_t file_size;
+    uint32_t expect_window;     // negotiated_window_packets on the sender
+    uint32_t expect_peer_tx;    // receiver's view of the sender's cap (0 = don't check)
+    uint32_t expect_min_slots;  // tracking slots the sender must have grown to (0 = don't check)
+} wide_case_t;
+
+static int run_case(const char *name, const wide_case_t *c)
+{
+    const size_t depth = 64;
+    test_duplex_t d;
+    test_duplex_init(&d, c->packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs(name, basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, c->file_size) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, c->packet), *rb_tx = (uint8_t *)calloc(1, c->packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, c->packet), *rb_rx = (uint8_t *)calloc(1, c->packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, c->packet, &end_tx, VAL_RESUME_NEVER, 0);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, c->packet, &end_rx, VAL_RESUME_NEVER, 0);
+    cfg_tx.tx_flow.window_cap_packets = c->tx_cap_packets;
+    cfg_tx.tx_flow.window_cap_bytes = c->tx_cap_bytes;
+    cfg_tx.tx_flow.initial_cwnd_packets = c->initial_cwnd;
+    cfg_rx.tx_flow.window_cap_packets = c->rx_cap_packets;
+    cfg_rx.tx_flow.window_cap_bytes = c->rx_cap_bytes;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    int fails = 0;
+    if (tx->max_tracking_slots > VAL_TRACKING_SLOTS_INITIAL)
+    {
+        fprintf(stderr, "%s: %u tracking slots allocated up front\n", name, (unsigned)tx->max_tracking_slots);
+        fails++;
+    }
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[1] = {inpath};
+    val_status_t st = val_send_files(tx, files, 1, NULL);
+    ts_join_thread(th);
+
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "%s: send failed %d\n", name, (int)st);
+        fails++;
+    }
+    uint32_t peer_tx = 0;
+    (void)val_get_peer_tx_cap_packets(rx, &peer_tx);
+    uint64_t window_bytes = (uint64_t)tx->negotiated_window_packets * tx->effective_packet_size;
+    uint32_t byte_cap = tx->negotiated_window_bytes;
+    if (tx->negotiated_window_packets != c->expect_window || (c->expect_peer_tx && peer_tx != c->expect_peer_tx) ||
+        (byte_cap && window_bytes > byte_cap) || tx->max_tracking_slots < c->expect_min_slots)
+    {
+        fprintf(stderr, "%s: window=%u (want %u) peer_tx=%u bytes=%llu/%u slots=%u\n", name,
+                (unsigned)tx->negotiated_window_packets, (unsigned)c->expect_window, (unsigned)peer_tx,
+                (unsigned long long)window_bytes, (unsigned)byte_cap, (unsigned)tx->max_tracking_slots);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "%s: output mismatch\n", name);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    return fails;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "wide_window");
+
+    int fails = 0;
+    // Caps far above 65535 packets; the first window fill alone needs 2000 tracking slots
+    const wide_case_t wide = {2048, 200000u, 150000u, 0, 0, 2000, 6u * 1024u * 1024u + 11u, 150000u, 200000u, 2000u};
+    fails += run_case("wide_window_caps", &wide);
+    // A 64 KiB byte cap is 32 frames of 2 KiB or 8 frames of 8 KiB; no packet cap falls back to the byte cap
+    const wide_case_t bytes_small = {2048, 0, 512, 64u * 1024u, 0, 0, 200u * 1024u + 1u, 32u, 0, 0};
+    const wide_case_t bytes_large = {8192, 0, 512, 64u * 1024u, 0, 0, 200u * 1024u + 1u, 8u, 0, 0};
+    fails += run_case("wide_window_bytes_2k", &bytes_small);
+    fails += run_case("wide_window_bytes_8k", &bytes_large);
+    // The receiver's byte cap bounds the sender even when the sender only sets a packet cap
+    const wide_case_t bytes_rx = {2048, 64, 512, 0, 16u * 1024u, 0, 100u * 1024u + 1u, 8u, 0, 0};
+    fails += run_case("wide_window_bytes_rx", &bytes_rx);
+
+    ts_cancel_timeout_guard(wd);
+    if (fails == 0)
+    {
+        printf("wide_window: PASS\n");
+        return 0;
+    }
+    printf("wide_window: FAIL (%d)\n", fails);
+    return 1;
+}
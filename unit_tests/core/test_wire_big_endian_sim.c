@@ -38,7 +38,9 @@ static int roundtrip_all(void) {
         in.supported_features16 = 0xBEEF;
         in.required_features16 = 0xFEED;
         in.requested_features16 = 0xAA55;
-        in.reserved2 = 0x01020304;
+        in.window_shift = 3;
+        in.reserved3 = 0x7E;
+        in.rx_max_window_bytes = 0x01020304;
         val_serialize_handshake(&in, buf);
         val_deserialize_handshake(buf, &out);
         if (memcmp(&in, &out, sizeof(in)) != 0) fails++;
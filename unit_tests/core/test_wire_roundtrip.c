@@ -16,6 +16,16 @@ static int test_header(void) {
     return (type_in == type_out && flags_in == flags_out && len_in == len_out && data_in == data_out) ? 0 : 1;
 }
 
+static int test_header_ext(void) {
+    uint8_t buf[VAL_WIRE_EXT_HEADER_SIZE];
+    val_serialize_frame_header_ext((uint8_t)VAL_PKT_DATA, VAL_DATA_OFFSET_PRESENT, 0x00123456u, 0x89ABCDEFu, buf);
+    uint8_t type_out = 0, flags_out = 0; uint16_t len_out = 0; uint32_t data_out = 0;
+    val_deserialize_frame_header(buf, &type_out, &flags_out, &len_out, &data_out);
+    return (type_out == VAL_PKT_DATA && flags_out == (VAL_DATA_OFFSET_PRESENT | VAL_FRAME_EXT_LEN) &&
+            len_out == VAL_WIRE_STD_MAX_CONTENT && data_out == 0x89ABCDEFu &&
+            val_deserialize_frame_ext_len(buf) == 0x00123456u) ? 0 : 1;
+}
+
 static int test_handshake(void) {
     uint8_t buf[VAL_WIRE_HANDSHAKE_SIZE];
     val_handshake_t in = {0};
@@ -36,7 +46,9 @@ static int test_handshake(void) {
     in.supported_features16 = 0xAA55;
     in.required_features16 = 0x55AA;
     in.requested_features16 = 0x0F0F;
-    in.reserved2 = 0xCAFEBABE;
+    in.window_shift = 5;            // window fields in units of 32 packets
+    in.reserved3 = 0xA5;
+    in.rx_max_window_bytes = 0xCAFEBABE;
 
     val_serialize_handshake(&in, buf);
     val_handshake_t out = {0};
@@ -95,6 +107,7 @@ int main(void) {
     
     int fails = 0;
     fails += test_header();
+    fails += test_header_ext();
     fails += test_handshake();
     fails += test_meta();
     fails += test_resume_resp();
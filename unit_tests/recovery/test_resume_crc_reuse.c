@@ -0,0 +1,115 @@
+#include "test_support.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tail-verify resume must not re-read data the receiver already hashed: the tail CRC computed for
+// RESUME_RESP answers the sender's VERIFY, and bytes received in this session are folded into the
+// cached region CRC arithmetically. The same file is sent twice in one batch to exercise both.
+
+#define FILE_SIZE 24000u
+#define PREFIX_SIZE 20000u
+#define TAIL_CAP 4096u
+
+static size_t g_rx_read_bytes = 0;
+static uint64_t g_resume_offsets[2];
+static int g_files_started = 0;
+
+static size_t counting_fread(void *ctx, void *buffer, size_t size, size_t count, void *file)
+{
+    size_t n = ts_fread(ctx, buffer, size, count, file);
+    g_rx_read_bytes += n * size;
+    return n;
+}
+
+static void on_start(const char *filename, const char *sender_path, uint64_t file_size, uint64_t resume_offset)
+{
+    (void)filename;
+    (void)sender_path;
+    (void)file_size;
+    if (g_files_started < 2)
+        g_resume_offsets[g_files_started] = resume_offset;
+    g_files_started++;
+}
+
+int main(void)
+{
+    ts_cancel_token_t wd = ts_start_timeout_guard(TEST_TIMEOUT_QUICK_MS, "resume_crc_reuse");
+
+    const size_t packet = 1024, depth = 32;
+    test_duplex_t d;
+    test_duplex_init(&d, packet, depth);
+
+    char basedir[2048], outdir[2048], inpath[2048], outpath[2048];
+    if (ts_build_case_dirs("resume_crc_reuse", basedir, sizeof(basedir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    if (ts_path_join(inpath, sizeof(inpath), basedir, "in.bin") != 0 ||
+        ts_path_join(outpath, sizeof(outpath), outdir, "in.bin") != 0)
+        return 1;
+    ts_remove_file(outpath);
+    if (ts_write_pattern_file(inpath, FILE_SIZE) != 0 || ts_write_pattern_file(outpath, PREFIX_SIZE) != 0)
+        return 1;
+
+    uint8_t *sb_tx = (uint8_t *)calloc(1, packet), *rb_tx = (uint8_t *)calloc(1, packet);
+    uint8_t *sb_rx = (uint8_t *)calloc(1, packet), *rb_rx = (uint8_t *)calloc(1, packet);
+    test_duplex_t end_tx = d;
+    test_duplex_t end_rx = {.a2b = d.b2a, .b2a = d.a2b, .max_packet = d.max_packet};
+    val_config_t cfg_tx, cfg_rx;
+    ts_make_config(&cfg_tx, sb_tx, rb_tx, packet, &end_tx, VAL_RESUME_TAIL, TAIL_CAP);
+    ts_make_config(&cfg_rx, sb_rx, rb_rx, packet, &end_rx, VAL_RESUME_TAIL, TAIL_CAP);
+    cfg_rx.filesystem.fread = counting_fread;
+    cfg_rx.callbacks.on_file_start = on_start;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    if (val_session_create(&cfg_tx, &tx, NULL) != VAL_OK || val_session_create(&cfg_rx, &rx, NULL) != VAL_OK)
+        return 1;
+    ts_thread_t th = ts_start_receiver(rx, outdir);
+    ts_receiver_warmup(&cfg_tx, 5);
+    const char *files[2] = {inpath, inpath};
+    val_status_t st = val_send_files(tx, files, 2, NULL);
+    ts_join_thread(th);
+
+    int fails = 0;
+    if (st != VAL_OK)
+    {
+        fprintf(stderr, "resume_crc_reuse: send failed %d\n", (int)st);
+        fails++;
+    }
+    if (!ts_files_equal(inpath, outpath))
+    {
+        fprintf(stderr, "resume_crc_reuse: output mismatch\n");
+        fails++;
+    }
+    // Both resumes verified (a CRC mismatch would restart at 0)
+    if (g_files_started != 2 || g_resume_offsets[0] != PREFIX_SIZE || g_resume_offsets[1] != FILE_SIZE)
+    {
+        fprintf(stderr, "resume_crc_reuse: started=%d offsets=%llu,%llu\n", g_files_started,
+                (unsigned long long)g_resume_offsets[0], (unsigned long long)g_resume_offsets[1]);
+        fails++;
+    }
+    // File 1: the tail is read once (VERIFY reuses it). File 2: the cached [PREFIX-CAP, FILE) region
+    // covers the new tail, so only the surplus head is read to strip it.
+    size_t expect_reads = TAIL_CAP + (FILE_SIZE - TAIL_CAP) - (PREFIX_SIZE - TAIL_CAP);
+    if (g_rx_read_bytes != expect_reads)
+    {
+        fprintf(stderr, "resume_crc_reuse: receiver read %zu bytes, expected %zu\n", g_rx_read_bytes, expect_reads);
+        fails++;
+    }
+
+    val_session_destroy(tx);
+    val_session_destroy(rx);
+    free(sb_tx);
+    free(rb_tx);
+    free(sb_rx);
+    free(rb_rx);
+    test_duplex_free(&d);
+    ts_cancel_timeout_guard(wd);
+
+    if (fails == 0)
+    {
+        printf("resume_crc_reuse: PASS\n");
+        return 0;
+    }
+    printf("resume_crc_reuse: FAIL (%d)\n", fails);
+    return 1;
+}
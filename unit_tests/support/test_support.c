@@ -1,3 +1,6 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // fallocate()
+#endif
 #include "test_support.h"
 #include "../../src/val_internal.h"
 #include "../support/transport_profiles.h"
@@ -10,6 +13,7 @@
 #if defined(_WIN32)
 #include <direct.h>
 #include <errno.h>
+#include <io.h>
 #include <windows.h>
 #ifdef _MSC_VER
 #include <crtdbg.h>
@@ -96,6 +100,7 @@ __declspec(allocate(".CRT$XCU")) static void(__cdecl *ts_win_p_init)(void) = ts_
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -219,12 +224,36 @@ int test_fifo_pop_exact(test_fifo_t *f, uint8_t *out, size_t len, uint32_t timeo
     return 1;
 }
 
+size_t test_fifo_pop_some(test_fifo_t *f, uint8_t *out, size_t cap, uint32_t timeout_ms)
+{
+    m_lock(&f->lock);
+    uint32_t waited = 0;
+    const uint32_t step = 10; // 10ms polling granularity
+    while (f->count == 0 && waited < timeout_ms)
+    {
+        c_wait(&f->cv_ne, &f->lock, step);
+        waited += step;
+    }
+    size_t len = (f->count < cap) ? f->count : cap;
+    size_t first = ((f->head + len) <= f->cap) ? len : (f->cap - f->head);
+    memcpy(out, f->buf + f->head, first);
+    if (first < len)
+        memcpy(out + first, f->buf, len - first);
+    f->head = (f->head + len) % f->cap;
+    f->count -= len;
+    if (len)
+        c_signal_all(&f->cv_nf);
+    m_unlock(&f->lock);
+    return len;
+}
+
+static uint64_t pcg32_state = 0x853c49e6748fea9bull; // arbitrary seed
+static uint64_t pcg32_inc = 0xda3e39cb94b95bdbull;   // arbitrary stream
+
 static uint32_t pcg32(void)
 {
-    static uint64_t state = 0x853c49e6748fea9bull; // arbitrary seed
-    static uint64_t inc = 0xda3e39cb94b95bdbull;   // arbitrary stream
-    uint64_t oldstate = state;
-    state = oldstate * 6364136223846793005ULL + (inc | 1);
+    uint64_t oldstate = pcg32_state;
+    pcg32_state = oldstate * 6364136223846793005ULL + (pcg32_inc | 1);
     uint32_t xorshifted = (uint32_t)(((oldstate >> 18u) ^ oldstate) >> 27u);
     uint32_t rot = (uint32_t)(oldstate >> 59u);
     return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
@@ -485,6 +514,16 @@ void ts_rand_seed_set(uint64_t seed)
         (void)pcg32();
 }
 
+void ts_rand_reset(uint64_t seed)
+{
+    // Standard PCG seeding: the sequence depends only on seed, not on what earlier tests consumed
+    pcg32_state = 0;
+    pcg32_inc = (seed << 1u) | 1u;
+    (void)pcg32();
+    pcg32_state += 0x853c49e6748fea9bull ^ seed;
+    (void)pcg32();
+}
+
 void maybe_corrupt(uint8_t *data, size_t len, const fault_injection_t *f)
 {
     if (!f)
@@ -844,6 +883,25 @@ int test_tp_send(void *ctx, const void *data, size_t len)
     return (int)len;
 }
 
+int test_tp_sendv(void *ctx, const val_iovec_t *iov, size_t iovcnt)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+        total += iov[i].len;
+    uint8_t *frame = (uint8_t *)malloc(total ? total : 1);
+    if (!frame)
+        return -1;
+    size_t at = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+    {
+        memcpy(frame + at, iov[i].base, iov[i].len);
+        at += iov[i].len;
+    }
+    int rc = test_tp_send(ctx, frame, total);
+    free(frame);
+    return rc;
+}
+
 int test_tp_recv(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms)
 {
     test_duplex_t *d = (test_duplex_t *)ctx;
@@ -879,6 +937,16 @@ int test_tp_recv(void *ctx, void *buffer, size_t buffer_size, size_t *received,
     return 0;
 }
 
+int test_tp_recv_some(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms)
+{
+    test_duplex_t *d = (test_duplex_t *)ctx;
+    size_t n = test_fifo_pop_some(d->b2a, (uint8_t *)buffer, buffer_size, timeout_ms);
+    if (received)
+        *received = n;
+    ts_tp_tracef("DIRECT RECV_SOME d=%p got=%zu/%zu", (void *)d, n, buffer_size);
+    return 0;
+}
+
 // ---- Filesystem fault injection (Windows path only; no-op elsewhere) ----
 static ts_fs_faults_t g_fs = {0};
 void ts_fs_faults_set(const ts_fs_faults_t *f)
@@ -928,13 +996,13 @@ void *ts_fopen(void *ctx, const char *path, const char *mode)
     }
     else if (mode && mode[0] == 'a')
     {
-        // Append: do not truncate, writes go to end
-        flags = O_WRONLY | O_CREAT | O_APPEND;
+        // Append: do not truncate, writes go to end (read access lets ts_map map it writable)
+        flags = O_RDWR | O_CREAT | O_APPEND;
     }
     else
     {
         // Default write: truncate/create new
-        flags = O_WRONLY | O_CREAT | O_TRUNC;
+        flags = O_RDWR | O_CREAT | O_TRUNC;
     }
     int fd = open(path, flags, 0666);
     if (fd < 0)
@@ -944,6 +1012,18 @@ void *ts_fopen(void *ctx, const char *path, const char *mode)
     return f;
 #endif
 }
+// Simulated storage latency per read call (ts_fread and the async worker); 0 = none
+static uint32_t g_fs_read_latency_ms = 0;
+void ts_fs_set_read_latency_ms(uint32_t ms)
+{
+    g_fs_read_latency_ms = ms;
+}
+static uint32_t g_fs_write_latency_ms = 0;
+void ts_fs_set_write_latency_ms(uint32_t ms)
+{
+    g_fs_write_latency_ms = ms;
+}
+
 size_t ts_fread(void *ctx, void *buffer, size_t size, size_t count, void *file)
 {
     (void)ctx;
@@ -952,6 +1032,8 @@ size_t ts_fread(void *ctx, void *buffer, size_t size, size_t count, void *file)
         return 0;
     if (size == 0 || count == 0)
         return 0;
+    if (g_fs_read_latency_ms)
+        ts_delay(g_fs_read_latency_ms);
     size_t total = size * count;
     uint8_t *dst = (uint8_t *)buffer;
     size_t read_total = 0;
@@ -982,6 +1064,8 @@ size_t ts_fwrite(void *ctx, const void *buffer, size_t size, size_t count, void
     (void)ctx;
     ts_file_t *f = (ts_file_t *)file;
     size_t bytes = size * count;
+    if (g_fs_write_latency_ms)
+        ts_delay(g_fs_write_latency_ms);
 #if defined(_WIN32)
     // Simulate failures/short writes if configured
     size_t allowed = bytes;
@@ -1055,6 +1139,310 @@ int ts_fclose(void *ctx, void *file)
 #endif
 }
 
+// ---- Asynchronous I/O (reference filesystem.read_submit / read_wait and write_submit / write_wait) ----
+// One worker thread serves queued requests in submission order with positioned reads and writes, so the file
+// position used by ts_fread/ts_fseek is never moved. At most TS_AIO_SLOTS requests are outstanding; further
+// submits fail.
+#define TS_AIO_SLOTS 16
+typedef struct
+{
+    ts_file_t *file;
+    uint64_t offset;
+    void *buffer;
+    size_t len;
+    size_t got;
+    uint64_t seq;
+    int state; // 0 = free, 1 = queued, 2 = done
+    int write;
+} ts_aio_req_t;
+
+static ts_mutex_t g_aio_lock;
+static ts_cond_t g_aio_cv;
+static int g_aio_started = 0;
+static uint64_t g_aio_seq = 0;
+static ts_aio_req_t g_aio[TS_AIO_SLOTS];
+
+static size_t ts_pread_at(ts_file_t *f, void *buffer, size_t len, uint64_t offset)
+{
+    size_t have = 0;
+#if defined(_WIN32)
+    HANDLE h = (HANDLE)_get_osfhandle(_fileno(f->fp));
+    while (have < len)
+    {
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t at = offset + have;
+        ov.Offset = (DWORD)(at & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(at >> 32);
+        DWORD got = 0;
+        DWORD want = (len - have > 0x40000000u) ? 0x40000000u : (DWORD)(len - have);
+        if (!ReadFile(h, (uint8_t *)buffer + have, want, &got, &ov) || got == 0)
+            break;
+        have += got;
+    }
+#else
+    while (have < len)
+    {
+        ssize_t got = pread(f->fd, (uint8_t *)buffer + have, len - have, (off_t)(offset + have));
+        if (got <= 0)
+            break;
+        have += (size_t)got;
+    }
+#endif
+    return have;
+}
+
+static size_t ts_pwrite_at(ts_file_t *f, const void *buffer, size_t len, uint64_t offset)
+{
+    size_t have = 0;
+#if defined(_WIN32)
+    HANDLE h = (HANDLE)_get_osfhandle(_fileno(f->fp));
+    while (have < len)
+    {
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t at = offset + have;
+        ov.Offset = (DWORD)(at & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(at >> 32);
+        DWORD put = 0;
+        DWORD want = (len - have > 0x40000000u) ? 0x40000000u : (DWORD)(len - have);
+        if (!WriteFile(h, (const uint8_t *)buffer + have, want, &put, &ov) || put == 0)
+            break;
+        have += put;
+    }
+#else
+    while (have < len)
+    {
+        ssize_t put = pwrite(f->fd, (const uint8_t *)buffer + have, len - have, (off_t)(offset + have));
+        if (put <= 0)
+            break;
+        have += (size_t)put;
+    }
+#endif
+    return have;
+}
+
+// Reference filesystem.pread / pwrite / fsize
+size_t ts_pread(void *ctx, void *file, void *buffer, size_t len, uint64_t offset)
+{
+    (void)ctx;
+    if (g_fs_read_latency_ms)
+        ts_delay(g_fs_read_latency_ms);
+    return ts_pread_at((ts_file_t *)file, buffer, len, offset);
+}
+
+size_t ts_pwrite(void *ctx, void *file, const void *buffer, size_t len, uint64_t offset)
+{
+    (void)ctx;
+    if (g_fs_write_latency_ms)
+        ts_delay(g_fs_write_latency_ms);
+    return ts_pwrite_at((ts_file_t *)file, buffer, len, offset);
+}
+
+int64_t ts_fsize(void *ctx, const char *path)
+{
+    (void)ctx;
+#if defined(_WIN32)
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0)
+        return -1;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return -1;
+#endif
+    return (int64_t)st.st_size;
+}
+
+// Reference filesystem.preallocate: reserve blocks without growing the file (Linux fallocate KEEP_SIZE).
+// posix_fallocate would extend the file and break appends, so elsewhere nothing is reserved.
+int ts_preallocate(void *ctx, void *file, uint64_t size)
+{
+    (void)ctx;
+    ts_file_t *f = (ts_file_t *)file;
+    if (!f)
+        return -1;
+#if defined(__linux__)
+    if (fallocate(f->fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)size) != 0)
+        return (errno == ENOSPC || errno == EFBIG) ? -1 : 0;
+#else
+    (void)size;
+#endif
+    return 0;
+}
+
+// Reference filesystem.map / unmap (POSIX mmap; not mapped on Windows, where the read/write hooks are used)
+void *ts_map(void *ctx, void *file, uint64_t offset, size_t len, bool writable)
+{
+    (void)ctx;
+    ts_file_t *f = (ts_file_t *)file;
+    if (!f || !len)
+        return NULL;
+#if defined(_WIN32)
+    (void)offset;
+    (void)writable;
+    return NULL;
+#else
+    struct stat st;
+    if (fstat(f->fd, &st) != 0)
+        return NULL;
+    if (writable)
+    {
+        // Reserve the blocks up front: a full disk fails here instead of raising SIGBUS on a later store
+        if ((uint64_t)st.st_size < offset + len && posix_fallocate(f->fd, (off_t)offset, (off_t)len) != 0)
+            return NULL;
+    }
+    else if ((uint64_t)st.st_size < offset + len)
+    {
+        return NULL;
+    }
+    void *p = mmap(NULL, len, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, f->fd, (off_t)offset);
+    return (p == MAP_FAILED) ? NULL : p;
+#endif
+}
+
+int ts_unmap(void *ctx, void *file, void *addr, uint64_t offset, size_t len, size_t valid)
+{
+    (void)ctx;
+#if defined(_WIN32)
+    (void)file;
+    (void)addr;
+    (void)offset;
+    (void)len;
+    (void)valid;
+    return -1;
+#else
+    ts_file_t *f = (ts_file_t *)file;
+    int rc = munmap(addr, len);
+    if (valid < len && ftruncate(f->fd, (off_t)(offset + valid)) != 0)
+        rc = -1;
+    return rc;
+#endif
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI ts_aio_worker(LPVOID arg)
+#else
+static void *ts_aio_worker(void *arg)
+#endif
+{
+    (void)arg;
+    for (;;)
+    {
+        m_lock(&g_aio_lock);
+        ts_aio_req_t *next = NULL;
+        while (!next)
+        {
+            for (int i = 0; i < TS_AIO_SLOTS; ++i)
+                if (g_aio[i].state == 1 && (!next || g_aio[i].seq < next->seq))
+                    next = &g_aio[i];
+            if (!next)
+                c_wait(&g_aio_cv, &g_aio_lock, 0);
+        }
+        ts_aio_req_t req = *next;
+        m_unlock(&g_aio_lock);
+        uint32_t latency = req.write ? g_fs_write_latency_ms : g_fs_read_latency_ms;
+        if (latency)
+            ts_delay(latency);
+        size_t got = req.write ? ts_pwrite_at(req.file, req.buffer, req.len, req.offset)
+                               : ts_pread_at(req.file, req.buffer, req.len, req.offset);
+        m_lock(&g_aio_lock);
+        next->got = got;
+        next->state = 2;
+        c_signal_all(&g_aio_cv);
+        m_unlock(&g_aio_lock);
+    }
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static int ts_aio_submit(ts_file_t *file, uint64_t offset, void *buffer, size_t len, int write)
+{
+    if (!g_aio_started)
+    {
+        m_init(&g_aio_lock);
+        c_init(&g_aio_cv);
+        g_aio_started = 1;
+#if defined(_WIN32)
+        CloseHandle(CreateThread(NULL, 0, ts_aio_worker, NULL, 0, NULL));
+#else
+        pthread_t th;
+        pthread_create(&th, NULL, ts_aio_worker, NULL);
+        pthread_detach(th);
+#endif
+    }
+    int rc = -1;
+    m_lock(&g_aio_lock);
+    for (int i = 0; i < TS_AIO_SLOTS; ++i)
+    {
+        if (g_aio[i].state == 0)
+        {
+            g_aio[i] = (ts_aio_req_t){file, offset, buffer, len, 0, g_aio_seq++, 1, write};
+            c_signal_all(&g_aio_cv);
+            rc = 0;
+            break;
+        }
+    }
+    m_unlock(&g_aio_lock);
+    return rc;
+}
+
+// Returns 0 with the byte count once the request on 'buffer' is done, 1 if it is still queued and !block
+static int ts_aio_wait(ts_file_t *file, const void *buffer, size_t *got, int block)
+{
+    if (!g_aio_started)
+        return -1;
+    int rc = -1;
+    m_lock(&g_aio_lock);
+    for (int i = 0; i < TS_AIO_SLOTS; ++i)
+    {
+        if (g_aio[i].state != 0 && g_aio[i].file == file && g_aio[i].buffer == buffer)
+        {
+            while (g_aio[i].state != 2 && block)
+                c_wait(&g_aio_cv, &g_aio_lock, 0);
+            if (g_aio[i].state != 2)
+            {
+                rc = 1;
+                break;
+            }
+            if (got)
+                *got = g_aio[i].got;
+            g_aio[i].state = 0;
+            rc = 0;
+            break;
+        }
+    }
+    m_unlock(&g_aio_lock);
+    return rc;
+}
+
+int ts_read_submit(void *ctx, void *file, uint64_t offset, void *buffer, size_t len)
+{
+    (void)ctx;
+    return ts_aio_submit((ts_file_t *)file, offset, buffer, len, 0);
+}
+
+int ts_read_wait(void *ctx, void *file, void *buffer, size_t *got)
+{
+    (void)ctx;
+    return ts_aio_wait((ts_file_t *)file, buffer, got, 1);
+}
+
+int ts_write_submit(void *ctx, void *file, uint64_t offset, const void *buffer, size_t len)
+{
+    (void)ctx;
+    return ts_aio_submit((ts_file_t *)file, offset, (void *)buffer, len, 1);
+}
+
+int ts_write_wait(void *ctx, void *file, const void *buffer, size_t *written, bool block)
+{
+    (void)ctx;
+    return ts_aio_wait((ts_file_t *)file, buffer, written, block ? 1 : 0);
+}
+
 // Cross-platform monotonic millisecond clock and delay for tests
 // See test_support.h for policy notes. These are used as defaults by
 // ts_make_config() when the caller doesn't provide their own hooks.
@@ -1123,6 +1511,19 @@ void ts_delay(uint32_t ms)
 #endif
 }
 
+void ts_delay_us(uint32_t us)
+{
+#if defined(_WIN32)
+    // Sleep() has millisecond granularity: round up so callers never wake early
+    Sleep((us + 999u) / 1000u);
+#else
+    struct timespec req;
+    req.tv_sec = (time_t)(us / 1000000u);
+    req.tv_nsec = (long)((us % 1000000u) * 1000L);
+    nanosleep(&req, NULL);
+#endif
+}
+
 static void ts_path_dirname(const char *path, char *out, size_t outsz)
 {
     if (!out || outsz == 0)
@@ -19,6 +19,8 @@ extern "C"
     void test_fifo_push(test_fifo_t *f, const uint8_t *data, size_t len);
     // Pop exactly 'len' bytes into 'out'. Returns 1 on success, 0 if timed out without enough data.
     int test_fifo_pop_exact(test_fifo_t *f, uint8_t *out, size_t len, uint32_t timeout_ms);
+    // Pop whatever is queued, up to 'cap' bytes, waiting up to timeout for the first byte. Returns bytes popped.
+    size_t test_fifo_pop_some(test_fifo_t *f, uint8_t *out, size_t cap, uint32_t timeout_ms);
 
     // Fault injection knobs for the duplex transport
     typedef struct
@@ -44,7 +46,11 @@ extern "C"
     void test_duplex_free(test_duplex_t *d);
 
     int test_tp_send(void *ctx, const void *data, size_t len);
+    // Gathered send: concatenates the segments and hands one frame to test_tp_send
+    int test_tp_sendv(void *ctx, const val_iovec_t *iov, size_t iovcnt);
     int test_tp_recv(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms);
+    // Partial receive for transport.recv_some: returns whatever is queued (up to buffer_size)
+    int test_tp_recv_some(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms);
 
     // Network simulation controls (disabled by default)
     typedef struct
@@ -81,6 +87,8 @@ extern "C"
     void ts_net_sim_set(const ts_net_sim_t *cfg);
     void ts_net_sim_reset(void);
     void ts_rand_seed_set(uint64_t seed);
+    // Restart the shared generator from a fixed state derived from seed
+    void ts_rand_reset(uint64_t seed);
 
     // Minimal stdio wrappers used by tests
     void *ts_fopen(void *ctx, const char *path, const char *mode);
@@ -89,6 +97,25 @@ extern "C"
     int ts_fseek(void *ctx, void *file, int64_t offset, int whence);
     int64_t ts_ftell(void *ctx, void *file);
     int ts_fclose(void *ctx, void *file);
+    // Reference filesystem.pread / pwrite (positioned, file position untouched) and fsize (stat)
+    size_t ts_pread(void *ctx, void *file, void *buffer, size_t len, uint64_t offset);
+    size_t ts_pwrite(void *ctx, void *file, const void *buffer, size_t len, uint64_t offset);
+    int64_t ts_fsize(void *ctx, const char *path);
+    // Reference filesystem.preallocate (Linux fallocate with FALLOC_FL_KEEP_SIZE; no-op elsewhere)
+    int ts_preallocate(void *ctx, void *file, uint64_t size);
+    // Reference filesystem.map / unmap over mmap (POSIX only; ts_map returns NULL on Windows)
+    void *ts_map(void *ctx, void *file, uint64_t offset, size_t len, bool writable);
+    int ts_unmap(void *ctx, void *file, void *addr, uint64_t offset, size_t len, size_t valid);
+    // Reference filesystem.read_submit / read_wait: a worker thread serves positioned reads in order
+    int ts_read_submit(void *ctx, void *file, uint64_t offset, void *buffer, size_t len);
+    int ts_read_wait(void *ctx, void *file, void *buffer, size_t *got);
+    // Reference filesystem.write_submit / write_wait on the same worker thread (positioned writes)
+    int ts_write_submit(void *ctx, void *file, uint64_t offset, const void *buffer, size_t len);
+    int ts_write_wait(void *ctx, void *file, const void *buffer, size_t *written, bool block);
+    // Simulated storage latency added to every ts_fread call and async read (0 = none)
+    void ts_fs_set_read_latency_ms(uint32_t ms);
+    // Simulated storage latency added to every ts_fwrite call and async write (0 = none)
+    void ts_fs_set_write_latency_ms(uint32_t ms);
 
     // Filesystem fault injection (disabled by default)
     typedef enum
@@ -129,6 +156,8 @@ extern "C"
     // Intended for measuring short durations in tests; not part of the library API.
     uint64_t ts_ticks_us(void);
     void ts_delay(uint32_t ms);
+    // Microsecond sleep (nanosleep on POSIX; rounded up to whole milliseconds on Windows)
+    void ts_delay_us(uint32_t us);
 
     // Helper to build a common config for a session with provided buffers and duplex end
     // resume_mode: VAL_RESUME_NEVER, VAL_RESUME_SKIP_EXISTING, or VAL_RESUME_TAIL
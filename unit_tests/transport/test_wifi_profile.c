@@ -219,6 +219,187 @@ static int test_wifi_poor_conditions(void)
     return 0;
 }
 
+// Sender-side link: serialize each write at the profile bandwidth (carrying sub-millisecond remainders).
+// Random loss hits DATA frames only: the protocol does not retransmit a lost SEND_META, so a control frame
+// drawn for loss would end the run instead of measuring the controller.
+static uint64_t g_link_bits_owed = 0;
+static uint32_t g_data_loss_ppm = 0;
+static int profile_rate_send(void *ctx, const void *data, size_t len)
+{
+    test_duplex_t *d = (test_duplex_t *)ctx;
+    d->faults.drop_frame_per_million = (len && ((const uint8_t *)data)[0] == VAL_PKT_DATA) ? g_data_loss_ppm : 0u;
+    const transport_profile_t *profile = transport_sim_get_profile();
+    if (profile && profile->bandwidth_bps)
+    {
+        g_link_bits_owed += (uint64_t)len * 8u * 1000u;
+        uint32_t ms = (uint32_t)(g_link_bits_owed / profile->bandwidth_bps);
+        g_link_bits_owed -= (uint64_t)ms * profile->bandwidth_bps;
+        if (ms)
+            ts_delay(ms);
+    }
+    return test_tp_send(ctx, data, len);
+}
+
+// Return path: every frame the receiver sends reaches the sender a round trip later. The receiver stamps the
+// stream offset each frame ends at; the sender holds its reads until the frame under its read position is due.
+// The duplex FIFO's lock orders each stamp before the bytes it covers become readable.
+#define PROP_RING 1024u
+static struct
+{
+    uint64_t end;
+    uint32_t stamp_ms;
+} g_prop_ring[PROP_RING];
+static volatile uint32_t g_prop_written = 0;
+static uint32_t g_prop_read = 0;
+static uint64_t g_prop_pushed = 0, g_prop_consumed = 0;
+static uint32_t g_prop_rtt_ms = 0;
+
+static int propagation_send(void *ctx, const void *data, size_t len)
+{
+    g_prop_pushed += len;
+    g_prop_ring[g_prop_written % PROP_RING].end = g_prop_pushed;
+    g_prop_ring[g_prop_written % PROP_RING].stamp_ms = ts_ticks();
+    g_prop_written++;
+    return test_tp_send(ctx, data, len);
+}
+
+static int propagation_recv(void *ctx, void *buffer, size_t buffer_size, size_t *received, uint32_t timeout_ms)
+{
+    int rc = test_tp_recv(ctx, buffer, buffer_size, received, timeout_ms);
+    if (rc != 0 || !received || *received == 0)
+        return rc;
+    while (g_prop_read != g_prop_written && g_prop_ring[g_prop_read % PROP_RING].end <= g_prop_consumed)
+        g_prop_read++;
+    if (g_prop_read != g_prop_written)
+    {
+        uint32_t due = g_prop_ring[g_prop_read % PROP_RING].stamp_ms + g_prop_rtt_ms;
+        int32_t wait = (int32_t)(due - ts_ticks());
+        if (wait > 0)
+            ts_delay((uint32_t)wait);
+    }
+    g_prop_consumed += *received;
+    return rc;
+}
+
+#define WIFI_CC_LOSS_SEED 1u
+
+// One WiFi-poor transfer with the profile's baseline loss applied to DATA frames; selective repeat
+// keeps recovery per packet so the controllers differ only in how they size the window
+static int run_poor_with_cc(uint8_t cc, const char *case_name, size_t file_size, uint32_t *out_cwnd, uint32_t *out_ms)
+{
+    const transport_profile_t *profile = transport_sim_get_profile();
+    char indir[512], outdir[512], infile[512], outfile[512];
+    if (!profile || ts_build_case_dirs(case_name, indir, sizeof(indir), outdir, sizeof(outdir)) != 0)
+        return 1;
+    ts_path_join(infile, sizeof(infile), indir, "../test.bin");
+    ts_path_join(outfile, sizeof(outfile), outdir, "test.bin");
+    if (ts_write_pattern_file(infile, file_size) != 0)
+        return 1;
+
+    const size_t packet_size = 1024;
+    const uint16_t window = 32;
+    test_duplex_t duplex;
+    test_duplex_init(&duplex, packet_size, 64);
+    // Random loss on the forward (DATA) path only; the return path carries the propagation delay
+    g_data_loss_ppm = (uint32_t)(profile->loss_rate * 1000000.0f);
+
+    uint8_t tx_send_buf[1024], tx_recv_buf[1024];
+    uint8_t rx_send_buf[1024], rx_recv_buf[1024];
+    uint8_t *reorder = (uint8_t *)calloc(window, packet_size);
+    val_config_t tx_cfg, rx_cfg;
+    ts_make_config(&tx_cfg, tx_send_buf, tx_recv_buf, packet_size, &duplex, VAL_RESUME_NEVER, 0);
+    test_duplex_t rx_duplex = {.a2b = duplex.b2a, .b2a = duplex.a2b, .max_packet = duplex.max_packet};
+    ts_make_config(&rx_cfg, rx_send_buf, rx_recv_buf, packet_size, &rx_duplex, VAL_RESUME_NEVER, 0);
+    tx_cfg.retries.data_retries = 8;
+    rx_cfg.retries.data_retries = 8;
+    tx_cfg.retries.ack_retries = 12;
+    tx_cfg.timeouts.max_timeout_ms = 500;
+    rx_cfg.timeouts.max_timeout_ms = 500;
+    tx_cfg.transport.send = profile_rate_send;
+    tx_cfg.transport.recv = propagation_recv;
+    rx_cfg.transport.send = propagation_send;
+    g_link_bits_owed = 0;
+    // Same loss draws for every controller, whatever earlier tests took from the shared generator
+    ts_rand_reset(WIFI_CC_LOSS_SEED);
+    g_prop_written = g_prop_read = 0;
+    g_prop_pushed = g_prop_consumed = 0;
+    g_prop_rtt_ms = 2u * profile->base_latency_ms;
+    tx_cfg.tx_flow.congestion_control = cc;
+    tx_cfg.tx_flow.window_cap_packets = window;
+    rx_cfg.tx_flow.window_cap_packets = window;
+    tx_cfg.features.requested = VAL_FEAT_SACK;
+    rx_cfg.buffers.rx_reorder_buffer = reorder;
+    rx_cfg.buffers.rx_reorder_size = window * packet_size;
+
+    val_session_t *tx = NULL, *rx = NULL;
+    val_session_create(&tx_cfg, &tx, NULL);
+    val_session_create(&rx_cfg, &rx, NULL);
+    int fails = 0;
+    if (!tx || !rx)
+    {
+        fails = 1;
+    }
+    else
+    {
+        ts_thread_t rx_thread = ts_start_receiver(rx, outdir);
+        ts_delay(50);
+        uint32_t start_time = ts_ticks();
+        const char *files[] = {infile};
+        val_status_t err = val_send_files(tx, files, 1, NULL);
+        *out_ms = ts_ticks() - start_time;
+        ts_join_thread(rx_thread);
+        (void)val_get_cwnd_packets(tx, out_cwnd);
+        if (err != VAL_OK || !ts_files_equal(infile, outfile))
+        {
+            printf("FAIL: cc=%u transfer error %d or integrity mismatch\n", (unsigned)cc, err);
+            fails = 1;
+        }
+    }
+    if (tx)
+        val_session_destroy(tx);
+    if (rx)
+        val_session_destroy(rx);
+    free(reorder);
+    test_duplex_free(&duplex);
+    return fails;
+}
+
+static int test_wifi_poor_model_based_cc(void)
+{
+    printf("\n=== Test: WiFi Poor random loss, AIMD vs BBR (64KB, 60ms RTT) ===\n");
+
+    if (transport_sim_init(&PROFILE_WIFI_POOR) != 0)
+    {
+        printf("FAIL: Could not initialize WiFi Poor profile\n");
+        return 1;
+    }
+    ts_net_sim_reset();
+
+    const size_t file_size = 64 * 1024;
+    uint32_t aimd_cwnd = 0, bbr_cwnd = 0, aimd_ms = 1, bbr_ms = 1;
+    int fails = run_poor_with_cc(VAL_CC_AIMD, "wifi_poor_aimd", file_size, &aimd_cwnd, &aimd_ms);
+    fails += run_poor_with_cc(VAL_CC_BBR, "wifi_poor_bbr", file_size, &bbr_cwnd, &bbr_ms);
+    float link_kbs = PROFILE_WIFI_POOR.bandwidth_bps / 8192.0f;
+    float aimd_kbs = (file_size / 1024.0f) / (aimd_ms ? aimd_ms : 1) * 1000.0f;
+    float bbr_kbs = (file_size / 1024.0f) / (bbr_ms ? bbr_ms : 1) * 1000.0f;
+    printf("AIMD: cwnd=%u, %.2f KB/s (%.0f%% of link)\n", (unsigned)aimd_cwnd, aimd_kbs, aimd_kbs * 100.0f / link_kbs);
+    printf("BBR:  cwnd=%u, %.2f KB/s (%.0f%% of link)\n", (unsigned)bbr_cwnd, bbr_kbs, bbr_kbs * 100.0f / link_kbs);
+
+    // Loss here is random, not congestion: AIMD halves towards a few packets while the model-based window
+    // stays near the bandwidth-delay product (~15 packets at this rate and RTT). Over loss seeds 1..20 BBR
+    // finished 1.33-2.1x sooner with 4x+ the window; the check leaves room below that.
+    if (fails == 0 && (bbr_cwnd < 2u * aimd_cwnd || bbr_ms * 6u > aimd_ms * 5u))
+    {
+        printf("FAIL: BBR (cwnd %u, %ums) did not outrun AIMD (cwnd %u, %ums) under random loss\n", (unsigned)bbr_cwnd,
+               (unsigned)bbr_ms, (unsigned)aimd_cwnd, (unsigned)aimd_ms);
+        fails++;
+    }
+    if (fails == 0)
+        printf("PASS: BBR sustained at least 1.2x AIMD's throughput under random loss\n");
+    transport_sim_cleanup();
+    return fails ? 1 : 0;
+}
+
 static int test_wifi_adaptive_behavior(void)
 {
     printf("\n=== Test: WiFi Adaptive Mode Behavior ===\n");
@@ -275,6 +456,7 @@ int main(void)
     
     failures += test_wifi_good_conditions();
     failures += test_wifi_poor_conditions();
+    failures += test_wifi_poor_model_based_cc();
     failures += test_wifi_adaptive_behavior();
     
     printf("\n========================================\n");